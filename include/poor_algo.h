@@ -0,0 +1,190 @@
+// SPDX-License-Identifier: MIT
+/*
+ * Copyright (C) 2020 Alexandrov Stanislav <lightofmysoul@gmail.com>
+ */
+#ifndef POOR_ALGO_H
+#define POOR_ALGO_H
+
+#include <poor_array.h>
+#include <poor_common.h>
+#include <poor_traits.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+/* Generic algorithms over arrays.
+ * All macros here accept arrays or pointers to arrays, and are instantiated inline for array element type.
+ * Macros which return a value are implemented with expression statements, which are not a part of standard C */
+
+/* Loops over arrays with constant size not greater than this are fully unrolled */
+#ifndef POOR_UNROLL_MAX
+#define POOR_UNROLL_MAX 32
+#endif
+
+/* array_reduce(_arrm_, _init_, _op_)
+ * Folds all elements of an array into a single value, from the first element to the last one.
+ * @_arrm_: an array or a pointer to an array
+ * @_init_: initial value of accumulator. type of accumulator and of returned value is type of (_init_)
+ * @_op_: function or function-like macro: op(accumulator, element) which returns new accumulator value
+ *
+ * If array size is a constant expression, then loop is fully unrolled for arrays up to POOR_UNROLL_MAX elements.
+ *
+ * example:
+
+	#define add(acc, val) ((acc) + (val))
+	#define max(acc, val) ((acc) > (val) ? (acc) : (val))
+
+	int a[] = {1, 5, 3};
+	println(array_reduce(a, 0L, add)); //prints: 9
+	println(array_reduce(a, INT_MIN, max)); //prints: 5
+ */
+#define array_reduce(_arrm_, _init_, _op_) __extension__ ({	\
+	const make_arrview_full(_red_arrp_, _arrm_);		\
+	TYPEOF_NO_QUAL(_init_) _red_acc_ = (_init_);		\
+	h_reduce_loop(_red_arrp_, _red_acc_, _op_);		\
+	_red_acc_;						\
+})
+
+/* POOR_BITWISE_TYPES(_x_)
+ * List of struct or union types without padding, which are equal only if all their bytes are equal.
+ * Define it before including this header, to allow array_equal() and array_compare() for arrays of such types:
+
+	#define POOR_BITWISE_TYPES(_x_) _x_(struct rgb) _x_(struct key)
+	#include <poor_algo.h>
+
+ * Integer types are always compared by bytes, so they don't need to be listed */
+#ifndef POOR_BITWISE_TYPES
+#define POOR_BITWISE_TYPES(_x_)
+#endif
+
+/* is_bitwise_comparable(_expr_)
+ * Returns true if values of type of (_expr_) are equal only when all their bytes are equal:
+ * integer types and types listed in POOR_BITWISE_TYPES. Floating point types are not: 0.0 == -0.0, and NaN != NaN
+ */
+#define is_bitwise_comparable(_expr_) _Generic((_expr_),				\
+	_Bool: true, char: true, signed char: true, unsigned char: true,		\
+	short: true, unsigned short: true, int: true, unsigned: true,			\
+	long: true, unsigned long: true, long long: true, unsigned long long: true,	\
+	POOR_BITWISE_TYPES(h_bitwise_assoc_true)					\
+	default: false)
+
+/* array_equal(_arrm_a_, _arrm_b_)
+ * Returns true if two arrays have same size and all their elements are equal
+ * @_arrm_a_, @_arrm_b_: arrays or pointers to arrays
+ *
+ * Arrays with different sizes are not equal, when both sizes are constant expressions this is decided at compile time.
+ * If arrays have same types of elements, and elements are is_bitwise_comparable(), arrays are compared by memcmp().
+ * Otherwise elements are compared one by one with operator ==, so arrays may have different element types.
+ * Arrays of types from POOR_BITWISE_TYPES may be compared only with arrays of the same type, otherwise compilation fails.
+ *
+ * example:
+
+	const uint32_t prev[] = {1, 2, 3};
+	uint32_t cur[] = {1, 2, 3};
+	println(array_equal(prev, cur)); //prints: 1
+
+	const double d[] = {1.0, 2.0, 3.0};
+	println(array_equal(cur, d)); //prints: 1
+ */
+#define array_equal(_arrm_a_, ...) __extension__ ({						\
+	const make_arrview_full(_eq_a_, _arrm_a_);							\
+	const make_arrview_full(_eq_b_, __VA_ARGS__);							\
+	h_bitwise_chk_same(_eq_a_, _eq_b_, "array_equal()");						\
+	bool _eq_res_ = UNSAFE_ARRAY_SIZE(*_eq_a_) == UNSAFE_ARRAY_SIZE(*_eq_b_);			\
+	if(_eq_res_) {											\
+		if(unsafe_is_ptas_of_same_types(_eq_a_, _eq_b_) && is_bitwise_comparable((*_eq_a_)[0]))	\
+			_eq_res_ = !memcmp(_eq_a_, _eq_b_, (h_copy_min(sizeof(*_eq_a_), sizeof(*_eq_b_))));	\
+		else											\
+			for(size_t _eq_i_ = 0; _eq_res_ && _eq_i_ < UNSAFE_ARRAY_SIZE(*_eq_a_); _eq_i_++)	\
+				_eq_res_ = h_elem_value((*_eq_a_)[_eq_i_]) == h_elem_value((*_eq_b_)[_eq_i_]);	\
+	}												\
+	_eq_res_;											\
+})
+
+/* array_compare(_arrm_a_, _arrm_b_)
+ * Compares two arrays lexicographically, returns -1, 0 or 1, like memcmp() or strcmp() does
+ * @_arrm_a_, @_arrm_b_: arrays or pointers to arrays
+ *
+ * Arrays are compared up to the first pair of different elements, which are compared with operator <.
+ * If one array is a prefix of another one, the shorter array is less.
+ * If arrays have same types of elements and elements are is_bitwise_comparable(), the first
+ * different element is located by memcmp() of memory blocks. Elements of types from POOR_BITWISE_TYPES
+ * are ordered by memcmp() of their bytes, and may be compared only with elements of the same type.
+ *
+ * example:
+
+	const int a[] = {1, 2, 3}, b[] = {1, 3}, c[] = {1, 2};
+	println(array_compare(a, b)); //prints: -1
+	println(array_compare(a, c)); //prints: 1
+ */
+#define array_compare(_arrm_a_, ...) __extension__ ({						\
+	const make_arrview_full(_cmp_a_, _arrm_a_);							\
+	const make_arrview_full(_cmp_b_, __VA_ARGS__);							\
+	h_bitwise_chk_same(_cmp_a_, _cmp_b_, "array_compare()");					\
+	const size_t _cmp_n_ = h_copy_min(UNSAFE_ARRAY_SIZE(*_cmp_a_), UNSAFE_ARRAY_SIZE(*_cmp_b_));	\
+	size_t _cmp_i_ = 0;										\
+	if(unsafe_is_ptas_of_same_types(_cmp_a_, _cmp_b_) && is_bitwise_comparable((*_cmp_a_)[0]))	\
+		_cmp_i_ = h_mismatch_fn(_cmp_a_, _cmp_b_, _cmp_n_ * sizeof((*_cmp_a_)[0])) / sizeof((*_cmp_a_)[0]);	\
+	else												\
+		while(_cmp_i_ < _cmp_n_ && h_elem_value((*_cmp_a_)[_cmp_i_]) == h_elem_value((*_cmp_b_)[_cmp_i_]))	\
+			_cmp_i_++;									\
+	_cmp_i_ < _cmp_n_ ? h_elem_compare((*_cmp_a_)[_cmp_i_], (*_cmp_b_)[_cmp_i_]) :		\
+		(UNSAFE_ARRAY_SIZE(*_cmp_a_) > _cmp_n_) - (UNSAFE_ARRAY_SIZE(*_cmp_b_) > _cmp_n_);	\
+})
+
+/****** Implementation ******/
+
+#if defined __GNUC__ || defined __clang__
+#define POOR_UNROLL h_pragma(GCC unroll POOR_UNROLL_MAX)
+#else
+#define POOR_UNROLL
+#endif
+
+/* Reduces all elements of array pointed by _arrp_ into _acc_ variable.
+ * Loop over constant size arrays is unrolled, otherwise loop is left for the compiler */
+#define h_reduce_loop(_arrp_, _acc_, _op_) do {						\
+	if(is_const_expr(UNSAFE_ARRAY_SIZE(*(_arrp_)))) {					\
+		POOR_UNROLL									\
+		for(size_t _red_i_ = 0; _red_i_ < UNSAFE_ARRAY_SIZE(*(_arrp_)); _red_i_++)	\
+			_acc_ = _op_(_acc_, (*(_arrp_))[_red_i_]);				\
+	} else {										\
+		unsafe_foreach_array_const_ref(_arrp_, _red_ref_)				\
+			_acc_ = _op_(_acc_, *_red_ref_);					\
+	}											\
+} while(0)
+
+/* Helpers for types from POOR_BITWISE_TYPES */
+#define h_bitwise_assoc_true(_type_) _type_: true,
+#define h_bitwise_assoc_zero(_type_) _type_: 0,
+#define h_is_user_bitwise(_expr_) _Generic((_expr_), POOR_BITWISE_TYPES(h_bitwise_assoc_true) default: false)
+
+/* Arrays of types from POOR_BITWISE_TYPES are compared only by memcmp(), which needs both arrays to have the same type */
+#define h_bitwise_chk_same(_arrp_a_, _arrp_b_, _macro_name_) static_assert_expr(			\
+	(!h_is_user_bitwise((*(_arrp_a_))[0]) && !h_is_user_bitwise((*(_arrp_b_))[0]))		\
+	|| unsafe_is_ptas_of_same_types(_arrp_a_, _arrp_b_),					\
+	_macro_name_ ": arrays of types from POOR_BITWISE_TYPES should have same element types")
+
+/* Value of an element, which can be used with operators == and <. Elements of types from POOR_BITWISE_TYPES
+ * are replaced with 0, so expressions with them compile. This code is never reached for them:
+ * h_bitwise_chk_same() guarantees same types, so they are compared by memcmp() instead */
+#define h_elem_value(_el_) _Generic((_el_), POOR_BITWISE_TYPES(h_bitwise_assoc_zero) default: (_el_))
+
+/* Returns -1, 0 or 1 */
+#define h_elem_compare(_x_, _y_) (h_is_user_bitwise(_x_) ?					\
+	(memcmp(&(_x_), &(_y_), sizeof(_x_)) > 0) - (memcmp(&(_x_), &(_y_), sizeof(_x_)) < 0) :	\
+	(h_elem_value(_x_) > h_elem_value(_y_)) - (h_elem_value(_x_) < h_elem_value(_y_)))
+
+/* Returns offset of the first different byte of two memory blocks, or (bytes) if they are equal.
+ * Blocks are compared by memcmp() in chunks, and only the different chunk is scanned byte by byte */
+static inline size_t h_mismatch_fn(const void *a, const void *b, size_t bytes) {
+	const unsigned char *const x = a, *const y = b;
+	size_t off = 0;
+	for(; off + 256 <= bytes; off += 256)
+		if(memcmp(&x[off], &y[off], 256))
+			break;
+	while(off < bytes && x[off] == y[off])
+		off++;
+	return off;
+}
+
+#endif // POOR_ALGO_H
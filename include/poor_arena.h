@@ -0,0 +1,211 @@
+// SPDX-License-Identifier: MIT
+/*
+ * Copyright (C) 2020 Alexandrov Stanislav <lightofmysoul@gmail.com>
+ */
+#ifndef POOR_ARENA_H
+#define POOR_ARENA_H
+
+#include <poor_array.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Bump pointer arena allocator.
+ * An arena owns a list of memory chunks, allocation takes next bytes of the current chunk,
+ * and when it is exhausted, a new chunk is allocated with malloc(). Single allocations are never freed,
+ * instead the whole arena is released at once, or rewound to a previously taken mark.
+ *
+ * A zero-initialized poor_arena is an empty arena, it doesn't allocate memory until the first allocation:
+
+	poor_arena arena = {0};
+	double (*samples)[n] = arena_alloc_array(&arena, samples);
+	uint8_t (*flags)[n] = arena_calloc_array(&arena, flags);
+	...
+	arena_free(&arena); //releases both arrays
+
+ * Arena is not thread safe, use one arena per thread, see make_thread_arena(). */
+
+/* Size of the first chunk of an arena. Each next chunk is twice larger, up to POOR_ARENA_MAX_CHUNK */
+#ifndef POOR_ARENA_CHUNK_SIZE
+#define POOR_ARENA_CHUNK_SIZE (64 * 1024)
+#endif
+
+#ifndef POOR_ARENA_MAX_CHUNK
+#define POOR_ARENA_MAX_CHUNK (16 * 1024 * 1024)
+#endif
+
+struct h_arena_chunk;
+
+typedef struct poor_arena {
+	struct h_arena_chunk *chunk;	/* current chunk, chunks are linked from the newest to the oldest */
+	unsigned char *ptr;		/* first free byte of the current chunk */
+	unsigned char *end;		/* end of the current chunk */
+	size_t next_size;		/* size of the next chunk */
+} poor_arena;
+
+/* Checkpoint of an arena, taken by arena_mark() */
+typedef struct poor_arena_mark {
+	struct h_arena_chunk *chunk;
+	unsigned char *ptr;
+} poor_arena_mark;
+
+/* arena_alloc(arena, size, align)
+ * Allocates (size) bytes aligned to (align), which should be a power of two.
+ * Returns NULL if memory allocation failed.
+ * Allocation from the current chunk is a pointer bump, and is inlined into the caller.
+ */
+static inline void *arena_alloc(poor_arena *arena, size_t size, size_t align);
+
+/* arena_alloc_array(arena, arrp), arena_calloc_array(arena, arrp)
+ * Same as malloc_array() and calloc_array(), but memory is allocated from an arena.
+ * Memory is aligned for type of array elements. Pointer can be pointer to VLA.
+ * Returns newly allocated pointer, or NULL on failure. Don't pass these pointers to free().
+ * example:
+
+	poor_arena arena = {0};
+	int (*ids)[count] = arena_alloc_array(&arena, ids);
+	if(!ids)
+		return false;
+ */
+#define arena_alloc_array(_arena_, _arrp_) \
+	(( _arrp_ = arena_alloc(_arena_, ARRAY_SIZE_BYTES(_arrp_), __alignof__(*(_arrp_))) ))
+
+#define arena_calloc_array(_arena_, _arrp_) \
+	(( _arrp_ = h_arena_zero(arena_alloc(_arena_, ARRAY_SIZE_BYTES(_arrp_), __alignof__(*(_arrp_))), ARRAY_SIZE_BYTES(_arrp_)) ))
+
+/* arena_alloc_array_aligned(arena, arrp, align)
+ * Same as arena_alloc_array(), but memory is aligned to (align) bytes, i.e. to a cache line for SIMD loads.
+ * (align) should be a power of two.
+ */
+#define arena_alloc_array_aligned(_arena_, _arrp_, _align_) \
+	(( _arrp_ = arena_alloc(_arena_, ARRAY_SIZE_BYTES(_arrp_), (_align_) > __alignof__(*(_arrp_)) ? (_align_) : __alignof__(*(_arrp_))) ))
+
+/* arena_mark(arena), arena_rewind(arena, mark)
+ * arena_mark() returns a checkpoint of an arena, arena_rewind() releases everything allocated after this checkpoint.
+ * Chunks allocated after the checkpoint are freed. Marks taken after (mark) become invalid after rewind.
+ * example:
+
+	poor_arena_mark mark = arena_mark(&arena);
+	char (*tmp)[len] = arena_alloc_array(&arena, tmp);
+	...
+	arena_rewind(&arena, mark); //tmp is released
+ */
+static inline poor_arena_mark arena_mark(const poor_arena *arena);
+static inline void arena_rewind(poor_arena *arena, poor_arena_mark mark);
+
+/* arena_reset(arena)
+ * Releases all allocations, but keeps the newest chunk for the next allocations.
+ * After a few cycles arena keeps a single chunk large enough for a whole cycle,
+ * so resetting it costs O(1) and allocations in the next cycle don't call malloc().
+ * All existing marks become invalid, don't pass them to arena_rewind().
+ */
+static inline void arena_reset(poor_arena *arena);
+
+/* arena_free(arena)
+ * Releases all memory of an arena, arena becomes empty and may be used again.
+ */
+static inline void arena_free(poor_arena *arena);
+
+/* make_thread_arena(name)
+ * Declares an arena with thread storage duration, each thread gets it's own empty arena with name (name).
+ * Should be used at file scope or in a function body. C has no destructors for thread local objects,
+ * so call arena_free() before a thread exits to avoid memory leaks.
+ * example:
+
+	make_thread_arena(request_arena);
+
+	void handle_request(const struct request *req) {
+		int (*fields)[req->count] = arena_alloc_array(&request_arena, fields);
+		...
+		arena_reset(&request_arena);
+	}
+ */
+#define make_thread_arena(_name_) static _Thread_local poor_arena _name_
+
+/****** Implementation ******/
+
+struct h_arena_chunk {
+	struct h_arena_chunk *prev;
+	unsigned char *end;
+	_Alignas(max_align_t) unsigned char data[];
+};
+
+static inline void *h_arena_zero(void *p, size_t size) {
+	return p ? memset(p, 0, size) : p;
+}
+
+/* Allocates a new chunk which can hold (size) bytes aligned to (align), and allocates them from it */
+static inline void *h_arena_alloc_slow(poor_arena *arena, size_t size, size_t align) {
+	if(!arena->next_size)
+		arena->next_size = POOR_ARENA_CHUNK_SIZE;
+
+	const size_t header = offsetof(struct h_arena_chunk, data);
+	const size_t pad = align > _Alignof(max_align_t) ? align - 1 : 0;
+	if(size > SIZE_MAX - header - pad)
+		return NULL;
+
+	size_t chunk_size = arena->next_size;
+	if(chunk_size - header < size + pad)
+		chunk_size = header + size + pad;
+
+	struct h_arena_chunk *const chunk = malloc(chunk_size);
+	if(!chunk)
+		return NULL;
+
+	chunk->prev = arena->chunk;
+	chunk->end = (unsigned char*)chunk + chunk_size;
+	arena->chunk = chunk;
+	arena->ptr = chunk->data;
+	arena->end = chunk->end;
+	if(arena->next_size < POOR_ARENA_MAX_CHUNK)
+		arena->next_size *= 2;
+
+	return arena_alloc(arena, size, align);
+}
+
+static inline void *arena_alloc(poor_arena *arena, size_t size, size_t align) {
+	const uintptr_t end = (uintptr_t)arena->end;
+	const uintptr_t p = ((uintptr_t)arena->ptr + align - 1) & ~(uintptr_t)(align - 1);
+	if(arena->ptr && p <= end && size <= end - p) {
+		arena->ptr = (unsigned char*)p + size;
+		return (void*)p;
+	}
+	return h_arena_alloc_slow(arena, size, align);
+}
+
+static inline poor_arena_mark arena_mark(const poor_arena *arena) {
+	return (poor_arena_mark){arena->chunk, arena->ptr};
+}
+
+static inline void arena_rewind(poor_arena *arena, poor_arena_mark mark) {
+	while(arena->chunk && arena->chunk != mark.chunk) {
+		struct h_arena_chunk *const prev = arena->chunk->prev;
+		free(arena->chunk);
+		arena->chunk = prev;
+	}
+	/* Chunk of an invalid mark was already freed, arena is left empty */
+	arena->ptr = arena->chunk ? mark.ptr : NULL;
+	arena->end = arena->chunk ? arena->chunk->end : NULL;
+}
+
+static inline void arena_reset(poor_arena *arena) {
+	if(!arena->chunk)
+		return;
+
+	struct h_arena_chunk *const keep = arena->chunk;
+	for(struct h_arena_chunk *c = keep->prev, *prev; c; c = prev) {
+		prev = c->prev;
+		free(c);
+	}
+	keep->prev = NULL;
+	arena->ptr = keep->data;
+}
+
+static inline void arena_free(poor_arena *arena) {
+	arena_rewind(arena, (poor_arena_mark){NULL, NULL});
+	arena->next_size = 0;
+}
+
+#endif // POOR_ARENA_H
@@ -8,6 +8,8 @@
 #include <poor_map.h>
 #include <poor_stdio.h>
 #include <poor_traits.h>
+#include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 
 /* Some colors */
@@ -231,6 +233,43 @@
 /* Same as malloc_array, but with calloc */
 #define calloc_array(_arrp_) (( _arrp_ = calloc( 1, ARRAY_SIZE_BYTES(_arrp_) ) ))
 
+/* Size of a cache line */
+#ifndef POOR_CACHE_LINE
+#define POOR_CACHE_LINE 64
+#endif
+
+/* malloc_array_aligned(arrp, align)
+ * Same as malloc_array(), but memory is aligned to (align) bytes, which should be a power of two.
+ * Alignment is never less than alignment of array elements. Release memory with free().
+ * Returns NULL if (align) is not a power of two.
+ * example:
+
+	float (*samples)[n] = malloc_array_aligned(samples, 32); //aligned for 256-bit loads
+	if(samples) {
+		...
+		free(samples);
+	}
+ */
+#define malloc_array_aligned(_arrp_, _align_) \
+	(( _arrp_ = h_malloc_aligned(ARRAY_SIZE_BYTES(_arrp_), (_align_), __alignof__(*(_arrp_))) ))
+
+/* malloc_array_cacheline(arrp)
+ * Same as malloc_array(), but memory is aligned to a cache line (POOR_CACHE_LINE),
+ * so the array doesn't share cache lines with other data. Release memory with free().
+ */
+#define malloc_array_cacheline(_arrp_) malloc_array_aligned(_arrp_, POOR_CACHE_LINE)
+
+/* aligned_alloc() requires size to be a multiple of alignment */
+static inline void *h_malloc_aligned(size_t size, size_t align, size_t min_align) {
+	if(!align || (align & (align - 1)))
+		return NULL;
+	if(align < min_align)
+		align = min_align;
+	if(size > SIZE_MAX - align + 1)
+		return NULL;
+	return aligned_alloc(align, (size + align - 1) & ~(align - 1));
+}
+
 /* memset_array(_arrm_, _symbol_)
  * Fills array with specified byte by using memset
  * @_arrm_: an array or a pointer to an array
@@ -582,6 +621,114 @@
 #define make_arrview_str(_name_, ...) make_arrview_cback(_name_, 1, __VA_ARGS__)
 #define arrview_str(...) arrview_cback(1, __VA_ARGS__)
 
+/*** Strided array views ***/
+
+/* arrview_stride_t(type)
+ * Type of a strided view: every (stride)-th element of an array, (count) elements starting at (ptr).
+ * Unlike other arrviews, strided view is not a pointer to array, so it has it's own set of macros:
+ * foreach_stride_ref(), copy_stride(), fill_stride() and print_stride().
+ * Each arrview_stride_t() is a distinct anonymous struct type, so use typedef to pass strided views to functions:
+
+	typedef arrview_stride_t(float) float_stride;
+	static float sum_stride(float_stride v) {
+		float sum = 0;
+		foreach_stride_const_ref(v, ref)
+			sum += *ref;
+		return sum;
+	}
+	...
+	make_arrview_column(col, 1, matrix);
+	sum_stride((float_stride){col.ptr, col.count, col.stride});
+ */
+#define arrview_stride_t(_type_) struct { _type_ *ptr; size_t count; size_t stride; }
+
+/* make_arrview_stride(name, start, count, stride, src)
+ * Declares a strided view over array src: elements start, start + stride, ..., start + (count - 1) * stride.
+ * All elements should be inside of the source array, count and stride should be greater than 0.
+ * example:
+
+	int data[] = {0,1,2,3,4,5,6,7,8,9};
+	make_arrview_stride(even, 0, 5, 2, data);
+	print_stride(even); //prints: [0,2,4,6,8]
+
+	fill_stride(arrview_stride(1, 5, 2, data), -1);
+	print_array(data); //prints: [0,-1,2,-1,4,-1,6,-1,8,-1]
+ */
+#define make_arrview_stride(_name_, _start_, _count_, _stride_, ...) \
+	h_make_arrview_stride(_name_, (_start_), (_count_), (_stride_), &auto_arr(__VA_ARGS__))
+#define arrview_stride(_start_, _count_, _stride_, ...) \
+	h_arrview_stride((_start_), (_count_), (_stride_), &auto_arr(__VA_ARGS__))
+
+/* make_arrview_stride_full(name, src)
+ * Declares a strided view with stride 1 over the whole array src, i.e. to copy between arrays and strided views.
+ */
+#define make_arrview_stride_full(_name_, ...) make_arrview_stride(_name_, 0, ARRAY_SIZE(__VA_ARGS__), 1, __VA_ARGS__)
+#define arrview_stride_full(...) arrview_stride(0, ARRAY_SIZE(__VA_ARGS__), 1, __VA_ARGS__)
+
+/* make_arrview_column(name, column, src)
+ * Declares a strided view over a column of two-dimensional array src, without copying it.
+ * example:
+
+	int data[] = {1,2,3,4,5,6};
+	make_arrview_dim(matrix, 3, data); //[[1,2,3],[4,5,6]]
+
+	make_arrview_column(col, 1, matrix);
+	print_stride(col); //prints: [2,5]
+
+	int col_copy[2];
+	copy_stride(arrview_stride_full(col_copy), col);
+ */
+#define make_arrview_column(_name_, _column_, ...) \
+	make_arrview_stride(_name_, _column_, ARRAY_SIZE(__VA_ARGS__), ARRAY_SIZE(auto_arr(__VA_ARGS__)[0]), arrview_flat(__VA_ARGS__))
+#define arrview_column(_column_, ...) \
+	arrview_stride(_column_, ARRAY_SIZE(__VA_ARGS__), ARRAY_SIZE(auto_arr(__VA_ARGS__)[0]), arrview_flat(__VA_ARGS__))
+
+/* foreach_stride_ref(view, ref)
+ * Iterate over a strided view. Same as foreach_array_ref(), but for views created with make_arrview_stride().
+ */
+#define foreach_stride_ref(_view_, _ref_ptr_name_) h_foreach_stride_ref_base(, (_view_), _ref_ptr_name_)
+
+/* same as foreach_stride_ref(), but _ref_ptr_name_ is always const */
+#define foreach_stride_const_ref(_view_, _ref_ptr_name_) h_foreach_stride_ref_base(const, (_view_), _ref_ptr_name_)
+
+/* Returns index of the element in a strided view from a reference */
+#define stride_ref_index(_view_, _ref_) ((size_t)((_ref_) - (_view_).ptr) / (_view_).stride)
+
+/* fill_stride(view, val)
+ * Same as fill_array(), but for a strided view
+ */
+#define fill_stride(_view_, ...) \
+	foreach_stride_ref(_view_, _ref_) \
+		*(_ref_) = (__VA_ARGS__)
+
+/* copy_stride(dst, src)
+ * Same as copy_array(), but copies between strided views. Use arrview_stride_full() for arrays.
+ * Copies min(dst.count, src.count) elements. Views should not overlap.
+ */
+#define copy_stride(_dst_, ...) do {							\
+	typeof(*(_dst_).ptr) *const _tmp_cs_dst_ = (_dst_).ptr;				\
+	const typeof(*(__VA_ARGS__).ptr) *const _tmp_cs_src_ = (__VA_ARGS__).ptr;	\
+	const size_t _tmp_cs_dst_stride_ = (_dst_).stride;				\
+	const size_t _tmp_cs_src_stride_ = (__VA_ARGS__).stride;			\
+	const size_t _tmp_cs_cnt_ = (_dst_).count < (__VA_ARGS__).count ?		\
+				    (_dst_).count : (__VA_ARGS__).count;		\
+	for(size_t _tmp_cs_i_ = 0; _tmp_cs_i_ < _tmp_cs_cnt_; _tmp_cs_i_++)		\
+		_tmp_cs_dst_[_tmp_cs_i_ * _tmp_cs_dst_stride_] =			\
+			_tmp_cs_src_[_tmp_cs_i_ * _tmp_cs_src_stride_];			\
+} while(0)
+
+/* print_stride(view)
+ * Same as print_array(), but for a strided view
+ */
+#define print_stride(...) do {						\
+	char _tmp_sep_ = '[';						\
+	foreach_stride_const_ref((__VA_ARGS__), _ref_) {		\
+		print(_tmp_sep_, *_ref_);				\
+		_tmp_sep_ = ',';					\
+	}								\
+	println("]");							\
+} while (0)
+
 /* string_literal(_name_, string_literal)
  * @_name_: variable name for new array pointer
  * @string_literal: string literal, e.g "Some String"
@@ -662,6 +809,76 @@
 	ARRAY_ELEMENT_TYPE_NO_QUAL(TAKE_FIRST_ARG(__VA_ARGS__)) _name_ [ ARRAYS_SIZE(__VA_ARGS__) ]; \
 	copy_arrays(_name_, __VA_ARGS__)
 
+/* make_sbo_array(name, type, inline_cap, len)
+ * Declares a pointer to array (name) of type: type (*)[len], with small buffer optimization:
+ * if (len) is not greater than (inline_cap), then array is placed into a buffer on the stack,
+ * otherwise memory for the array is allocated with malloc().
+ * @inline_cap: size of the buffer on the stack, should be a constant expression
+ * @len: size of the array, may be not a constant expression
+ *
+ * Unlike VLAs, large sizes don't overflow the stack, and unlike malloc_array(), small sizes don't pay for malloc().
+ * Memory is released automatically when (name) goes out of scope, with GNU cleanup attribute.
+ * Use free_sbo_array() to release memory earlier.
+ *
+ * If memory allocation fails, (name) is NULL, so check it before use when (len) may be large.
+ * example:
+
+	void process(const int (*input)[], size_t n) {
+		make_sbo_array(tmp, int, 64, n);
+		if(!tmp)
+			return;
+		fill_array(tmp, 0);
+		...
+	} //tmp is released here if it was allocated
+
+ */
+#define make_sbo_array(_name_, _type_, _inline_cap_, _len_)						\
+	_Static_assert(is_const_expr(_inline_cap_), "make_sbo_array(): inline_cap should be a constant expression"); \
+	_type_ _name_ ## _sbo_buf_[_inline_cap_];							\
+	const size_t _name_ ## _sbo_len_ = (_len_);							\
+	void *_name_ ## _sbo_heap_ __attribute__((cleanup(h_sbo_free))) =				\
+		_name_ ## _sbo_len_ > (_inline_cap_) ? h_sbo_malloc(_name_ ## _sbo_len_, sizeof(_type_)) : NULL; \
+	_type_ (*_name_)[_name_ ## _sbo_len_] =								\
+		_name_ ## _sbo_len_ > (_inline_cap_) ? _name_ ## _sbo_heap_ : (void*)_name_ ## _sbo_buf_
+
+/* make_merged_sbo_array(name, inline_cap, arrm_src, ...)
+ * Same as make_merged_array(), but the merged array is created with make_sbo_array().
+ * If memory allocation fails, (name) is NULL and nothing is copied.
+ * example:
+
+	make_merged_sbo_array(line, 256, prefix, text, suffix);
+	if(line)
+		fwrite(line, 1, sizeof(*line), out);
+ */
+#define make_merged_sbo_array(_name_, _inline_cap_, ...)							\
+	make_sbo_array(_name_, ARRAY_ELEMENT_TYPE_NO_QUAL(TAKE_FIRST_ARG(__VA_ARGS__)), _inline_cap_, ARRAYS_SIZE(__VA_ARGS__)); \
+	if(_name_)												\
+		copy_arrays(_name_, __VA_ARGS__)
+
+/* free_sbo_array(name)
+ * Releases memory of array declared with make_sbo_array(), if it was allocated. (name) becomes NULL.
+ * Calling it is optional, memory is released at the end of scope anyway.
+ */
+#define free_sbo_array(_name_) do {				\
+	free(_name_ ## _sbo_heap_);				\
+	_name_ ## _sbo_heap_ = NULL;				\
+	_name_ = NULL;						\
+} while(0)
+
+/* is_sbo_array_inline(name)
+ * Returns true if array declared with make_sbo_array() is placed into the buffer on the stack
+ */
+#define is_sbo_array_inline(_name_) ((void*)(_name_) == (void*)_name_ ## _sbo_buf_)
+
+static inline void *h_sbo_malloc(size_t len, size_t el_size) {
+	return len > SIZE_MAX / el_size ? NULL : malloc(len * el_size);
+}
+
+/* Cleanup function, receives a pointer to a variable with heap pointer */
+static inline void h_sbo_free(void *heap_ptr) {
+	free(*(void**)heap_ptr);
+}
+
 /* make_arrview_ref_ref(name, ref1, ref2):
  *
  * Create arrview from two pointers to some elements of the same array
@@ -1316,6 +1533,54 @@ for(unsigned byte_index = 0; byte_index < P_ARRAY_SIZE(_array_); byte_index++) \
 #define h_av_flat_decl(_name_, _arrp_) \
 	UNSAFE_ARRAY_ELEMENT_TYPE((*_arrp_)[0])(*_name_) [UNSAFE_ARRAY_SIZE(*_arrp_) * UNSAFE_ARRAY_SIZE((*_arrp_)[0])]
 
+/* arrview_stride() implementation */
+#define h_make_arrview_stride(_name_, _start_, _count_, _stride_, _arrp_)				\
+	arrview_stride_t(UNSAFE_ARRAY_ELEMENT_TYPE(*_arrp_)) _name_ =					\
+		h_av_stride_init(_start_, _count_, _stride_, _arrp_, "make_arrview_stride()")
+
+#define h_arrview_stride(_start_, _count_, _stride_, _arrp_)						\
+	((arrview_stride_t(UNSAFE_ARRAY_ELEMENT_TYPE(*_arrp_)))						\
+		h_av_stride_init(_start_, _count_, _stride_, _arrp_, "arrview_stride()"))
+
+#define h_av_stride_init(_start_, _count_, _stride_, _arrp_, _macro_name_)				\
+	{ *_arrp_ + _start_ + h_av_stride_chk_sel(_start_, _count_, _stride_, _arrp_, _macro_name_), _count_, _stride_ }
+
+/* Last element of the view is inside of the array, written without overflow */
+#define h_av_stride_fits(_start_, _count_, _stride_, _arrp_)							\
+	((_count_) > 0 && (size_t)(_start_) < UNSAFE_ARRAY_SIZE(*_arrp_) &&					\
+	 (size_t)(_count_) - 1 <= (UNSAFE_ARRAY_SIZE(*_arrp_) - 1 - (size_t)(_start_)) / ((_stride_) ? (size_t)(_stride_) : 1))
+
+#define h_av_stride_chk_sel(_start_, _count_, _stride_, _arrp_, _macro_name_) \
+	POOR_ARR_CHK_SEL(h_av_stride_chk_none, h_av_stride_chk_static, h_av_stride_chk_dyn)(_start_, _count_, _stride_, _arrp_, _macro_name_)
+
+#define h_av_stride_chk_none(...) 0
+#define h_av_stride_chk_static(_start_, _count_, _stride_, _arrp_, _macro_name_) _Generic(1,	\
+	int*:   ARR_ASSERT((_count_) > 0),								\
+	int**:  ARR_ASSERT((_stride_) > 0),								\
+	int***: ARR_ASSERT(h_av_stride_fits(_start_, _count_, _stride_, _arrp_)),			\
+	default: 0 )
+
+#define h_av_stride_chk_dyn(_start_, _count_, _stride_, _arrp_, _macro_name_) ((				\
+	ARR_ASSERT_MSG((_count_) > 0 && (_stride_) > 0,								\
+		CRED _macro_name_ ": Count and stride should be greater than 0"					\
+		" (count:", _count_, " stride:", _stride_, ")"							\
+		" at " FILE_AND_LINE CRESET),									\
+	ARR_ASSERT_MSG(h_av_stride_fits(_start_, _count_, _stride_, _arrp_),					\
+		CRED _macro_name_ ": Strided view is out of source array bounds"				\
+		" (start:", _start_, " count:", _count_, " stride:", _stride_,					\
+		" source array size:", UNSAFE_ARRAY_SIZE(*_arrp_), ")"						\
+		" at " FILE_AND_LINE CRESET)									\
+    ), 0)
+
+/* foreach_stride_ref() implementation.
+ * Reference is not advanced past the last element, so it never points outside of the array */
+#define h_foreach_stride_ref_base(prefix, _view_, _ref_ptr_name_)					\
+	for(size_t _tmp_sv_left_ = _view_.count, _tmp_sv_stride_ = _view_.stride, _tmp_sv_once_ = 1;	\
+	    _tmp_sv_once_; _tmp_sv_once_ = 0)								\
+		for(prefix typeof(*_view_.ptr) *_ref_ptr_name_ = _tmp_sv_left_ ? _view_.ptr : NULL;	\
+		    _ref_ptr_name_;									\
+		    _ref_ptr_name_ = --_tmp_sv_left_ ? _ref_ptr_name_ + _tmp_sv_stride_ : NULL)
+
 /* declare_string_literal(name, string_literal)
  *
  * Only declares constant pointer to array of constant chars
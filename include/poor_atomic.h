@@ -0,0 +1,264 @@
+// SPDX-License-Identifier: MIT
+/*
+ * Copyright (C) 2020 Alexandrov Stanislav <lightofmysoul@gmail.com>
+ */
+#ifndef POOR_ATOMIC_H
+#define POOR_ATOMIC_H
+
+#include <poor_array.h>
+#include <poor_common.h>
+#include <poor_bits.h>
+#include <poor_traits.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Atomic operations on elements and bits of plain arrays.
+ * array_set_bit() and array_unset_bit() use plain |= and &=, so two threads updating bits of the same element
+ * is a data race. Macros here perform same updates with C11 atomic read-modify-write operations instead.
+ *
+ * Arrays don't need to be declared with _Atomic, elements are accessed through _Atomic pointers.
+ * Every macro has an _explicit variant with a memory_order argument, like C11 atomic functions have.
+ * Macros without _explicit use memory_order_seq_cst, as C11 atomic functions do.
+ * Use memory_order_relaxed when only the bits themselves are shared, i.e. a visited bitmap which is read
+ * after the threads are joined, and memory_order_acq_rel when setting a bit publishes other data.
+ *
+ * Bits are numbered in the same way as array_set_bit() does. Elements of bitsets should be unsigned integers */
+
+/* array_atomic_set_bit(_arrm_, _idx_), array_atomic_set_bit_explicit(_arrm_, _idx_, _order_)
+ * Atomically sets bit with index _idx_.
+ */
+#define array_atomic_set_bit(_arrm_, _idx_) array_atomic_set_bit_explicit(_arrm_, _idx_, memory_order_seq_cst)
+#define array_atomic_set_bit_explicit(_arrm_, _idx_, _order_) \
+	(void)h_atomic_bit("array_atomic_set_bit()", _arrm_, _idx_, _order_, h_atomic_bit_set)
+
+/* array_atomic_unset_bit(_arrm_, _idx_), array_atomic_unset_bit_explicit(_arrm_, _idx_, _order_)
+ * Atomically clears bit with index _idx_.
+ */
+#define array_atomic_unset_bit(_arrm_, _idx_) array_atomic_unset_bit_explicit(_arrm_, _idx_, memory_order_seq_cst)
+#define array_atomic_unset_bit_explicit(_arrm_, _idx_, _order_) \
+	(void)h_atomic_bit("array_atomic_unset_bit()", _arrm_, _idx_, _order_, h_atomic_bit_unset)
+
+/* array_atomic_get_bit(_arrm_, _idx_), array_atomic_get_bit_explicit(_arrm_, _idx_, _order_)
+ * Atomically loads bit with index _idx_, returns bool.
+ */
+#define array_atomic_get_bit(_arrm_, _idx_) array_atomic_get_bit_explicit(_arrm_, _idx_, memory_order_seq_cst)
+#define array_atomic_get_bit_explicit(_arrm_, _idx_, _order_) \
+	h_atomic_bit("array_atomic_get_bit()", _arrm_, _idx_, _order_, h_atomic_bit_get)
+
+/* array_atomic_test_and_set_bit(_arrm_, _idx_), array_atomic_test_and_set_bit_explicit(_arrm_, _idx_, _order_)
+ * Atomically sets bit with index _idx_ and returns it's previous value.
+ * Exactly one of threads, which set same bit concurrently, gets false.
+ *
+ * The bit is loaded before the read-modify-write, and if it is already set, the element is not written to.
+ * So threads, which test bits already set by other threads, don't take cache lines of the bitset into exclusive state.
+ *
+ * example:
+
+	uint64_t (*visited)[(nodes + 63) / 64] = calloc_array(visited);
+
+	#pragma omp parallel for
+	for(size_t i = 0; i < ARRAY_SIZE(frontier); i++)
+		foreach_array_const_ref(neighbors[(*frontier)[i]], next)
+			if(!array_atomic_test_and_set_bit_explicit(visited, *next, memory_order_relaxed))
+				push_next_frontier(*next);
+ */
+#define array_atomic_test_and_set_bit(_arrm_, _idx_) \
+	array_atomic_test_and_set_bit_explicit(_arrm_, _idx_, memory_order_seq_cst)
+#define array_atomic_test_and_set_bit_explicit(_arrm_, _idx_, _order_) \
+	h_atomic_bit("array_atomic_test_and_set_bit()", _arrm_, _idx_, _order_, h_atomic_bit_test_and_set)
+
+/* array_atomic_set_bits(_arrm_, _arrm_idx_), array_atomic_set_bits_explicit(_arrm_, _arrm_idx_, _order_)
+ * Atomically sets bits with indexes from array _arrm_idx_, returns number of bits which were not set before.
+ * @_arrm_: a bitset, an array or a pointer to an array of unsigned integers
+ * @_arrm_idx_: an array or a pointer to an array of bit indexes
+ *
+ * Consecutive indexes, which fall into same element of the bitset, are merged into a single atomic OR.
+ * So sorted or clustered indexes need much fewer atomic operations than calling array_atomic_set_bit() for each one.
+ * Bits of different elements are not set atomically as a whole, only each element is updated atomically.
+ *
+ * example:
+
+	uint64_t (*marks)[1024] = calloc_array(marks);
+	const size_t idx[] = {3, 5, 7, 64, 65, 3};
+	println(array_atomic_set_bits(marks, idx)); //prints: 5
+ */
+#define array_atomic_set_bits(_arrm_, _arrm_idx_) array_atomic_set_bits_explicit(_arrm_, _arrm_idx_, memory_order_seq_cst)
+#define array_atomic_set_bits_explicit(_arrm_, _arrm_idx_, _order_) \
+	h_atomic_set_bits("array_atomic_set_bits()", _arrm_, _arrm_idx_, _order_, h_atomic_emit_none, NULL)
+
+/* array_atomic_test_and_set_bits(_arrm_, _arrm_idx_, _arrm_out_)
+ * array_atomic_test_and_set_bits_explicit(_arrm_, _arrm_idx_, _arrm_out_, _order_)
+ * Same as array_atomic_set_bits(), and also writes indexes of bits, which were set by this call, into array _arrm_out_.
+ * Returns number of written indexes. Each index is written only once even if it is repeated in _arrm_idx_.
+ * @_arrm_out_: an array or a pointer to an array with size not less than size of _arrm_idx_
+ *
+ * Indexes are written in the same order as they appear in _arrm_idx_. This is a batched variant of
+ * array_atomic_test_and_set_bit(), i.e. to build the next frontier of a parallel graph traversal from a list of neighbors.
+ *
+ * example:
+
+	size_t (*next)[ARRAY_SIZE(neighbors)] = malloc_array(next);
+	size_t cnt = array_atomic_test_and_set_bits_explicit(visited, neighbors, next, memory_order_relaxed);
+	//first cnt elements of next are newly visited nodes
+ */
+#define array_atomic_test_and_set_bits(_arrm_, _arrm_idx_, _arrm_out_) \
+	array_atomic_test_and_set_bits_explicit(_arrm_, _arrm_idx_, _arrm_out_, memory_order_seq_cst)
+#define array_atomic_test_and_set_bits_explicit(_arrm_, _arrm_idx_, _arrm_out_, _order_) __extension__ ({	\
+	make_arrview_full(_tsb_out_, _arrm_out_);								\
+	(void)h_atomic_chk_out("array_atomic_test_and_set_bits()", _tsb_out_, _arrm_idx_);			\
+	h_atomic_set_bits("array_atomic_test_and_set_bits()", _arrm_, _arrm_idx_, _order_, h_atomic_emit_out, _tsb_out_); \
+})
+
+/* array_atomic_fetch_add(_arrm_, _idx_, _value_), array_atomic_fetch_add_explicit(_arrm_, _idx_, _value_, _order_)
+ * Atomically adds _value_ to element with index _idx_, returns previous value of the element.
+ * Elements should be integers.
+ *
+ * example:
+
+	uint32_t (*hist)[256] = calloc_array(hist);
+
+	#pragma omp parallel for
+	for(size_t i = 0; i < ARRAY_SIZE(bytes); i++)
+		array_atomic_fetch_add_explicit(hist, (*bytes)[i], 1, memory_order_relaxed);
+ */
+#define array_atomic_fetch_add(_arrm_, _idx_, _value_) \
+	array_atomic_fetch_add_explicit(_arrm_, _idx_, _value_, memory_order_seq_cst)
+#define array_atomic_fetch_add_explicit(_arrm_, _idx_, _value_, _order_) \
+	h_atomic_elem("array_atomic_fetch_add()", _arrm_, _idx_, _value_, _order_, atomic_fetch_add_explicit)
+
+/* array_atomic_fetch_or(_arrm_, _idx_, _value_), array_atomic_fetch_or_explicit(_arrm_, _idx_, _value_, _order_)
+ * array_atomic_fetch_and(_arrm_, _idx_, _value_), array_atomic_fetch_and_explicit(_arrm_, _idx_, _value_, _order_)
+ * Atomically performs bitwise OR or AND of element with index _idx_ and _value_, returns previous value of the element.
+ * These are word level operations, which may be used to set or clear several bits of an element at once.
+ */
+#define array_atomic_fetch_or(_arrm_, _idx_, _value_) \
+	array_atomic_fetch_or_explicit(_arrm_, _idx_, _value_, memory_order_seq_cst)
+#define array_atomic_fetch_or_explicit(_arrm_, _idx_, _value_, _order_) \
+	h_atomic_elem("array_atomic_fetch_or()", _arrm_, _idx_, _value_, _order_, atomic_fetch_or_explicit)
+
+#define array_atomic_fetch_and(_arrm_, _idx_, _value_) \
+	array_atomic_fetch_and_explicit(_arrm_, _idx_, _value_, memory_order_seq_cst)
+#define array_atomic_fetch_and_explicit(_arrm_, _idx_, _value_, _order_) \
+	h_atomic_elem("array_atomic_fetch_and()", _arrm_, _idx_, _value_, _order_, atomic_fetch_and_explicit)
+
+/****** Implementation ******/
+
+/* Returns _Atomic pointer to an element of a plain array */
+#define h_atomic_ptr(_elp_) ((_Atomic(TYPEOF_NO_QUAL(*(_elp_))) *)(_elp_))
+
+/* Memory order for a load, which replaces read-modify-write with (_order_) when the RMW would not change anything */
+static inline memory_order h_atomic_load_order(memory_order order) {
+	switch(order) {
+	case memory_order_release: return memory_order_relaxed;
+	case memory_order_acq_rel: return memory_order_acquire;
+	default: return order;
+	}
+}
+
+/* Operations on a single bit. _ptr_ is an _Atomic pointer to an element, _mask_ has one bit set */
+#define h_atomic_bit_set(_ptr_, _mask_, _order_) atomic_fetch_or_explicit(_ptr_, _mask_, _order_)
+#define h_atomic_bit_unset(_ptr_, _mask_, _order_) atomic_fetch_and_explicit(_ptr_, ~(_mask_), _order_)
+#define h_atomic_bit_get(_ptr_, _mask_, _order_) ((bool)(atomic_load_explicit(_ptr_, _order_) & (_mask_)))
+#define h_atomic_bit_test_and_set(_ptr_, _mask_, _order_)					\
+	((bool)(atomic_load_explicit(_ptr_, h_atomic_load_order(_order_)) & (_mask_)) ||	\
+	 (bool)(atomic_fetch_or_explicit(_ptr_, _mask_, _order_) & (_mask_)))
+
+#define h_atomic_bit(_macro_name_, _arrm_, _idx_, _order_, _op_) __extension__ ({		\
+	make_arrview_full(_ab_arrp_, _arrm_);							\
+	(void)h_atomic_chk_const_index(_macro_name_, _idx_, UNSAFE_ARRAY_SIZE_BYTES(*_ab_arrp_) * 8);	\
+	const size_t _ab_idx_ = (_idx_);							\
+	const size_t _ab_w_ = UNSAFE_ARRAY_ELEMENT_SIZE(*_ab_arrp_) * 8;			\
+	(void)h_bits_chk_elem(_macro_name_, _ab_arrp_);						\
+	(void)h_bits_chk_range(_macro_name_, _ab_arrp_, _ab_idx_ + 1);				\
+	const TYPEOF_NO_QUAL((*_ab_arrp_)[0]) _ab_mask_ = (TYPEOF_NO_QUAL((*_ab_arrp_)[0]))1 << (_ab_idx_ % _ab_w_); \
+	_op_(h_atomic_ptr(&(*_ab_arrp_)[_ab_idx_ / _ab_w_]), _ab_mask_, (_order_));		\
+})
+
+/* Atomic operation with a value on a single element */
+#define h_atomic_elem(_macro_name_, _arrm_, _idx_, _value_, _order_, _fn_) __extension__ ({	\
+	make_arrview_full(_ae_arrp_, _arrm_);							\
+	(void)h_atomic_chk_const_index(_macro_name_, _idx_, UNSAFE_ARRAY_SIZE(*_ae_arrp_));	\
+	const size_t _ae_idx_ = (_idx_);							\
+	(void)h_atomic_chk_index(_macro_name_, _ae_arrp_, _ae_idx_);				\
+	_fn_(h_atomic_ptr(&(*_ae_arrp_)[_ae_idx_]), (_value_), (_order_));			\
+})
+
+/* Writes indexes of bits from _mask_, which were set by array_atomic_test_and_set_bits(),
+ * scanning indexes [_begin_, _end_) of array _idxp_ */
+#define h_atomic_emit_none(_out_, _cnt_, _idxp_, _begin_, _end_, _w_, _mask_) (void)0
+#define h_atomic_emit_out(_out_, _cnt_, _idxp_, _begin_, _end_, _w_, _mask_) do {			\
+	unsigned long long _em_left_ = (_mask_);							\
+	for(size_t _em_i_ = (_begin_); _em_left_ && _em_i_ < (_end_); _em_i_++) {			\
+		const unsigned long long _em_bit_ = 1ULL << ((size_t)(*(_idxp_))[_em_i_] % (_w_));	\
+		if(_em_left_ & _em_bit_) {								\
+			(*(_out_))[(_cnt_)++] = (*(_idxp_))[_em_i_];					\
+			_em_left_ &= ~_em_bit_;								\
+		}											\
+	}												\
+} while(0)
+
+/* array_atomic_set_bits() implementation. Indexes with same element index are merged into one mask,
+ * and the mask is OR'ed into the element only if some of it's bits are not set yet */
+#define h_atomic_set_bits(_macro_name_, _arrm_, _arrm_idx_, _order_, _emit_, _out_) __extension__ ({		\
+	make_arrview_full(_asb_arrp_, _arrm_);									\
+	const make_arrview_full(_asb_idxp_, _arrm_idx_);							\
+	const size_t _asb_w_ = UNSAFE_ARRAY_ELEMENT_SIZE(*_asb_arrp_) * 8;					\
+	const size_t _asb_n_ = UNSAFE_ARRAY_SIZE(*_asb_idxp_);							\
+	const memory_order _asb_order_ = (_order_);								\
+	size_t _asb_cnt_ = 0, _asb_emitted_ = 0;								\
+	(void)h_bits_chk_elem(_macro_name_, _asb_arrp_);							\
+	(void)_asb_emitted_;											\
+	for(size_t _asb_i_ = 0, _asb_j_; _asb_i_ < _asb_n_; _asb_i_ = _asb_j_) {				\
+		const size_t _asb_el_ = (size_t)(*_asb_idxp_)[_asb_i_] / _asb_w_;				\
+		unsigned long long _asb_mask_ = 0;								\
+		for(_asb_j_ = _asb_i_; _asb_j_ < _asb_n_ && (size_t)(*_asb_idxp_)[_asb_j_] / _asb_w_ == _asb_el_; _asb_j_++) { \
+			(void)h_bits_chk_range(_macro_name_, _asb_arrp_, (size_t)(*_asb_idxp_)[_asb_j_] + 1);	\
+			_asb_mask_ |= 1ULL << ((size_t)(*_asb_idxp_)[_asb_j_] % _asb_w_);			\
+		}												\
+		const typeof(h_atomic_ptr(&(*_asb_arrp_)[0])) _asb_ptr_ = h_atomic_ptr(&(*_asb_arrp_)[_asb_el_]);	\
+		unsigned long long _asb_new_ = _asb_mask_ & ~(unsigned long long)				\
+			atomic_load_explicit(_asb_ptr_, h_atomic_load_order(_asb_order_));			\
+		if(_asb_new_)											\
+			_asb_new_ = _asb_mask_ & ~(unsigned long long)						\
+				atomic_fetch_or_explicit(_asb_ptr_, _asb_mask_, _asb_order_);			\
+		_asb_cnt_ += h_bits_popcount64(_asb_new_);							\
+		_emit_(_out_, _asb_emitted_, _asb_idxp_, _asb_i_, _asb_j_, _asb_w_, _asb_new_);			\
+	}													\
+	_asb_cnt_;												\
+})
+
+/* Checks constant index (_idx_) at compile time, before it is copied into a variable.
+ * Non-constant indexes are not evaluated here, they are checked by h_atomic_chk_index() and h_bits_chk_range() */
+#define h_atomic_chk_const_index(_macro_name_, _idx_, _end_) \
+	POOR_ARR_CHK_SEL(h_chk_none, h_atomic_chk_index_static, h_chk_none)(_macro_name_, _idx_, _end_)
+
+#define h_atomic_chk_index_static(_macro_name_, _idx_, _end_) _Generic(1,	\
+	int*: ARR_ASSERT(!is_const_expr(_idx_) || (size_t)(_idx_) < (_end_)),	\
+	default: 0)
+
+#define h_atomic_chk_index(_macro_name_, _arrp_, _idx_) \
+	POOR_ARR_CHK_SEL(h_chk_none, h_chk_none, h_atomic_chk_index_dyn)(_macro_name_, _arrp_, _idx_)
+
+#define h_atomic_chk_index_dyn(_macro_name_, _arrp_, _idx_) (				\
+	ARR_ASSERT_MSG((_idx_) < UNSAFE_ARRAY_SIZE(*(_arrp_)),				\
+		CRED _macro_name_ ": Index is out of array"				\
+		" (index:", (_idx_), " size:", UNSAFE_ARRAY_SIZE(*(_arrp_)), ")"	\
+		" at " FILE_AND_LINE CRESET), 0)
+
+/* Checks that output array can hold all indexes */
+#define h_atomic_chk_out(_macro_name_, _outp_, _arrm_idx_) \
+	POOR_ARR_CHK_SEL(h_chk_none, h_atomic_chk_out_static, h_atomic_chk_out_dyn)(_macro_name_, _outp_, _arrm_idx_)
+
+#define h_atomic_chk_out_static(_macro_name_, _outp_, _arrm_idx_) _Generic(1,	\
+	int*: ARR_ASSERT(UNSAFE_ARRAY_SIZE(*(_outp_)) >= ARRAY_SIZE(_arrm_idx_)),	\
+	default: 0)
+
+#define h_atomic_chk_out_dyn(_macro_name_, _outp_, _arrm_idx_) (				\
+	ARR_ASSERT_MSG(UNSAFE_ARRAY_SIZE(*(_outp_)) >= ARRAY_SIZE(_arrm_idx_),			\
+		CRED _macro_name_ ": Output array is smaller than array of indexes"		\
+		" (" #_arrm_idx_ ":", ARRAY_SIZE(_arrm_idx_),					\
+		" out:", UNSAFE_ARRAY_SIZE(*(_outp_)), ")"					\
+		" at " FILE_AND_LINE CRESET), 0)
+
+#endif // POOR_ATOMIC_H
@@ -0,0 +1,569 @@
+// SPDX-License-Identifier: MIT
+/*
+ * Copyright (C) 2020 Alexandrov Stanislav <lightofmysoul@gmail.com>
+ */
+#ifndef POOR_BITS_H
+#define POOR_BITS_H
+
+#include <poor_array.h>
+#include <poor_common.h>
+#include <poor_traits.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Bitsets over arrays of unsigned integers.
+ * Bits are numbered in the same way as array_set_bit() and array_get_bit() do:
+ * bit (idx) is bit (idx % bits_per_element) of element (idx / bits_per_element),
+ * so any unsigned integer array can be used as a bitset, and macros here can be mixed with array_set_bit().
+ *
+ * Macros here process whole machine words or vectors at a time, instead of testing bits one by one */
+
+/* array_popcount(_arrm_)
+ * Returns number of set bits in an array
+ * @_arrm_: an array or a pointer to an array of unsigned integers
+ *
+ * Bits are counted POOR_SIMD_BYTES at a time with vector instructions when AVX2 is enabled,
+ * otherwise with hardware popcnt instruction if it is enabled (-mpopcnt), since it is faster than 16-byte vectors.
+ *
+ * example:
+
+	uint64_t set[] = {0xff, 0x1, 0};
+	println(array_popcount(set)); //prints: 9
+ */
+#define array_popcount(_arrm_) (							\
+	(void)h_bits_chk_elem("array_popcount()", _arrm_),				\
+	h_bits_popcount_fn(array_first_ref(_arrm_), ARRAY_SIZE_BYTES(_arrm_))		\
+)
+
+/* array_bits_and(_arrm_dst_, _arrm_a_, _arrm_b_): dst = a & b
+ * array_bits_or(_arrm_dst_, _arrm_a_, _arrm_b_): dst = a | b
+ * array_bits_xor(_arrm_dst_, _arrm_a_, _arrm_b_): dst = a ^ b
+ * array_bits_andnot(_arrm_dst_, _arrm_a_, _arrm_b_): dst = a & ~b
+ * Computes bitwise operation on two bitsets
+ * @_arrm_dst_, @_arrm_a_, @_arrm_b_: arrays or pointers to arrays of unsigned integers with same type and same size
+ *
+ * Destination may be the same array as one of operands, so a &= b is array_bits_and(a, a, b),
+ * but it should not partially overlap with them.
+ *
+ * example:
+
+	uint64_t (*match)[1 << 14] = malloc_array(match);
+	const uint64_t (*tag_a)[1 << 14] = get_tag_bitmap("a"), (*tag_b)[1 << 14] = get_tag_bitmap("b");
+	array_bits_and(match, tag_a, tag_b);
+	println(array_popcount(match));
+ */
+#define array_bits_and(_arrm_dst_, _arrm_a_, _arrm_b_) h_bits_3(h_bits_and_fn, "array_bits_and()", _arrm_dst_, _arrm_a_, _arrm_b_)
+#define array_bits_or(_arrm_dst_, _arrm_a_, _arrm_b_) h_bits_3(h_bits_or_fn, "array_bits_or()", _arrm_dst_, _arrm_a_, _arrm_b_)
+#define array_bits_xor(_arrm_dst_, _arrm_a_, _arrm_b_) h_bits_3(h_bits_xor_fn, "array_bits_xor()", _arrm_dst_, _arrm_a_, _arrm_b_)
+#define array_bits_andnot(_arrm_dst_, _arrm_a_, _arrm_b_) h_bits_3(h_bits_andnot_fn, "array_bits_andnot()", _arrm_dst_, _arrm_a_, _arrm_b_)
+
+/* array_find_first_set(_arrm_)
+ * Returns index of the lowest set bit in an array, or ARRAY_SIZE_BITS(_arrm_) if there are no set bits
+ * @_arrm_: an array or a pointer to an array of unsigned integers
+ *
+ * Zero elements are skipped POOR_SIMD_BYTES at a time, then index of the bit is found with count trailing zeros instruction.
+ *
+ * example:
+
+	uint32_t set[4] = {0};
+	array_set_bit(set, 77);
+	println(array_find_first_set(set)); //prints: 77
+ */
+#define array_find_first_set(_arrm_) __extension__ ({						\
+	const make_arrview_full(_ffs_arrp_, _arrm_);						\
+	(void)h_bits_chk_elem("array_find_first_set()", _ffs_arrp_);				\
+	const size_t _ffs_idx_ = h_bits_nonzero_fn(_ffs_arrp_, UNSAFE_ARRAY_SIZE_BYTES(*_ffs_arrp_))	\
+		/ UNSAFE_ARRAY_ELEMENT_SIZE(*_ffs_arrp_);					\
+	_ffs_idx_ < UNSAFE_ARRAY_SIZE(*_ffs_arrp_) ?						\
+		_ffs_idx_ * UNSAFE_ARRAY_ELEMENT_SIZE(*_ffs_arrp_) * 8 + h_bits_ctz((*_ffs_arrp_)[_ffs_idx_]) :	\
+		UNSAFE_ARRAY_SIZE_BYTES(*_ffs_arrp_) * 8;					\
+})
+
+/* array_set_bit_range(_arrm_, _begin_, _end_)
+ * array_unset_bit_range(_arrm_, _begin_, _end_)
+ * Sets or clears all bits with indexes in range [_begin_, _end_)
+ * @_arrm_: an array or a pointer to an array of unsigned integers
+ * @_begin_: index of the first bit
+ * @_end_: index of the bit after the last one, should not be greater than ARRAY_SIZE_BITS(_arrm_)
+ *
+ * Partially covered elements at range borders are updated with masks, elements between them are filled
+ * with all ones or zeros by a loop, which compiler turns into memset().
+ * Empty range (_begin_ >= _end_) does nothing.
+ *
+ * example:
+
+	uint8_t set[3] = {0};
+	array_set_bit_range(set, 4, 20);
+	print_array_hex(set); //prints: [0xf0,0xff,0x0f]
+ */
+#define array_set_bit_range(_arrm_, _begin_, _end_) h_bits_range("array_set_bit_range()", _arrm_, _begin_, _end_, true)
+#define array_unset_bit_range(_arrm_, _begin_, _end_) h_bits_range("array_unset_bit_range()", _arrm_, _begin_, _end_, false)
+
+/* foreach_array_set_bit(_arrm_, _bit_idx_name_)
+ * Iterates over indexes of set bits of an array, from the lowest to the highest one.
+ * @_arrm_: an array or a pointer to an array of unsigned integers
+ * @_bit_idx_name_: name of size_t variable, which will contain index of the current set bit
+ *
+ * Unlike foreach_array_bit(), which tests every bit, this loop loads one element at a time, skips zero elements,
+ * and takes index of the lowest set bit with count trailing zeros instruction, then clears that bit in a local copy
+ * of the element. So loop runs only as many times as there are set bits.
+ * Element is loaded when loop moves to it, so later changes to the current element are not visible to the loop.
+ * break and continue can be used in the loop body.
+ *
+ * example:
+
+	uint64_t set[4] = {0};
+	array_set_bit(set, 3);
+	array_set_bit(set, 130);
+	foreach_array_set_bit(set, idx)
+		print(idx, " "); //prints: 3 130
+ */
+#define foreach_array_set_bit(_arrm_, _bit_idx_name_) \
+	h_foreach_set_bit("foreach_array_set_bit()", _bit_idx_name_, &auto_arr(_arrm_), SIZE_MAX, h_bits_next_set)
+
+/* foreach_array_set_bit_bw(_arrm_, _bit_idx_name_)
+ * Same as foreach_array_set_bit(), but iterates from the highest set bit to the lowest one, using count leading zeros instruction
+ */
+#define foreach_array_set_bit_bw(_arrm_, _bit_idx_name_) \
+	h_foreach_set_bit("foreach_array_set_bit_bw()", _bit_idx_name_, &auto_arr(_arrm_), ARRAY_SIZE(_arrm_), h_bits_prev_set)
+
+/* Rank/select index over a bitset.
+ * Bitset is split into superblocks of 2048 bits, each described by one 64-bit directory entry:
+ * number of set bits before the superblock (relative to a 2^32 bits top level), and cumulative numbers of set bits
+ * in the first one, two and three 512-bit blocks inside the superblock. This takes 3.1% of bitset size.
+ * Additionally, superblock index of every POOR_SELECT_SAMPLE-th set bit is stored to start select1() search.
+ *
+ * Index points to the bitset and doesn't copy it, so bitset should not be changed or freed while index is used */
+typedef struct bitvec_rank_select {
+	const void *bits;	/* first element of the bitset */
+	size_t el_size;		/* size of the bitset element */
+	size_t bytes;		/* size of the bitset in bytes */
+	size_t nbits;		/* number of bits in the bitset */
+	size_t ones;		/* number of set bits in the bitset */
+	uint64_t *top;		/* number of set bits before each 2^32 bits */
+	uint64_t *samples;	/* superblock of each POOR_SELECT_SAMPLE-th set bit */
+	uint64_t dir[];		/* one entry per superblock */
+} bitvec_rank_select;
+
+/* Distance in set bits between select1() samples */
+#ifndef POOR_SELECT_SAMPLE
+#define POOR_SELECT_SAMPLE 8192
+#endif
+
+/* malloc_bitvec_rank_select(_arrm_)
+ * Builds rank/select index over a bitset. Returns pointer to an index, which should be released by free(),
+ * or NULL if memory allocation failed.
+ * @_arrm_: an array or a pointer to an array of unsigned integers, the bitset
+ *
+ * example:
+
+	uint64_t (*postings)[1 << 20] = load_postings();
+	bitvec_rank_select *rs = malloc_bitvec_rank_select(postings);
+	if(rs) {
+		println(bitvec_rank1(rs, 1000)); //number of set bits with indexes less than 1000
+		println(bitvec_select1(rs, 5)); //index of the 6th set bit
+		free(rs);
+	}
+ */
+#define malloc_bitvec_rank_select(_arrm_) (								\
+	(void)h_bits_chk_elem("malloc_bitvec_rank_select()", _arrm_),					\
+	h_bitvec_build(array_first_ref(_arrm_), ARRAY_ELEMENT_SIZE(_arrm_), ARRAY_SIZE_BYTES(_arrm_))	\
+)
+
+/* bitvec_rank1(rs, idx)
+ * Returns number of set bits with indexes less than (idx) in O(1): one directory lookup and up to 8 popcounts.
+ * (idx) greater than number of bits in the bitset is treated as number of bits
+ */
+static inline size_t bitvec_rank1(const bitvec_rank_select *rs, size_t idx);
+
+/* bitvec_select1(rs, k)
+ * Returns index of the set bit with rank (k), i.e. (k + 1)-th set bit, or number of bits in the bitset if k >= rs->ones.
+ * Superblock is found by binary search between two samples, which are at most POOR_SELECT_SAMPLE set bits apart,
+ * so search is O(1) for bitsets with uniform density. Inside a superblock up to 8 words are counted,
+ * and bit inside a word is selected with pdep instruction when BMI2 is enabled.
+ */
+static inline size_t bitvec_select1(const bitvec_rank_select *rs, size_t k);
+
+/****** Implementation ******/
+
+#if defined __GNUC__ || defined __clang__
+#define h_bits_vec_t typeof(uint64_t __attribute__((vector_size(POOR_SIMD_BYTES))))
+#define h_bits_popcount64(_x_) ((size_t)__builtin_popcountll(_x_))
+#define h_bits_ctz(_x_) ((size_t)__builtin_ctzll(_x_))
+#define h_bits_msb(_x_) ((size_t)(63 - __builtin_clzll(_x_)))
+#else
+static inline size_t h_bits_popcount64(uint64_t x) {
+	x = x - ((x >> 1) & 0x5555555555555555ULL);
+	x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+	x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+	return (size_t)((x * 0x0101010101010101ULL) >> 56);
+}
+
+static inline size_t h_bits_ctz(unsigned long long x) {
+	size_t n = 0;
+	for(; !(x & 1); x >>= 1)
+		n++;
+	return n;
+}
+
+static inline size_t h_bits_msb(unsigned long long x) {
+	size_t n = 0;
+	while(x >>= 1)
+		n++;
+	return n;
+}
+#endif
+
+/* Elements of bitsets should be unsigned integers */
+#define h_bits_is_unsigned(_expr_) _Generic((_expr_),					\
+	unsigned char: true, unsigned short: true, unsigned: true,			\
+	unsigned long: true, unsigned long long: true, default: false)
+
+#define h_bits_chk_elem(_macro_name_, _arrm_)						\
+	static_assert_expr(h_bits_is_unsigned(*array_first_ref(_arrm_)),		\
+	_macro_name_ ": array (" #_arrm_ ") should contain unsigned integers")
+
+/* Bitwise operations with checks. Kernels work with bytes, so they are same for all element types */
+#define h_bits_3(_fn_, _macro_name_, _arrm_dst_, _arrm_a_, _arrm_b_) (			\
+	(void)h_bits_chk_elem(_macro_name_, _arrm_dst_),				\
+	h_chk_same(_macro_name_, _arrm_dst_, _arrm_a_),					\
+	h_chk_same(_macro_name_, _arrm_dst_, _arrm_b_),					\
+	_fn_(array_first_ref(_arrm_dst_), array_first_ref(_arrm_a_), array_first_ref(_arrm_b_), ARRAY_SIZE_BYTES(_arrm_dst_)) \
+)
+
+/* Returns number of set bits in a memory block */
+static inline size_t h_bits_popcount_fn(const void *p, size_t bytes) {
+	const unsigned char *const s = p;
+	size_t cnt = 0, i = 0;
+#if (defined __GNUC__ || defined __clang__) && (defined __AVX2__ || !defined __POPCNT__)
+	/* Bits are counted in each byte of a vector, and per-byte counters are summed
+	 * into 64-bit lanes every 31 vectors, before they can overflow */
+	const h_bits_vec_t m1 = 0x5555555555555555ULL + (h_bits_vec_t){0};
+	const h_bits_vec_t m2 = 0x3333333333333333ULL + (h_bits_vec_t){0};
+	const h_bits_vec_t m4 = 0x0f0f0f0f0f0f0f0fULL + (h_bits_vec_t){0};
+	const h_bits_vec_t m8 = 0x00ff00ff00ff00ffULL + (h_bits_vec_t){0};
+	h_bits_vec_t total = {0};
+	while(i + POOR_SIMD_BYTES <= bytes) {
+		h_bits_vec_t acc = {0};
+		for(size_t k = 0; k < 31 && i + POOR_SIMD_BYTES <= bytes; k++, i += POOR_SIMD_BYTES) {
+			h_bits_vec_t x;
+			memcpy(&x, &s[i], sizeof(x));
+			x = x - ((x >> 1) & m1);
+			x = (x & m2) + ((x >> 2) & m2);
+			acc += (x + (x >> 4)) & m4;
+		}
+		acc = (acc & m8) + ((acc >> 8) & m8);
+		acc += acc >> 16;
+		acc += acc >> 32;
+		total += acc & 0xffff;
+	}
+	for(size_t k = 0; k < POOR_SIMD_BYTES / 8; k++)
+		cnt += total[k];
+#else
+	for(; i + 32 <= bytes; i += 32) {
+		uint64_t w[4];
+		memcpy(w, &s[i], sizeof(w));
+		cnt += h_bits_popcount64(w[0]) + h_bits_popcount64(w[1]) + h_bits_popcount64(w[2]) + h_bits_popcount64(w[3]);
+	}
+#endif
+	for(; i + 8 <= bytes; i += 8) {
+		uint64_t w;
+		memcpy(&w, &s[i], sizeof(w));
+		cnt += h_bits_popcount64(w);
+	}
+	if(i < bytes) {
+		uint64_t w = 0;
+		memcpy(&w, &s[i], bytes - i);
+		cnt += h_bits_popcount64(w);
+	}
+	return cnt;
+}
+
+/* Defines h_bits_<name>_fn(dst, a, b, bytes) kernel, which computes dst = _op_(a, b) for memory blocks */
+#if defined __GNUC__ || defined __clang__
+#define h_bits_define_op(_name_, _op_)								\
+static inline void h_bits_ ## _name_ ## _fn(void *dst, const void *a, const void *b, size_t bytes) {	\
+	unsigned char *const d = dst;								\
+	const unsigned char *const x = a, *const y = b;						\
+	size_t i = 0;										\
+	for(; i + POOR_SIMD_BYTES <= bytes; i += POOR_SIMD_BYTES) {				\
+		h_bits_vec_t vx, vy;								\
+		memcpy(&vx, &x[i], sizeof(vx));							\
+		memcpy(&vy, &y[i], sizeof(vy));							\
+		vx = _op_(vx, vy);								\
+		memcpy(&d[i], &vx, sizeof(vx));							\
+	}											\
+	for(; i < bytes; i++)									\
+		d[i] = (unsigned char)_op_(x[i], y[i]);						\
+}
+#else
+#define h_bits_define_op(_name_, _op_)								\
+static inline void h_bits_ ## _name_ ## _fn(void *dst, const void *a, const void *b, size_t bytes) {	\
+	unsigned char *const d = dst;								\
+	const unsigned char *const x = a, *const y = b;						\
+	for(size_t i = 0; i < bytes; i++)							\
+		d[i] = (unsigned char)_op_(x[i], y[i]);						\
+}
+#endif
+
+#define h_bits_op_and(_x_, _y_) ((_x_) & (_y_))
+#define h_bits_op_or(_x_, _y_) ((_x_) | (_y_))
+#define h_bits_op_xor(_x_, _y_) ((_x_) ^ (_y_))
+#define h_bits_op_andnot(_x_, _y_) ((_x_) & ~(_y_))
+
+h_bits_define_op(and, h_bits_op_and)
+h_bits_define_op(or, h_bits_op_or)
+h_bits_define_op(xor, h_bits_op_xor)
+h_bits_define_op(andnot, h_bits_op_andnot)
+
+/* Returns offset of the first non-zero byte of a memory block, or (bytes) if all bytes are zero.
+ * Four vectors are OR'ed together, so zero blocks are skipped with one test per 4 * POOR_SIMD_BYTES */
+static inline size_t h_bits_nonzero_fn(const void *p, size_t bytes) {
+	const unsigned char *const s = p;
+	size_t i = 0;
+#if defined __GNUC__ || defined __clang__
+	for(; i + 4 * POOR_SIMD_BYTES <= bytes; i += 4 * POOR_SIMD_BYTES) {
+		h_bits_vec_t v[4];
+		memcpy(v, &s[i], sizeof(v));
+		const h_bits_vec_t o = (v[0] | v[1]) | (v[2] | v[3]);
+		uint64_t any = 0;
+		for(size_t k = 0; k < POOR_SIMD_BYTES / 8; k++)
+			any |= o[k];
+		if(any)
+			break;
+	}
+#endif
+	for(; i + 8 <= bytes; i += 8) {
+		uint64_t w;
+		memcpy(&w, &s[i], sizeof(w));
+		if(w)
+			break;
+	}
+	while(i < bytes && !s[i])
+		i++;
+	return i;
+}
+
+/* foreach_array_set_bit() implementation.
+ * Outer loops run once and only declare loop state, so break in the loop body leaves all loops.
+ * _widx_ is index of the element, which is cached in _word_ with already visited bits cleared */
+#define h_foreach_set_bit(_macro_name_, _name_, _arrp_, _widx_init_, _next_)					\
+	for(unsigned long long _fsb_word_ = ((void)h_bits_chk_elem(_macro_name_, _arrp_), 0), *_fsb_once_ = &_fsb_word_;	\
+		_fsb_once_; _fsb_once_ = NULL)									\
+	for(size_t _fsb_widx_ = (_widx_init_), _fsb_end_ = UNSAFE_ARRAY_SIZE_BYTES(*(_arrp_)) * 8,			\
+		_name_ = _next_(_arrp_, UNSAFE_ARRAY_ELEMENT_SIZE(*(_arrp_)), UNSAFE_ARRAY_SIZE(*(_arrp_)), &_fsb_widx_, &_fsb_word_); \
+		_name_ < _fsb_end_;											\
+		_name_ = _next_(_arrp_, UNSAFE_ARRAY_ELEMENT_SIZE(*(_arrp_)), UNSAFE_ARRAY_SIZE(*(_arrp_)), &_fsb_widx_, &_fsb_word_))
+
+/* Loads element (idx) of an array of unsigned integers with (el_size) bytes */
+static inline unsigned long long h_bits_word(const void *base, size_t el_size, size_t idx) {
+	const unsigned char *const p = (const unsigned char *)base + idx * el_size;
+	unsigned char w8; unsigned short w16; unsigned w32; unsigned long long w64;
+	switch(el_size) {
+	case sizeof(w8): return memcpy(&w8, p, sizeof(w8)), w8;
+	case sizeof(w16): return memcpy(&w16, p, sizeof(w16)), w16;
+	case sizeof(w32): return memcpy(&w32, p, sizeof(w32)), w32;
+	default: return memcpy(&w64, p, sizeof(w64)), w64;
+	}
+}
+
+/* Returns index of the next set bit, or number of bits in array if there are no more set bits.
+ * (*word) is element (*widx) with visited bits cleared. Loop starts with (*widx) = SIZE_MAX and (*word) = 0 */
+static inline size_t h_bits_next_set(const void *base, size_t el_size, size_t count, size_t *widx, unsigned long long *word) {
+	size_t i = *widx;
+	unsigned long long w = *word;
+	while(!w) {
+		if(++i >= count)
+			return *widx = count, count * el_size * 8;
+		w = h_bits_word(base, el_size, i);
+	}
+	*widx = i;
+	*word = w & (w - 1);
+	return i * el_size * 8 + h_bits_ctz(w);
+}
+
+/* Returns index of the previous set bit, or number of bits in array if there are no more set bits.
+ * (*word) is element (*widx) with visited bits cleared. Loop starts with (*widx) = count and (*word) = 0 */
+static inline size_t h_bits_prev_set(const void *base, size_t el_size, size_t count, size_t *widx, unsigned long long *word) {
+	size_t i = *widx;
+	unsigned long long w = *word;
+	while(!w) {
+		if(!i)
+			return count * el_size * 8;
+		w = h_bits_word(base, el_size, --i);
+	}
+	const size_t bit = h_bits_msb(w);
+	*widx = i;
+	*word = w & ~(1ULL << bit);
+	return i * el_size * 8 + bit;
+}
+
+/* bitvec_rank_select implementation.
+ * Entry of a superblock: bits 0-31: set bits before superblock minus top level value, bits 32-41, 42-52, 53-63:
+ * set bits in the first one, two and three 512-bit blocks of superblock */
+#define h_rs_sb_bits 2048
+#define h_rs_top_sb ((uint64_t)1 << (32 - 11))
+
+static const unsigned char h_rs_shift[4] = {0, 32, 42, 53};
+static const uint64_t h_rs_mask[4] = {0, 0x3ff, 0x7ff, 0x7ff};
+
+/* Loads 64 bits of a bitset starting from bit (64 * k), bits after the end of bitset are zero */
+static inline uint64_t h_bits_word64(const void *base, size_t el_size, size_t bytes, size_t k) {
+	uint64_t w = 0;
+	const size_t off = k * 8;
+	if(off >= bytes)
+		return 0;
+#if defined __BYTE_ORDER__ && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	memcpy(&w, (const unsigned char *)base + off, bytes - off < 8 ? bytes - off : 8);
+#else
+	const size_t per = 8 / el_size;
+	for(size_t j = 0; j < per && off + j * el_size < bytes; j++)
+		w |= (uint64_t)h_bits_word(base, el_size, k * per + j) << (j * el_size * 8 % 64);
+#endif
+	(void)el_size;
+	return w;
+}
+
+/* Returns index of (rank)-th set bit of a word, rank should be less than popcount of the word */
+static inline size_t h_bits_select64(uint64_t w, size_t rank) {
+#if defined __BMI2__ && (defined __GNUC__ || defined __clang__)
+	return h_bits_ctz(__builtin_ia32_pdep_di(1ULL << rank, w));
+#else
+	size_t shift = 0;
+	for(size_t c; rank >= (c = h_bits_popcount64(w & 0xff)); w >>= 8, shift += 8)
+		rank -= c;
+	while(rank--)
+		w &= w - 1;
+	return shift + h_bits_ctz(w);
+#endif
+}
+
+/* Number of set bits before superblock (sb) */
+static inline size_t h_rs_sb_rank(const bitvec_rank_select *rs, size_t sb) {
+	return (size_t)(rs->top[sb / h_rs_top_sb] + (uint32_t)rs->dir[sb]);
+}
+
+static inline bitvec_rank_select *h_bitvec_build(const void *base, size_t el_size, size_t bytes) {
+	const size_t nbits = bytes * 8, nsb = nbits / h_rs_sb_bits + 1, ntop = nsb / h_rs_top_sb + 1;
+	const size_t nsamples = nbits / POOR_SELECT_SAMPLE + 2;
+	bitvec_rank_select *rs = malloc(sizeof(*rs) + (nsb + ntop + nsamples) * sizeof(uint64_t));
+	if(!rs)
+		return NULL;
+
+	rs->bits = base;
+	rs->el_size = el_size;
+	rs->bytes = bytes;
+	rs->nbits = nbits;
+	rs->top = &rs->dir[nsb];
+	rs->samples = &rs->top[ntop];
+
+	uint64_t ones = 0, next_sample = 0;
+	size_t ns = 0;
+	for(size_t sb = 0; sb < nsb; sb++) {
+		if(!(sb % h_rs_top_sb))
+			rs->top[sb / h_rs_top_sb] = ones;
+
+		uint64_t entry = ones - rs->top[sb / h_rs_top_sb], rel = 0;
+		for(size_t b = 0; b < 4; b++) {
+			if(b)
+				entry |= rel << h_rs_shift[b];
+			for(size_t w = 0; w < 8; w++)
+				rel += h_bits_popcount64(h_bits_word64(base, el_size, bytes, sb * 32 + b * 8 + w));
+		}
+		rs->dir[sb] = entry;
+		ones += rel;
+
+		for(; next_sample < ones; next_sample += POOR_SELECT_SAMPLE)
+			rs->samples[ns++] = sb;
+	}
+	rs->samples[ns] = nsb - 1;
+	rs->ones = (size_t)ones;
+	return rs;
+}
+
+static inline size_t bitvec_rank1(const bitvec_rank_select *rs, size_t idx) {
+	if(idx > rs->nbits)
+		idx = rs->nbits;
+
+	const size_t sb = idx / h_rs_sb_bits, b = idx / 512 % 4;
+	size_t rank = h_rs_sb_rank(rs, sb) + (size_t)((rs->dir[sb] >> h_rs_shift[b]) & h_rs_mask[b]);
+	size_t w = idx / 512 * 8;
+	for(; w < idx / 64; w++)
+		rank += h_bits_popcount64(h_bits_word64(rs->bits, rs->el_size, rs->bytes, w));
+	if(idx % 64)
+		rank += h_bits_popcount64(h_bits_word64(rs->bits, rs->el_size, rs->bytes, w) & ((1ULL << (idx % 64)) - 1));
+	return rank;
+}
+
+static inline size_t bitvec_select1(const bitvec_rank_select *rs, size_t k) {
+	if(k >= rs->ones)
+		return rs->nbits;
+
+	/* the last superblock with rank <= k */
+	size_t lo = rs->samples[k / POOR_SELECT_SAMPLE], hi = rs->samples[k / POOR_SELECT_SAMPLE + 1] + 1;
+	while(hi - lo > 1) {
+		const size_t mid = lo + (hi - lo) / 2;
+		if(h_rs_sb_rank(rs, mid) <= k)
+			lo = mid;
+		else
+			hi = mid;
+	}
+
+	const uint64_t entry = rs->dir[lo];
+	size_t rank = k - h_rs_sb_rank(rs, lo), b = 3;
+	while(b && ((entry >> h_rs_shift[b]) & h_rs_mask[b]) > rank)
+		b--;
+	rank -= (size_t)((entry >> h_rs_shift[b]) & h_rs_mask[b]);
+
+	for(size_t w = lo * 32 + b * 8;; w++) {
+		const uint64_t word = h_bits_word64(rs->bits, rs->el_size, rs->bytes, w);
+		const size_t c = h_bits_popcount64(word);
+		if(rank < c)
+			return w * 64 + h_bits_select64(word, rank);
+		rank -= c;
+	}
+}
+
+/* Returns mask with (count) set bits starting from bit (low), count should be in range [1, 64] */
+static inline unsigned long long h_bits_mask(size_t low, size_t count) {
+	return (count >= 64 ? ~0ULL : (1ULL << count) - 1) << low;
+}
+
+#define h_bits_apply_mask(_el_, _mask_, _set_) \
+	((_el_) = (_set_) ? (_el_) | (typeof(_el_))(_mask_) : (_el_) & (typeof(_el_))~(_mask_))
+
+/* array_set_bit_range() implementation */
+#define h_bits_range(_macro_name_, _arrm_, _begin_, _end_, _set_) do {					\
+	make_arrview_full(_rng_arrp_, _arrm_);								\
+	const size_t _rng_b_ = (_begin_), _rng_e_ = (_end_);						\
+	const size_t _rng_w_ = UNSAFE_ARRAY_ELEMENT_SIZE(*_rng_arrp_) * 8;				\
+	(void)h_bits_chk_elem(_macro_name_, _rng_arrp_);						\
+	(void)h_bits_chk_range(_macro_name_, _rng_arrp_, _rng_e_);					\
+	if(_rng_b_ < _rng_e_) {										\
+		const size_t _rng_fi_ = _rng_b_ / _rng_w_, _rng_li_ = (_rng_e_ - 1) / _rng_w_;		\
+		const size_t _rng_lo_ = _rng_b_ % _rng_w_;						\
+		if(_rng_fi_ == _rng_li_) {								\
+			h_bits_apply_mask((*_rng_arrp_)[_rng_fi_], h_bits_mask(_rng_lo_, _rng_e_ - _rng_b_), _set_);	\
+		} else {										\
+			h_bits_apply_mask((*_rng_arrp_)[_rng_fi_], h_bits_mask(_rng_lo_, _rng_w_ - _rng_lo_), _set_);	\
+			for(size_t _rng_i_ = _rng_fi_ + 1; _rng_i_ < _rng_li_; _rng_i_++)			\
+				(*_rng_arrp_)[_rng_i_] = (_set_) ? (typeof((*_rng_arrp_)[0]))~0ULL : 0;		\
+			h_bits_apply_mask((*_rng_arrp_)[_rng_li_], h_bits_mask(0, (_rng_e_ - 1) % _rng_w_ + 1), _set_);	\
+		}											\
+	}												\
+} while(0)
+
+/* Checks that end of a bit range is inside of an array */
+#define h_bits_chk_range(_macro_name_, _arrp_, _end_) \
+	POOR_ARR_CHK_SEL(h_chk_none, h_chk_none, h_bits_chk_range_dyn)(_macro_name_, _arrp_, _end_)
+
+#define h_bits_chk_range_dyn(_macro_name_, _arrp_, _end_) (				\
+	ARR_ASSERT_MSG((_end_) <= UNSAFE_ARRAY_SIZE_BYTES(*(_arrp_)) * 8,		\
+		CRED _macro_name_ ": Bit range is out of array"				\
+		" (end:", (_end_), " bits:", UNSAFE_ARRAY_SIZE_BYTES(*(_arrp_)) * 8, ")"	\
+		" at " FILE_AND_LINE CRESET), 0)
+
+#endif // POOR_BITS_H
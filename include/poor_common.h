@@ -0,0 +1,57 @@
+// SPDX-License-Identifier: MIT
+/*
+ * Copyright (C) 2020 Alexandrov Stanislav <lightofmysoul@gmail.com>
+ */
+#ifndef POOR_COMMON_H
+#define POOR_COMMON_H
+
+#include <poor_array.h>
+#include <poor_traits.h>
+
+/* Internal helpers shared by algorithm headers, not a part of public API */
+
+/* Number of bytes processed at once by vector kernels, should be size of vector register.
+ * Vectors larger than hardware registers are split by compiler into scalar operations */
+#ifndef POOR_SIMD_BYTES
+#if defined __AVX2__
+#define POOR_SIMD_BYTES 32
+#else
+#define POOR_SIMD_BYTES 16
+#endif
+#endif
+
+/* Pragma from a macro: h_pragma(omp parallel) */
+#define h_pragma(...) _Pragma(h_pragma_str(__VA_ARGS__))
+#define h_pragma_str(...) #__VA_ARGS__
+
+/* Checks that both arrays have same types and sizes, expands to a list of two checks,
+ * should be used only inside comma expressions */
+#define h_chk_same(_macro_name_, _arrm_a_, _arrm_b_)				\
+	(void)h_chk_same_type(_macro_name_, _arrm_a_, _arrm_b_),		\
+	(void)h_chk_same_size(_macro_name_, _arrm_a_, _arrm_b_)
+
+/* Checks that both arrays have the same element type, ignoring constness */
+#define h_chk_same_type(_macro_name_, _arrm_a_, _arrm_b_) \
+	POOR_ARR_CHK_SEL(h_chk_none, h_chk_same_type_static, h_chk_same_type_static)(_macro_name_, _arrm_a_, _arrm_b_)
+
+/* Checks that both arrays have the same size */
+#define h_chk_same_size(_macro_name_, _arrm_a_, _arrm_b_) \
+	POOR_ARR_CHK_SEL(h_chk_none, h_chk_same_size_static, h_chk_same_size_dyn)(_macro_name_, _arrm_a_, _arrm_b_)
+
+#define h_chk_none(...) 0
+#define h_chk_same_type_static(_macro_name_, _arrm_a_, _arrm_b_)			\
+	static_assert_expr(is_arrays_of_same_types(_arrm_a_, _arrm_b_),			\
+	_macro_name_ ": array (" #_arrm_b_ ") doesn't have same type as array (" #_arrm_a_ ")")
+
+#define h_chk_same_size_static(_macro_name_, _arrm_a_, _arrm_b_) _Generic(1,	\
+	int*: ARR_ASSERT(ARRAY_SIZE(_arrm_a_) == ARRAY_SIZE(_arrm_b_)),		\
+	default: 0)
+
+#define h_chk_same_size_dyn(_macro_name_, _arrm_a_, _arrm_b_) (			\
+	ARR_ASSERT_MSG(ARRAY_SIZE(_arrm_a_) == ARRAY_SIZE(_arrm_b_),			\
+		CRED _macro_name_ ": Arrays have different sizes"			\
+		" (" #_arrm_a_ ":", ARRAY_SIZE(_arrm_a_),				\
+		" " #_arrm_b_ ":", ARRAY_SIZE(_arrm_b_), ")"				\
+		" at " FILE_AND_LINE CRESET), 0)
+
+#endif // POOR_COMMON_H
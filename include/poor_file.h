@@ -0,0 +1,382 @@
+// SPDX-License-Identifier: MIT
+/*
+ * Copyright (C) 2020 Alexandrov Stanislav <lightofmysoul@gmail.com>
+ */
+#ifndef POOR_FILE_H
+#define POOR_FILE_H
+
+#include <poor_array.h>
+#include <poor_mmap.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Binary array files.
+ * Array file is a 64 byte header followed by raw array data, so reading it is a single read() or mmap()
+ * without any parsing. Header records size of array elements, their count, byte order of the writer
+ * and a checksum of data. Data starts at offset 64, so it is aligned for any element type in a mapping.
+ *
+ * Multi-dimensional arrays, i.e. views created with make_arrview_dim(), are stored as arrays of rows:
+ * count is a number of rows, and element size is a size of a row, so they are read back only
+ * into arrays with the same row shape.
+ *
+ * Files are not portable between machines with different byte order, such files fail to load.
+ */
+
+/* Header of an array file, all fields are in byte order of the writer */
+struct poor_array_file_header {
+	char magic[8];		/* POOR_ARRAY_FILE_MAGIC */
+	uint16_t version;	/* POOR_ARRAY_FILE_VERSION */
+	uint16_t header_size;	/* sizeof(struct poor_array_file_header) */
+	uint32_t byte_order;	/* POOR_ARRAY_FILE_BYTE_ORDER, reads as a different value on a machine with different byte order */
+	uint64_t elem_size;	/* size of a single array element */
+	uint64_t count;		/* number of array elements */
+	uint64_t checksum;	/* array_file_checksum() of data */
+	uint64_t reserved[3];
+};
+
+#define POOR_ARRAY_FILE_MAGIC "POORARR"
+#define POOR_ARRAY_FILE_VERSION 1
+#define POOR_ARRAY_FILE_BYTE_ORDER UINT32_C(0x01020304)
+
+_Static_assert(sizeof(struct poor_array_file_header) == 64, "array file header should be 64 bytes");
+
+/* write_array_file(path, arrm)
+ * Writes array or a pointer to array into a file at (path), replacing it's contents.
+ * Returns true on success, false on failure.
+ * example:
+
+	double (*samples)[n] = ...;
+	if(!write_array_file("samples.bin", samples))
+		perror("samples.bin");
+
+	//a 2D view is stored as 'n / 3' rows of 'double[3]'
+	if(!write_array_file("points.bin", arrview_dim(3, samples)))
+		perror("points.bin");
+ */
+#define write_array_file(_path_, ...) \
+	h_write_array_file(_path_, &auto_arr(__VA_ARGS__), ARRAY_ELEMENT_SIZE(__VA_ARGS__), ARRAY_SIZE(__VA_ARGS__))
+
+/* read_array_file(path, arrp)
+ * Same as malloc_array(), but array is read from a file at (path).
+ * File should contain exactly ARRAY_SIZE(*arrp) elements of the size of (*arrp)[0], and it's checksum should match.
+ * Returns newly allocated pointer, or NULL on failure. Release memory with free().
+ * example:
+
+	double (*samples)[n] = read_array_file("samples.bin", samples);
+	if(!samples)
+		return false;
+ */
+#define read_array_file(_path_, _arrp_) \
+	(( _arrp_ = h_read_array_file(_path_, ARRAY_ELEMENT_SIZE(_arrp_), ARRAY_SIZE(_arrp_)) ))
+
+/* load_array_file(name, type, path)
+ * Reads array from a file at (path) and declares a pointer to array `type (*name)[count]`,
+ * where count is a number of elements stored in the file.
+ * (name) is NULL if file can't be read, element size doesn't match sizeof(type), or checksum doesn't match.
+ * Release memory with free().
+ * example:
+
+	load_array_file(points, double[3], "points.bin");
+	if(points)
+		print_array(points[0]);
+	free(points);
+ */
+#define load_array_file(_name_, _type_, _path_)								\
+	const struct h_array_file _name_ ## _file_ = h_load_array_file(_path_, sizeof(_type_));		\
+	typeof(_type_) (*_name_)[_name_ ## _file_.count] = _name_ ## _file_.ptr
+
+#if POOR_MMAP_AVAILABLE
+
+/* mmap_array_file(name, type, path)
+ * Same as load_array_file(), but the file is mapped read-only, and (name) points to data in the mapping.
+ * Checksum is not verified, because verifying reads the whole file, use array_file_checksum() if needed.
+ * Use const (type). Release mapping with unmap_array_file().
+ * example:
+
+	mmap_array_file(table, const uint64_t, "table.bin");
+	if(!table)
+		return false;
+	madvise_array(table, POOR_ADVISE_RANDOM);
+	...
+	unmap_array_file(table);
+ */
+#define mmap_array_file(_name_, _type_, _path_)								\
+	const struct h_array_file _name_ ## _file_ = h_mmap_array_file(_path_, sizeof(_type_));		\
+	typeof(_type_) (*_name_)[_name_ ## _file_.count] = _name_ ## _file_.ptr
+
+/* unmap_array_file(arrp)
+ * Releases mapping created with mmap_array_file(). Does nothing if (arrp) is NULL.
+ */
+#define unmap_array_file(_arrp_) h_unmap_array_file(_arrp_, ARRAY_SIZE_BYTES(_arrp_))
+
+#endif
+
+/* array_file_checksum(arrm)
+ * Returns checksum of array data as it is stored in the header of an array file.
+ * Checksum processes 32 bytes per iteration and runs close to memory bandwidth.
+ */
+#define array_file_checksum(...) h_array_file_checksum(&auto_arr(__VA_ARGS__), ARRAY_SIZE_BYTES(__VA_ARGS__))
+
+/* foreach_file_chunk(path, type, chunk_elems, view)
+ * Reads a binary file at (path) in chunks of (chunk_elems) elements of (type), and runs the loop body for each chunk
+ * with a pointer to array `type (*view)[n]`, where n is (chunk_elems), or less for the last chunk.
+ * While the body processes a chunk, the kernel is asked to read the next one in the background
+ * (POSIX_FADV_WILLNEED), so computation overlaps with I/O. Trailing bytes which don't fill a whole element are skipped.
+ * It's safe to leave the loop with break, return or goto, the file and the buffer are released.
+ * If file can't be opened or memory allocation fails, loop body is not executed.
+ * Contents of (view) are valid only in the current iteration.
+ * example:
+
+	double sum = 0;
+	foreach_file_chunk("samples.bin", float, 1 << 20, chunk) {
+		foreach_array_const_ref(chunk, ref)
+			sum += *ref;
+	}
+ */
+#define foreach_file_chunk(_path_, _type_, _chunk_elems_, _view_)							\
+	for(struct h_file_chunks _view_ ## _chunks_ __attribute__((cleanup(h_file_chunks_close))) =			\
+		h_file_chunks_open(_path_, sizeof(_type_), _chunk_elems_);						\
+	    h_file_chunks_next(&_view_ ## _chunks_); )									\
+		for(typeof(_type_) (*_view_)[_view_ ## _chunks_.len] __attribute__((unused)) = _view_ ## _chunks_.buf;	\
+		    _view_ ## _chunks_.in_body;										\
+		    _view_ ## _chunks_.in_body = false)
+
+/****** Implementation ******/
+
+/* Pointer to data of a loaded file, count is 1 if loading failed so the array type stays valid */
+struct h_array_file {
+	void *ptr;
+	size_t count;
+};
+
+#define H_FILE_PRIME1 UINT64_C(0x9E3779B185EBCA87)
+#define H_FILE_PRIME2 UINT64_C(0xC2B2AE3D27D4EB4F)
+#define H_FILE_PRIME3 UINT64_C(0x165667B19E3779F9)
+
+static inline uint64_t h_file_rotl(uint64_t v, int r) {
+	return (v << r) | (v >> (64 - r));
+}
+
+static inline uint64_t h_file_round(uint64_t acc, uint64_t v) {
+	return h_file_rotl(acc + v * H_FILE_PRIME2, 31) * H_FILE_PRIME1;
+}
+
+/* Four independent lanes hide multiplication latency */
+static inline uint64_t h_array_file_checksum(const void *data, size_t size) {
+	const unsigned char *p = data;
+	uint64_t lanes[4] = {H_FILE_PRIME1 + H_FILE_PRIME2, H_FILE_PRIME2, 0, -H_FILE_PRIME1};
+	size_t left = size;
+
+	for(; left >= 32; left -= 32, p += 32)
+		for(int i = 0; i < 4; i++) {
+			uint64_t v;
+			memcpy(&v, p + i * 8, 8);
+			lanes[i] = h_file_round(lanes[i], v);
+		}
+
+	uint64_t h = h_file_rotl(lanes[0], 1) + h_file_rotl(lanes[1], 7) + h_file_rotl(lanes[2], 12) + h_file_rotl(lanes[3], 18);
+	for(; left >= 8; left -= 8, p += 8) {
+		uint64_t v;
+		memcpy(&v, p, 8);
+		h = h_file_rotl(h ^ h_file_round(0, v), 27) * H_FILE_PRIME1 + H_FILE_PRIME3;
+	}
+	for(; left; left--, p++)
+		h = h_file_rotl(h ^ (*p * H_FILE_PRIME3), 11) * H_FILE_PRIME1;
+
+	h ^= (uint64_t)size;
+	h ^= h >> 33;
+	h *= H_FILE_PRIME2;
+	h ^= h >> 29;
+	h *= H_FILE_PRIME3;
+	h ^= h >> 32;
+	return h;
+}
+
+static inline bool h_write_array_file(const char *path, const void *data, size_t elem_size, size_t count) {
+	const size_t size = elem_size * count;
+	struct poor_array_file_header header = {
+		.magic = POOR_ARRAY_FILE_MAGIC,
+		.version = POOR_ARRAY_FILE_VERSION,
+		.header_size = sizeof(header),
+		.byte_order = POOR_ARRAY_FILE_BYTE_ORDER,
+		.elem_size = elem_size,
+		.count = count,
+		.checksum = h_array_file_checksum(data, size),
+	};
+
+	FILE *const f = fopen(path, "wb");
+	if(!f)
+		return false;
+
+	const bool ok = fwrite(&header, sizeof(header), 1, f) == 1 && fwrite(data, 1, size, f) == size;
+	return !fclose(f) && ok;
+}
+
+/* Returns number of elements in a file with a valid header, or 0 */
+static inline size_t h_array_file_count(const struct poor_array_file_header *header, size_t elem_size, uintmax_t file_size) {
+	if(memcmp(header->magic, POOR_ARRAY_FILE_MAGIC, sizeof(header->magic))
+	   || header->version != POOR_ARRAY_FILE_VERSION
+	   || header->header_size != sizeof(*header)
+	   || header->byte_order != POOR_ARRAY_FILE_BYTE_ORDER
+	   || header->elem_size != elem_size
+	   || !header->count
+	   || header->count > (SIZE_MAX - sizeof(*header)) / elem_size
+	   || header->count * elem_size != file_size - sizeof(*header))
+		return 0;
+
+	return (size_t)header->count;
+}
+
+/* Reads array data of (count) elements of (elem_size), if count is 0, it is taken from the file */
+static inline struct h_array_file h_read_array_data(const char *path, size_t elem_size, size_t count) {
+	struct h_array_file res = {NULL, 1};
+	FILE *const f = fopen(path, "rb");
+	if(!f)
+		return res;
+
+	struct poor_array_file_header header;
+	if(fread(&header, sizeof(header), 1, f) != 1 || fseek(f, 0, SEEK_END))
+		goto out;
+
+	const long file_size = ftell(f);
+	const size_t file_count = file_size < 0 ? 0 : h_array_file_count(&header, elem_size, (uintmax_t)file_size);
+	if(!file_count || (count && file_count != count) || fseek(f, sizeof(header), SEEK_SET))
+		goto out;
+
+	const size_t size = file_count * elem_size;
+	void *const data = malloc(size);
+	if(!data)
+		goto out;
+
+	if(fread(data, 1, size, f) != size || h_array_file_checksum(data, size) != header.checksum) {
+		free(data);
+		goto out;
+	}
+	res.ptr = data;
+	res.count = file_count;
+out:
+	fclose(f);
+	return res;
+}
+
+static inline void *h_read_array_file(const char *path, size_t elem_size, size_t count) {
+	return h_read_array_data(path, elem_size, count).ptr;
+}
+
+static inline struct h_array_file h_load_array_file(const char *path, size_t elem_size) {
+	return h_read_array_data(path, elem_size, 0);
+}
+
+/* State of foreach_file_chunk().
+ * in_body is reset by the inner loop after the body completes, if it is still set, the body was left with break */
+struct h_file_chunks {
+	FILE *f;
+	void *buf;
+	size_t elem_size;
+	size_t chunk_elems;
+	size_t len;
+	uintmax_t offset;
+	bool in_body;
+};
+
+static inline void h_file_chunks_hint(struct h_file_chunks *c, int advice, uintmax_t len) {
+#if POOR_MMAP_AVAILABLE && defined(POSIX_FADV_WILLNEED)
+	if(c->offset <= INTMAX_MAX && len <= INTMAX_MAX)
+		posix_fadvise(fileno(c->f), (off_t)c->offset, (off_t)len, advice);
+#else
+	(void)c; (void)advice; (void)len;
+#endif
+}
+
+static inline struct h_file_chunks h_file_chunks_open(const char *path, size_t elem_size, size_t chunk_elems) {
+	struct h_file_chunks c = {NULL, NULL, elem_size, chunk_elems, 1, 0, false};
+	if(!chunk_elems || chunk_elems > SIZE_MAX / elem_size)
+		return c;
+
+	c.f = fopen(path, "rb");
+	if(!c.f)
+		return c;
+
+	c.buf = malloc(chunk_elems * elem_size);
+	if(!c.buf) {
+		fclose(c.f);
+		c.f = NULL;
+		return c;
+	}
+
+	/* Chunks are read straight into the buffer, without copying through stdio buffer */
+	setvbuf(c.f, NULL, _IONBF, 0);
+#if POOR_MMAP_AVAILABLE && defined(POSIX_FADV_SEQUENTIAL)
+	h_file_chunks_hint(&c, POSIX_FADV_SEQUENTIAL, 0);
+	h_file_chunks_hint(&c, POSIX_FADV_WILLNEED, chunk_elems * elem_size);
+#endif
+	return c;
+}
+
+static inline bool h_file_chunks_next(struct h_file_chunks *c) {
+	if(!c->f || c->in_body)
+		return false;
+
+	const size_t len = fread(c->buf, c->elem_size, c->chunk_elems, c->f);
+	if(!len)
+		return false;
+
+	c->len = len;
+	c->offset += len * c->elem_size;
+#if POOR_MMAP_AVAILABLE && defined(POSIX_FADV_WILLNEED)
+	if(len == c->chunk_elems)
+		h_file_chunks_hint(c, POSIX_FADV_WILLNEED, len * c->elem_size);
+#endif
+	c->in_body = true;
+	return true;
+}
+
+static inline void h_file_chunks_close(struct h_file_chunks *c) {
+	if(c->f)
+		fclose(c->f);
+	free(c->buf);
+	c->f = NULL;
+	c->buf = NULL;
+}
+
+#if POOR_MMAP_AVAILABLE
+
+static inline struct h_array_file h_mmap_array_file(const char *path, size_t elem_size) {
+	struct h_array_file res = {NULL, 1};
+	const int fd = open(path, O_RDONLY | O_CLOEXEC);
+	if(fd < 0)
+		return res;
+
+	struct stat st;
+	struct poor_array_file_header header;
+	if(fstat(fd, &st) || st.st_size < (off_t)sizeof(header) || (uintmax_t)st.st_size > SIZE_MAX
+	   || pread(fd, &header, sizeof(header), 0) != sizeof(header))
+		goto out;
+
+	const size_t count = h_array_file_count(&header, elem_size, (uintmax_t)st.st_size);
+	if(!count)
+		goto out;
+
+	void *const p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	if(p == MAP_FAILED)
+		goto out;
+
+	res.ptr = (unsigned char*)p + sizeof(header);
+	res.count = count;
+out:
+	close(fd);
+	return res;
+}
+
+static inline void h_unmap_array_file(const void *p, size_t size) {
+	if(p)
+		munmap((unsigned char*)p - sizeof(struct poor_array_file_header), size + sizeof(struct poor_array_file_header));
+}
+
+#endif
+
+#endif // POOR_FILE_H
@@ -0,0 +1,215 @@
+// SPDX-License-Identifier: MIT
+/*
+ * Copyright (C) 2020 Alexandrov Stanislav <lightofmysoul@gmail.com>
+ */
+#ifndef POOR_MMAP_H
+#define POOR_MMAP_H
+
+#include <poor_array.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define POOR_MMAP_AVAILABLE 1
+#else
+#define POOR_MMAP_AVAILABLE 0
+#endif
+
+/* Arrays backed by memory mappings. */
+
+/* Size of a huge page, allocations with malloc_array_huge() are rounded up and aligned to it */
+#ifndef POOR_HUGE_PAGE_SIZE
+#define POOR_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+#endif
+
+/* malloc_array_huge(arrp)
+ * Same as calloc_array(), but memory is mapped with huge pages, which reduces TLB misses
+ * on random access over large arrays. First tries explicit huge pages (MAP_HUGETLB),
+ * and if there are no reserved huge pages, maps regular memory aligned to POOR_HUGE_PAGE_SIZE
+ * and asks for transparent huge pages with madvise(MADV_HUGEPAGE).
+ * Without mmap() falls back to malloc_array_aligned().
+ * Memory is zero initialized. Returns newly allocated pointer, or NULL on failure.
+ * Release memory with free_array_huge(), pointer should have the same type as at allocation.
+ * example:
+
+	uint64_t (*table)[1ULL << 32] = malloc_array_huge(table);
+	if(!table)
+		return false;
+	...
+	free_array_huge(table);
+ */
+#define malloc_array_huge(_arrp_) (( _arrp_ = h_mmap_huge(ARRAY_SIZE_BYTES(_arrp_)) ))
+
+/* free_array_huge(arrp)
+ * Releases memory allocated with malloc_array_huge(). Size of the mapping is taken from the type of (arrp).
+ * Does nothing if (arrp) is NULL.
+ */
+#define free_array_huge(_arrp_) h_munmap_huge(_arrp_, ARRAY_SIZE_BYTES(_arrp_))
+
+#if POOR_MMAP_AVAILABLE
+
+/* Access modes of mmap_file_array() */
+enum poor_mmap_mode {
+	POOR_MMAP_READ,		/* read-only shared mapping */
+	POOR_MMAP_WRITE,	/* read-write shared mapping, changes are written to the file */
+	POOR_MMAP_COPY,		/* copy-on-write private mapping, changes are not written to the file */
+};
+
+/* mmap_file_array(name, type, path, mode)
+ * Maps file at (path) into memory and declares a pointer to array `type (*name)[file_size / sizeof(type)]`,
+ * so the mapping can be used as a regular array without reading it into a buffer.
+ * Trailing bytes of the file which don't fill a whole element are not mapped.
+ * If file can't be opened or mapped, or it is smaller than a single element, (name) is NULL.
+ * Use const (type) for POOR_MMAP_READ mode, writing to a read-only mapping crashes the program.
+ * Release mapping with unmap_file_array().
+ * example:
+
+	mmap_file_array(samples, const float, "samples.bin", POOR_MMAP_READ);
+	if(!samples)
+		return false;
+
+	madvise_array(samples, POOR_ADVISE_SEQUENTIAL);
+	float sum = 0;
+	foreach_array_const_ref(samples, ref)
+		sum += *ref;
+
+	unmap_file_array(samples);
+ */
+#define mmap_file_array(_name_, _type_, _path_, _mode_)							\
+	const struct h_mmap_file _name_ ## _mmap_ = h_mmap_file(_path_, _mode_, sizeof(_type_));		\
+	typeof(_type_) (*_name_)[_name_ ## _mmap_.len] = _name_ ## _mmap_.ptr
+
+/* unmap_file_array(arrp)
+ * Releases mapping created with mmap_file_array(). Changes of POOR_MMAP_WRITE mapping are written to the file
+ * by the kernel. Size of the mapping is taken from the type of (arrp). Does nothing if (arrp) is NULL.
+ */
+#define unmap_file_array(_arrp_) h_munmap_file(_arrp_, ARRAY_SIZE_BYTES(_arrp_))
+
+/* Access patterns for madvise_array() */
+#define POOR_ADVISE_NORMAL	POSIX_MADV_NORMAL	/* no special treatment */
+#define POOR_ADVISE_SEQUENTIAL	POSIX_MADV_SEQUENTIAL	/* aggressive read ahead, pages are freed soon after access */
+#define POOR_ADVISE_RANDOM	POSIX_MADV_RANDOM	/* no read ahead */
+#define POOR_ADVISE_WILLNEED	POSIX_MADV_WILLNEED	/* start reading the whole array now */
+
+/* madvise_array(arrp, advice)
+ * Tells kernel how array mapped with mmap_file_array() or malloc_array_huge() is going to be accessed.
+ * Array may start anywhere inside a mapping, advice is applied to all pages it occupies.
+ * (advice) is one of POOR_ADVISE_* values. Returns 0 on success, or error number on failure.
+ */
+#define madvise_array(_arrp_, _advice_) h_madvise(_arrp_, ARRAY_SIZE_BYTES(_arrp_), _advice_)
+
+#endif
+
+/****** Implementation ******/
+
+static inline size_t h_huge_size(size_t size) {
+	return (size + POOR_HUGE_PAGE_SIZE - 1) & ~(size_t)(POOR_HUGE_PAGE_SIZE - 1);
+}
+
+#if POOR_MMAP_AVAILABLE
+
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+
+static inline void *h_mmap_huge(size_t size) {
+	if(!size || size > SIZE_MAX - POOR_HUGE_PAGE_SIZE * 2)
+		return NULL;
+
+	const size_t len = h_huge_size(size);
+	void *p;
+#ifdef MAP_HUGETLB
+	p = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+	if(p != MAP_FAILED)
+		return p;
+#endif
+
+	/* Over-map and trim, so the mapping starts at a huge page boundary */
+	p = mmap(NULL, len + POOR_HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if(p == MAP_FAILED)
+		return NULL;
+
+	unsigned char *const begin = p;
+	unsigned char *const aligned = (unsigned char*)(((uintptr_t)begin + POOR_HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(POOR_HUGE_PAGE_SIZE - 1));
+	if(aligned != begin)
+		munmap(begin, (size_t)(aligned - begin));
+	if(aligned + len != begin + len + POOR_HUGE_PAGE_SIZE)
+		munmap(aligned + len, (size_t)(begin + POOR_HUGE_PAGE_SIZE - aligned));
+
+#ifdef MADV_HUGEPAGE
+	madvise(aligned, len, MADV_HUGEPAGE);
+#endif
+	return aligned;
+}
+
+static inline void h_munmap_huge(void *p, size_t size) {
+	if(p)
+		munmap(p, h_huge_size(size));
+}
+
+/* Mapping of a file, len is a number of mapped elements, 1 if the mapping failed so the array type stays valid */
+struct h_mmap_file {
+	void *ptr;
+	size_t len;
+};
+
+static inline struct h_mmap_file h_mmap_file(const char *path, enum poor_mmap_mode mode, size_t elem_size) {
+	struct h_mmap_file m = {NULL, 1};
+	const int fd = open(path, (mode == POOR_MMAP_WRITE ? O_RDWR : O_RDONLY) | O_CLOEXEC);
+	if(fd < 0)
+		return m;
+
+	struct stat st;
+	if(!fstat(fd, &st) && st.st_size > 0 && (uintmax_t)st.st_size <= SIZE_MAX && (size_t)st.st_size >= elem_size) {
+		const size_t len = (size_t)st.st_size / elem_size;
+		const int prot = mode == POOR_MMAP_READ ? PROT_READ : PROT_READ | PROT_WRITE;
+		const int flags = mode == POOR_MMAP_COPY ? MAP_PRIVATE : MAP_SHARED;
+		void *const p = mmap(NULL, len * elem_size, prot, flags, fd, 0);
+		if(p != MAP_FAILED) {
+			m.ptr = p;
+			m.len = len;
+		}
+	}
+	close(fd);
+	return m;
+}
+
+static inline void h_munmap_file(const void *p, size_t size) {
+	if(p)
+		munmap((void*)p, size);
+}
+
+/* Advice is applied to whole pages, so arrays which don't start at a page boundary work too */
+static inline int h_madvise(const void *p, size_t size, int advice) {
+	if(!p)
+		return 0;
+
+	const uintptr_t page = (uintptr_t)sysconf(_SC_PAGESIZE);
+	const uintptr_t begin = (uintptr_t)p & ~(page - 1);
+	return posix_madvise((void*)begin, size + ((uintptr_t)p - begin), advice);
+}
+
+#else
+
+static inline void *h_mmap_huge(size_t size) {
+	if(!size || size > SIZE_MAX - POOR_HUGE_PAGE_SIZE * 2)
+		return NULL;
+
+	void *p = aligned_alloc(POOR_HUGE_PAGE_SIZE, h_huge_size(size));
+	return p ? memset(p, 0, size) : p;
+}
+
+static inline void h_munmap_huge(void *p, size_t size) {
+	(void)size;
+	free(p);
+}
+
+#endif
+
+#endif // POOR_MMAP_H
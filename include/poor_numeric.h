@@ -0,0 +1,379 @@
+// SPDX-License-Identifier: MIT
+/*
+ * Copyright (C) 2020 Alexandrov Stanislav <lightofmysoul@gmail.com>
+ */
+#ifndef POOR_NUMERIC_H
+#define POOR_NUMERIC_H
+
+#include <poor_algo.h>
+#include <poor_array.h>
+#include <poor_common.h>
+#include <poor_map.h>
+#include <stddef.h>
+
+/* Numeric kernels over arrays of standard arithmetic types.
+ *
+ * Kernels are static inline functions generated for each standard C type, and macros select them with _Generic.
+ * Every kernel keeps POOR_SIMD_LANES independent accumulators, so compilers can vectorize them
+ * without reassociation of floating point operations (no -ffast-math needed). */
+#ifndef POOR_SIMD_LANES
+#define POOR_SIMD_LANES 8
+#endif
+
+/* Results of array_stats() and array_minmax(). Type of result depends on array element type:
+ *	array_stats_s:  char, signed integer types
+ *	array_stats_u:  unsigned integer types
+ *	array_stats_f:  float and double
+ *	array_stats_lf: long double
+ *
+ * mean and variance are computed in floating point, variance is population variance (divided by count) */
+typedef struct array_stats_s {
+	size_t count;
+	long long sum, min, max;
+	double mean, variance;
+} array_stats_s;
+
+typedef struct array_stats_u {
+	size_t count;
+	unsigned long long sum, min, max;
+	double mean, variance;
+} array_stats_u;
+
+typedef struct array_stats_f {
+	size_t count;
+	double sum, min, max;
+	double mean, variance;
+} array_stats_f;
+
+typedef struct array_stats_lf {
+	size_t count;
+	long double sum, min, max;
+	long double mean, variance;
+} array_stats_lf;
+
+/* array_stats(_arrm_)
+ * Computes count, sum, min, max, mean and variance of array elements in a single pass.
+ * @_arrm_: an array or a pointer to an array of integer or floating point type
+ *
+ * Integer elements are summed in long long or unsigned long long, so sum of 8, 16 and 32 bit elements
+ * never overflows. Sum of 64-bit elements wraps around, mean and variance are not affected by that.
+ * float and double elements are summed in double with Kahan compensation.
+ * Variance is computed from values shifted by the first element, which keeps precision when mean is large.
+ *
+ * Returns one of array_stats_* structs, all fields except count are zero for empty arrays (empty views).
+ *
+ * example:
+
+	const float samples[] = {1.5f, 2.5f, 4.0f, 8.0f};
+	array_stats_f st = array_stats(samples);
+	println("min:", st.min, " max:", st.max, " mean:", st.mean, " variance:", st.variance);
+	//prints: min:1.500000 max:8.000000 mean:4.000000 variance:6.125000
+ */
+#define array_stats(...) h_numeric_call(h_array_stats_, __VA_ARGS__)
+
+/* array_sum(_arrm_)
+ * Returns sum of array elements, computed in the same way as array_stats().sum
+ * Returned type is long long, unsigned long long, double or long double
+ * example:
+
+	uint8_t bytes[] = {200, 100, 50};
+	println(array_sum(bytes)); //prints: 350
+ */
+#define array_sum(...) h_numeric_call(h_array_sum_, __VA_ARGS__)
+
+/* array_minmax(_arrm_)
+ * Returns minimum and maximum of array elements in the same struct as array_stats(),
+ * but only count, min and max fields are computed
+ * example:
+
+	int v[] = {4, -2, 9};
+	array_stats_s mm = array_minmax(v);
+	println(mm.min, " ", mm.max); //prints: -2 9
+ */
+#define array_minmax(...) h_numeric_call(h_array_minmax_, __VA_ARGS__)
+
+/*** Element-wise kernels ***
+ * All arrays passed to these macros should have same element type (ignoring qualifiers) and same size.
+ * Depending on POOR_ARRAY_CHECK setting, types and sizes are checked at compile time,
+ * and sizes of VLAs are checked at run time.
+ * Destination array may be the same array as one of the sources.
+ */
+
+/* array_add(_arrm_dst_, _arrm_a_, _arrm_b_): dst[i] = a[i] + b[i]
+ * example:
+
+	float a[] = {1, 2, 3}, b[] = {10, 20, 30}, c[3];
+	array_add(c, a, b);
+	print_array(c); //prints: [11.000000,22.000000,33.000000]
+ */
+#define array_add(_arrm_dst_, _arrm_a_, _arrm_b_) h_blas_3(h_array_add_, "array_add()", _arrm_dst_, _arrm_a_, _arrm_b_)
+
+/* array_mul(_arrm_dst_, _arrm_a_, _arrm_b_): dst[i] = a[i] * b[i] */
+#define array_mul(_arrm_dst_, _arrm_a_, _arrm_b_) h_blas_3(h_array_mul_, "array_mul()", _arrm_dst_, _arrm_a_, _arrm_b_)
+
+/* array_scale(_arrm_, _alpha_): arr[i] = arr[i] * alpha
+ * @_alpha_ is converted to array element type */
+#define array_scale(_arrm_, _alpha_) \
+	h_numeric_generic(h_array_scale_, &auto_arr(_arrm_))(ARRAY_SIZE(_arrm_), array_first_ref(_arrm_), (_alpha_))
+
+/* array_axpy(_arrm_y_, _alpha_, _arrm_x_): y[i] = alpha * x[i] + y[i]
+ * @_alpha_ is converted to array element type
+ * example:
+
+	double y[] = {1, 1, 1};
+	const double x[] = {1, 2, 3};
+	array_axpy(y, 2.0, x);
+	print_array(y); //prints: [3.000000,5.000000,7.000000]
+ */
+#define array_axpy(_arrm_y_, _alpha_, _arrm_x_) (							\
+	h_chk_same("array_axpy()", _arrm_y_, _arrm_x_),					\
+	h_numeric_generic(h_array_axpy_, &auto_arr(_arrm_y_))(ARRAY_SIZE(_arrm_y_),			\
+		array_first_ref(_arrm_y_), (_alpha_), array_first_ref(_arrm_x_))			\
+)
+
+/* array_dot(_arrm_a_, _arrm_b_)
+ * Returns sum of a[i] * b[i]
+ * Products are accumulated in the same types as array_sum(): long long, unsigned long long, double or long double
+ * Integer products and sums wrap around modulo 2^64 instead of overflowing
+ * example:
+
+	const int a[] = {1, 2, 3}, b[] = {4, 5, 6};
+	println(array_dot(a, b)); //prints: 32
+ */
+#define array_dot(_arrm_a_, _arrm_b_) (									\
+	h_chk_same("array_dot()", _arrm_a_, _arrm_b_),					\
+	h_numeric_generic(h_array_dot_, &auto_arr(_arrm_a_))(ARRAY_SIZE(_arrm_a_),			\
+		array_first_ref(_arrm_a_), array_first_ref(_arrm_b_))					\
+)
+
+/****** Implementation ******/
+
+/* Calls _macro_(suffix, type, category) for each supported element type */
+#define h_numeric_types(_macro_)				\
+	_macro_(c,   char,               s)			\
+	_macro_(sc,  signed char,        s)			\
+	_macro_(uc,  unsigned char,      u)			\
+	_macro_(ss,  short,              s)			\
+	_macro_(us,  unsigned short,     u)			\
+	_macro_(si,  int,                s)			\
+	_macro_(ui,  unsigned,           u)			\
+	_macro_(sl,  long,               s)			\
+	_macro_(ul,  unsigned long,      u)			\
+	_macro_(sll, long long,          s)			\
+	_macro_(ull, unsigned long long, u)			\
+	_macro_(f,   float,              f)			\
+	_macro_(d,   double,             f)			\
+	_macro_(ld,  long double,        lf)
+
+/* Selects kernel with _prefix_ for array element type */
+#define h_numeric_generic(_prefix_, _arrp_) _Generic((*(_arrp_))[0],	\
+	char:			_prefix_ ## c,				\
+	signed char:		_prefix_ ## sc,				\
+	unsigned char:		_prefix_ ## uc,				\
+	short:			_prefix_ ## ss,				\
+	unsigned short:		_prefix_ ## us,				\
+	int:			_prefix_ ## si,				\
+	unsigned:		_prefix_ ## ui,				\
+	long:			_prefix_ ## sl,				\
+	unsigned long:		_prefix_ ## ul,				\
+	long long:		_prefix_ ## sll,			\
+	unsigned long long:	_prefix_ ## ull,			\
+	float:			_prefix_ ## f,				\
+	double:			_prefix_ ## d,				\
+	long double:		_prefix_ ## ld)
+
+#define h_numeric_call(_prefix_, ...) \
+	h_numeric_generic(_prefix_, &auto_arr(__VA_ARGS__))(ARRAY_SIZE(__VA_ARGS__), array_first_ref(__VA_ARGS__))
+
+/* Accumulator types for each category: sum of elements and floating point type for mean and variance */
+#define h_num_sum_t_s	long long
+#define h_num_sum_t_u	unsigned long long
+#define h_num_sum_t_f	double
+#define h_num_sum_t_lf	long double
+
+#define h_num_real_t_s	double
+#define h_num_real_t_u	double
+#define h_num_real_t_f	double
+#define h_num_real_t_lf	long double
+
+/* Adds value _x_ to accumulator _s_ with compensation _c_.
+ * Integers are added modulo 2^64, floating point values use Kahan summation. */
+#define h_num_add_s(_s_, _c_, _x_) ((void)(_c_), (_s_) = (long long)((unsigned long long)(_s_) + (unsigned long long)(_x_)))
+#define h_num_add_u(_s_, _c_, _x_) ((void)(_c_), (_s_) += (_x_))
+#define h_num_add_f(_s_, _c_, _x_) h_num_kahan_add(_s_, _c_, _x_, double)
+#define h_num_add_lf(_s_, _c_, _x_) h_num_kahan_add(_s_, _c_, _x_, long double)
+
+#define h_num_kahan_add(_s_, _c_, _x_, _type_) do {	\
+	const _type_ _y_ = (_type_)(_x_) - (_c_);	\
+	const _type_ _t_ = (_s_) + _y_;			\
+	(_c_) = (_t_ - (_s_)) - _y_;			\
+	(_s_) = _t_;					\
+} while(0)
+
+#define h_num_min(_a_, _b_) ((_b_) < (_a_) ? (_b_) : (_a_))
+#define h_num_max(_a_, _b_) ((_b_) > (_a_) ? (_b_) : (_a_))
+
+/* Loops over _n_ elements using POOR_SIMD_LANES independent lanes.
+ * _step_(lane, idx, ...) is called for each element, tail is spread over the first lanes */
+#define h_num_lanes_loop(_n_, _step_, ...) do {					\
+	size_t _i_ = 0;								\
+	for(; _i_ + POOR_SIMD_LANES <= (_n_); _i_ += POOR_SIMD_LANES)		\
+		for(size_t _l_ = 0; _l_ < POOR_SIMD_LANES; _l_++)		\
+			_step_(_l_, _i_ + _l_, __VA_ARGS__);			\
+	for(size_t _l_ = 0; _l_ < POOR_SIMD_LANES && _i_ + _l_ < (_n_); _l_++)	\
+		_step_(_l_, _i_ + _l_, __VA_ARGS__);				\
+} while(0)
+
+/* Merges lanes pairwise into lane 0 with _merge_(dst_lane, src_lane, ...) */
+#define h_num_lanes_merge(_merge_, ...) do {					\
+	for(size_t _w_ = POOR_SIMD_LANES / 2; _w_; _w_ /= 2)			\
+		for(size_t _l_ = 0; _l_ < _w_; _l_++)				\
+			_merge_(_l_, _l_ + _w_, __VA_ARGS__);			\
+} while(0)
+
+/* Declares per-lane accumulators of sum, min and max */
+#define h_num_decl_sum(_cat_)										\
+	TOKEN_CAT_2(h_num_sum_t_, _cat_) sum[POOR_SIMD_LANES] = {0}, comp[POOR_SIMD_LANES] = {0}
+
+#define h_num_decl_minmax(_type_)				\
+	_type_ mn[POOR_SIMD_LANES], mx[POOR_SIMD_LANES];	\
+	for(size_t l = 0; l < POOR_SIMD_LANES; l++)		\
+		mn[l] = mx[l] = a[0]
+
+/* Per element steps and lane merges */
+#define h_sum_step(_l_, _idx_, _cat_) TOKEN_CAT_2(h_num_add_, _cat_)(sum[_l_], comp[_l_], a[_idx_])
+#define h_sum_merge(_dst_, _src_, _cat_) do {					\
+	TOKEN_CAT_2(h_num_add_, _cat_)(sum[_dst_], comp[_dst_], sum[_src_]);	\
+	comp[_dst_] += comp[_src_];						\
+} while(0)
+
+#define h_minmax_step(_l_, _idx_, _cat_) do {		\
+	mn[_l_] = h_num_min(mn[_l_], a[_idx_]);		\
+	mx[_l_] = h_num_max(mx[_l_], a[_idx_]);		\
+} while(0)
+#define h_minmax_step_lane(_dst_, _src_) do {		\
+	mn[_dst_] = h_num_min(mn[_dst_], mn[_src_]);	\
+	mx[_dst_] = h_num_max(mx[_dst_], mx[_src_]);	\
+} while(0)
+
+#define h_stats_step(_l_, _idx_, _cat_) do {			\
+	h_sum_step(_l_, _idx_, _cat_);				\
+	const TOKEN_CAT_2(h_num_real_t_, _cat_) _d_ =		\
+		(TOKEN_CAT_2(h_num_real_t_, _cat_))a[_idx_] - shift;	\
+	dsum[_l_] += _d_;					\
+	sq[_l_] += _d_ * _d_;					\
+	h_minmax_step(_l_, _idx_, _cat_);			\
+} while(0)
+
+#define h_stats_merge(_dst_, _src_, _cat_) do {		\
+	h_sum_merge(_dst_, _src_, _cat_);		\
+	dsum[_dst_] += dsum[_src_];			\
+	sq[_dst_] += sq[_src_];				\
+	h_minmax_step_lane(_dst_, _src_);		\
+} while(0)
+
+/* array_stats() kernels */
+#define h_define_array_stats(_sfx_, _type_, _cat_)							\
+static inline array_stats_ ## _cat_ h_array_stats_ ## _sfx_(size_t n, const _type_ *restrict a) {	\
+	array_stats_ ## _cat_ st = {.count = n};							\
+	if(!n)												\
+		return st;										\
+													\
+	const h_num_real_t_ ## _cat_ shift = a[0];							\
+	h_num_real_t_ ## _cat_ dsum[POOR_SIMD_LANES] = {0}, sq[POOR_SIMD_LANES] = {0};			\
+	h_num_decl_sum(_cat_);										\
+	h_num_decl_minmax(_type_);									\
+													\
+	h_num_lanes_loop(n, h_stats_step, _cat_);							\
+	h_num_lanes_merge(h_stats_merge, _cat_);							\
+													\
+	const h_num_real_t_ ## _cat_ dmean = dsum[0] / n;						\
+	st.sum = sum[0] - comp[0];									\
+	st.min = mn[0];											\
+	st.max = mx[0];											\
+	st.mean = shift + dmean;									\
+	st.variance = sq[0] / n - dmean * dmean;							\
+	if(st.variance < 0)										\
+		st.variance = 0;									\
+	return st;											\
+}
+
+/* array_sum() kernels */
+#define h_define_array_sum(_sfx_, _type_, _cat_)							\
+static inline h_num_sum_t_ ## _cat_ h_array_sum_ ## _sfx_(size_t n, const _type_ *restrict a) {	\
+	h_num_decl_sum(_cat_);										\
+	h_num_lanes_loop(n, h_sum_step, _cat_);								\
+	h_num_lanes_merge(h_sum_merge, _cat_);								\
+	return sum[0] - comp[0];									\
+}
+
+/* array_minmax() kernels */
+#define h_define_array_minmax(_sfx_, _type_, _cat_)							\
+static inline array_stats_ ## _cat_ h_array_minmax_ ## _sfx_(size_t n, const _type_ *restrict a) {	\
+	array_stats_ ## _cat_ st = {.count = n};							\
+	if(!n)												\
+		return st;										\
+													\
+	h_num_decl_minmax(_type_);									\
+	h_num_lanes_loop(n, h_minmax_step, _cat_);							\
+	h_num_lanes_merge(h_minmax_merge_lane, _cat_);							\
+	st.min = mn[0];											\
+	st.max = mx[0];											\
+	return st;											\
+}
+#define h_minmax_merge_lane(_dst_, _src_, _cat_) h_minmax_step_lane(_dst_, _src_)
+
+/* Element-wise kernels checks */
+#define h_blas_3(_prefix_, _macro_name_, _arrm_dst_, _arrm_a_, _arrm_b_) (				\
+	h_chk_same(_macro_name_, _arrm_dst_, _arrm_a_),						\
+	h_chk_same(_macro_name_, _arrm_dst_, _arrm_b_),						\
+	h_numeric_generic(_prefix_, &auto_arr(_arrm_dst_))(ARRAY_SIZE(_arrm_dst_),			\
+		array_first_ref(_arrm_dst_), array_first_ref(_arrm_a_), array_first_ref(_arrm_b_))	\
+)
+
+/* Element-wise kernels. Arrays may alias, compilers generate run-time overlap checks for vectorized loops */
+#define h_define_array_elementwise(_sfx_, _type_, _cat_)						\
+static inline void h_array_add_ ## _sfx_(size_t n, _type_ *dst, const _type_ *a, const _type_ *b) {	\
+	for(size_t i = 0; i < n; i++)									\
+		dst[i] = a[i] + b[i];									\
+}													\
+static inline void h_array_mul_ ## _sfx_(size_t n, _type_ *dst, const _type_ *a, const _type_ *b) {	\
+	for(size_t i = 0; i < n; i++)									\
+		dst[i] = a[i] * b[i];									\
+}													\
+static inline void h_array_scale_ ## _sfx_(size_t n, _type_ *a, const _type_ alpha) {			\
+	for(size_t i = 0; i < n; i++)									\
+		a[i] = a[i] * alpha;									\
+}													\
+static inline void h_array_axpy_ ## _sfx_(size_t n, _type_ *y, const _type_ alpha, const _type_ *x) {	\
+	for(size_t i = 0; i < n; i++)									\
+		y[i] = alpha * x[i] + y[i];								\
+}
+
+/* array_dot() kernels.
+ * Signed integers are multiplied and summed in unsigned long long, modulo 2^64 like h_num_add_s(),
+ * because signed overflow is undefined. Result is converted back to long long at the end */
+#define h_num_dot_t_s	unsigned long long
+#define h_num_dot_t_u	unsigned long long
+#define h_num_dot_t_f	double
+#define h_num_dot_t_lf	long double
+
+#define h_dot_step(_l_, _idx_, _cat_) \
+	(sum[_l_] += (TOKEN_CAT_2(h_num_dot_t_, _cat_))a[_idx_] * (TOKEN_CAT_2(h_num_dot_t_, _cat_))b[_idx_])
+#define h_dot_merge(_dst_, _src_, _cat_) (sum[_dst_] += sum[_src_])
+
+#define h_define_array_dot(_sfx_, _type_, _cat_)								\
+static inline h_num_sum_t_ ## _cat_ h_array_dot_ ## _sfx_(size_t n, const _type_ *a, const _type_ *b) {	\
+	h_num_dot_t_ ## _cat_ sum[POOR_SIMD_LANES] = {0};							\
+	h_num_lanes_loop(n, h_dot_step, _cat_);									\
+	h_num_lanes_merge(h_dot_merge, _cat_);									\
+	return (h_num_sum_t_ ## _cat_)sum[0];									\
+}
+
+h_numeric_types(h_define_array_stats)
+h_numeric_types(h_define_array_sum)
+h_numeric_types(h_define_array_minmax)
+h_numeric_types(h_define_array_elementwise)
+h_numeric_types(h_define_array_dot)
+
+#endif // POOR_NUMERIC_H
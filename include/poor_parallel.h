@@ -0,0 +1,208 @@
+// SPDX-License-Identifier: MIT
+/*
+ * Copyright (C) 2020 Alexandrov Stanislav <lightofmysoul@gmail.com>
+ */
+#ifndef POOR_PARALLEL_H
+#define POOR_PARALLEL_H
+
+#include <poor_algo.h>
+#include <poor_array.h>
+#include <poor_common.h>
+#include <poor_traits.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Parallel macros use OpenMP worker threads, compile with -fopenmp (or equivalent) to enable them.
+ * Without OpenMP every macro here still works, but runs on the calling thread only.
+ *
+ * Number of workers is taken from OpenMP runtime (OMP_NUM_THREADS, omp_set_num_threads()).
+ * Work is split once per call into one arrview per worker with static schedule,
+ * so same worker always touches same pages of the same array. This allows
+ * first-touch page placement to follow the worker which initialized the page. */
+#ifdef _OPENMP
+#include <omp.h>
+#define POOR_OMP(...) h_pragma(omp __VA_ARGS__)
+#else
+#define POOR_OMP(...)
+#endif
+
+/* Size of a memory page used to align arrviews, processed by different workers */
+#ifndef POOR_PAGE_SIZE
+#define POOR_PAGE_SIZE 4096
+#endif
+
+/* Arrays smaller than this number of bytes per worker won't be split further */
+#ifndef POOR_PARALLEL_MIN_BYTES
+#define POOR_PARALLEL_MIN_BYTES (64 * 1024)
+#endif
+
+/* Returns maximum number of worker threads which can be used by parallel macros */
+static inline size_t poor_parallel_threads(void) {
+#ifdef _OPENMP
+	return (size_t)omp_get_max_threads();
+#else
+	return 1;
+#endif
+}
+
+/* foreach_parallel_arrview(_view_name_, _arrm_)
+ * Splits an array into page-aligned arrviews and executes loop body for each arrview on a worker thread.
+ * @_view_name_: name of a pointer to an array, which will point to the current arrview
+ * @_arrm_: an array or a pointer to an array
+ *
+ * Every arrview except the first one starts at the first element which lies at or after a page boundary.
+ * Arrays smaller than POOR_PARALLEL_MIN_BYTES are processed by the calling thread as a single arrview.
+ *
+ * Loop body is executed concurrently, so it should not write to shared variables,
+ * and it should not use break or return.
+ *
+ * example:
+
+	double (*data)[1 << 28] = malloc_array(data);
+	foreach_parallel_arrview(part, data)
+		foreach_array_ref(part, ref)
+			*ref = sqrt(array_ref_index(data, ref));
+
+ */
+#define foreach_parallel_arrview(_view_name_, ...) h_foreach_par_av(_view_name_, &auto_arr(__VA_ARGS__))
+
+/* parallel_memset_array(_arrm_, _symbol_)
+ * Same as memset_array(), but each page-aligned part of the array is filled by it's own worker thread.
+ * example:
+
+	char (*data)[20ULL << 30] = malloc_array(data);
+	if(data)
+		parallel_memset_array(data, 0);
+ */
+#define parallel_memset_array(_arrm_, _symbol_)			\
+	foreach_parallel_arrview(_par_view_, _arrm_)		\
+		(void)memset(_par_view_, _symbol_, UNSAFE_ARRAY_SIZE_BYTES(*_par_view_))
+
+/* parallel_fill_array(_arrm_, _value_)
+ * Same as fill_array(), but each page-aligned part of the array is filled by it's own worker thread.
+ * @_value_ is evaluated for each element of the array.
+ * example:
+
+	long (*ty)[1 << 30] = malloc_array(ty);
+	if(ty) {
+		parallel_fill_array(ty, -1);
+		free(ty);
+	}
+ */
+#define parallel_fill_array(_arrm_, ...)			\
+	foreach_parallel_arrview(_par_view_, _arrm_)		\
+		unsafe_fill_array(_par_view_, __VA_ARGS__)
+
+/* parallel_copy_array(_arrm_dst_, _arrm_src_)
+ * Same as copy_array(), but each page-aligned part of the destination is copied by it's own worker thread.
+ * As with copy_array(), only min(ARRAY_SIZE(dst), ARRAY_SIZE(src)) elements are copied
+ * and arrays may contain elements of different types.
+ * Source and destination arrays should not overlap.
+ * example:
+
+	float (*dst)[1 << 28] = malloc_array(dst);
+	const float (*src)[1 << 28] = get_samples();
+	if(dst)
+		parallel_copy_array(dst, src);
+ */
+#define parallel_copy_array(_arrm_dst_, ...)							\
+	for(unsafe_nc_make_arrview_first(_par_dst_,						\
+		h_copy_min(ARRAY_SIZE(_arrm_dst_), ARRAY_SIZE(__VA_ARGS__)), &auto_arr(_arrm_dst_)),	\
+		(*_par_once_)[1] = NULL; !_par_once_; _par_once_ = (void*)_par_dst_)		\
+	h_foreach_par_av(_par_view_, _par_dst_)							\
+		unsafe_copy_array(_par_view_, (const unsafe_make_arrptr(, ARRAY_SIZE(_par_view_), &auto_arr(__VA_ARGS__))) \
+			&auto_arr(__VA_ARGS__)[unsafe_array_first_ref(_par_view_) - unsafe_array_first_ref(_par_dst_)])
+
+/* parallel_array_reduce(_arrm_, _init_, _op_, _combine_)
+ * Multi-threaded variant of array_reduce().
+ * @_arrm_: an array or a pointer to an array
+ * @_init_: initial value of each partial accumulator, should be an identity value for (_op_). i.e. 0 for sum
+ * @_op_: function or function-like macro: op(accumulator, element) which returns new accumulator value
+ * @_combine_: function or function-like macro: combine(accumulator, accumulator) which merges two partial results
+ *
+ * Each worker reduces it's own arrview into a partial accumulator, which is padded to POOR_CACHE_LINE.
+ * Then partial accumulators are merged pairwise by (_combine_) in a tree, keeping order of arrviews,
+ * so (_op_) and (_combine_) need to be associative, but not commutative.
+ *
+ * example:
+
+	#define add(acc, val) ((acc) + (val))
+
+	uint32_t (*ids)[1 << 28] = get_ids();
+	uint64_t sum = parallel_array_reduce(ids, (uint64_t)0, add, add);
+ */
+#define parallel_array_reduce(_arrm_, _init_, _op_, _combine_) __extension__ ({		\
+	const make_arrview_full(_pred_arrp_, _arrm_);						\
+	const TYPEOF_NO_QUAL(_init_) _pred_init_ = (_init_);					\
+	const size_t _pred_parts_ = h_par_parts(_pred_arrp_);					\
+	struct { _Alignas(POOR_CACHE_LINE) TYPEOF_NO_QUAL(_init_) v; } _pred_part_[_pred_parts_];	\
+												\
+	for(size_t _pred_i_ = 0; _pred_i_ < _pred_parts_; _pred_i_++)				\
+		_pred_part_[_pred_i_].v = _pred_init_;						\
+												\
+	h_foreach_par_av_parts(_pred_view_, _pred_arrp_, _pred_parts_) {			\
+		TYPEOF_NO_QUAL(_init_) _pred_acc_ = _pred_init_;				\
+		h_reduce_loop(_pred_view_, _pred_acc_, _op_);					\
+		_pred_part_[_par_idx_].v = _pred_acc_;						\
+	}											\
+												\
+	for(size_t _pred_step_ = 1; _pred_step_ < _pred_parts_; _pred_step_ *= 2)		\
+		for(size_t _pred_i_ = 0; _pred_i_ + _pred_step_ < _pred_parts_; _pred_i_ += 2 * _pred_step_) \
+			_pred_part_[_pred_i_].v = _combine_(_pred_part_[_pred_i_].v, _pred_part_[_pred_i_ + _pred_step_].v); \
+												\
+	_pred_part_[0].v;									\
+})
+
+/****** Implementation ******/
+
+/* Returns number of arrviews an array pointed by _arrp_ should be split into */
+#define h_par_parts(_arrp_) h_par_parts_fn(UNSAFE_ARRAY_SIZE_BYTES(*(_arrp_)), UNSAFE_ARRAY_SIZE(*(_arrp_)))
+
+static inline size_t h_par_parts_fn(size_t bytes, size_t count) {
+	size_t parts = bytes / POOR_PARALLEL_MIN_BYTES;
+	size_t threads = poor_parallel_threads();
+
+	if(parts > threads)
+		parts = threads;
+	if(parts > count)
+		parts = count;
+
+	return parts ? parts : 1;
+}
+
+/* Returns index of the first element of arrview (part) when array is split into (parts) arrviews */
+#define h_par_split(_arrp_, _parts_, _part_) \
+	h_par_split_fn(_arrp_, UNSAFE_ARRAY_SIZE(*(_arrp_)), UNSAFE_ARRAY_ELEMENT_SIZE(*(_arrp_)), _parts_, _part_)
+
+static inline size_t h_par_split_fn(const void *base, size_t count, size_t el_size, size_t parts, size_t part) {
+	if(!part)
+		return 0;
+	if(part >= parts)
+		return count;
+
+	const size_t bytes = count * el_size;
+	const uintptr_t start = (uintptr_t)base;
+	uintptr_t split = start + (bytes / parts) * part + (bytes % parts) * part / parts;
+	split = (split + POOR_PAGE_SIZE - 1) & ~(uintptr_t)(POOR_PAGE_SIZE - 1);
+
+	const size_t idx = (split - start + el_size - 1) / el_size;
+	return idx < count ? idx : count;
+}
+
+/* foreach_parallel_arrview() implementation.
+ * Arrviews may end up empty after page alignment, such arrviews are skipped.
+ * Index of current arrview is available in loop body as _par_idx_ */
+#define h_foreach_par_av(_name_, _arrp_) h_foreach_par_av_parts(_name_, _arrp_, h_par_parts(_arrp_))
+
+#define h_foreach_par_av_parts(_name_, _arrp_, _parts_)						\
+	for(size_t _par_parts_ = (_parts_), _par_run_ = 1; _par_run_; _par_run_ = 0)			\
+	POOR_OMP(parallel for schedule(static, 1) if(_par_parts_ > 1))					\
+	for(size_t _par_idx_ = 0; _par_idx_ < _par_parts_; _par_idx_++)					\
+	for(size_t _par_begin_ = h_par_split(_arrp_, _par_parts_, _par_idx_),				\
+		   _par_end_ = h_par_split(_arrp_, _par_parts_, _par_idx_ + 1);				\
+		_par_begin_ < _par_end_; _par_begin_ = _par_end_)					\
+	for(unsafe_make_arrptr(_name_, _par_end_ - _par_begin_, _arrp_) =				\
+		(void*)&(*(_arrp_))[_par_begin_]; _name_; _name_ = NULL)
+
+#endif // POOR_PARALLEL_H
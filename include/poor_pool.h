@@ -0,0 +1,329 @@
+// SPDX-License-Identifier: MIT
+/*
+ * Copyright (C) 2020 Alexandrov Stanislav <lightofmysoul@gmail.com>
+ */
+#ifndef POOR_POOL_H
+#define POOR_POOL_H
+
+#include <poor_array.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Pool allocator of fixed size objects.
+ * Objects are carved from slabs, large blocks allocated with malloc(), and free objects are linked
+ * into intrusive lists, stored inside of the free objects themselves.
+ *
+ * Free objects are grouped into magazines, lists of up to POOR_POOL_MAGAZINE objects.
+ * Each thread keeps two magazines for each pool it uses, so pool_alloc() and pool_free()
+ * usually take an object from or put an object into a thread local list, without atomic operations.
+ * When both magazines of a thread are full, one of them is returned to the pool with a single lock-free push.
+ * When both are empty, a magazine is taken from the pool, or a new slab is carved into magazines.
+ * So objects may be freed by any thread, and most recently freed objects, which are hot in cache, are reused first.
+ *
+ * Thread caches are kept in a small table of POOR_POOL_CACHES entries per thread, indexed by pool address.
+ * When two pools share an entry, the cache of the previous pool is returned to it.
+ * Table is static to each translation unit, so caches are not shared between translation units,
+ * which is correct, but less efficient. Wrap pool functions into non-inline functions if a pool is used from many files.
+ *
+ * example:
+
+	typedef char msg_buf[2048];
+
+	poor_pool pool;
+	if(!pool_init(&pool, sizeof(msg_buf), _Alignof(msg_buf)))
+		return;
+
+	msg_buf *buf = pool_alloc_array(&pool, buf);
+	...
+	pool_free(&pool, buf);
+
+	pool_destroy(&pool);
+ */
+
+/* Number of objects in a magazine, which is moved between a thread cache and a pool at once */
+#ifndef POOR_POOL_MAGAZINE
+#define POOR_POOL_MAGAZINE 64
+#endif
+
+/* Minimal size of a slab. A slab contains at least 2 * POOR_POOL_MAGAZINE objects */
+#ifndef POOR_POOL_SLAB_SIZE
+#define POOR_POOL_SLAB_SIZE (64 * 1024)
+#endif
+
+/* Number of thread cache entries per thread */
+#ifndef POOR_POOL_CACHES
+#define POOR_POOL_CACHES 8
+#endif
+
+struct h_pool_obj;
+struct h_pool_slab;
+
+typedef struct poor_pool {
+	size_t obj_size;				/* size of an object, rounded up to alignment */
+	size_t align;					/* alignment of objects */
+	size_t slab_objs;				/* number of objects in a slab */
+	_Atomic(struct h_pool_obj *) magazines;		/* stack of magazines returned by threads */
+	_Atomic(struct h_pool_slab *) slabs;		/* list of all slabs */
+	atomic_flag pop_lock;				/* taken to pop a magazine, pushes don't need it */
+} poor_pool;
+
+/* pool_init(pool, obj_size, align)
+ * Initializes a pool of objects of (obj_size) bytes, aligned to (align), which should be a power of two.
+ * Returns false if parameters are invalid. Memory is allocated only on the first pool_alloc().
+ */
+static inline bool pool_init(poor_pool *pool, size_t obj_size, size_t align);
+
+/* pool_init_array(pool, arrp)
+ * Initializes a pool of arrays of type of *(arrp). Pointer can't be pointer to VLA.
+ */
+#define pool_init_array(_pool_, _arrp_) pool_init(_pool_, sizeof(*(_arrp_)), __alignof__(*(_arrp_)))
+
+/* pool_alloc(pool), pool_free(pool, ptr)
+ * Allocates an object from a pool or returns it to the pool. pool_alloc() returns NULL if memory allocation failed.
+ * pool_free() accepts NULL and objects allocated by any thread.
+ */
+static inline void *pool_alloc(poor_pool *pool);
+static inline void pool_free(poor_pool *pool, void *ptr);
+
+/* pool_alloc_array(pool, arrp), pool_calloc_array(pool, arrp)
+ * Same as malloc_array() and calloc_array(), but array is allocated from a pool.
+ * Size of array should not be greater than size of pool objects. Release the array with pool_free().
+ * example:
+
+	poor_pool pool;
+	pool_init(&pool, 4096, 64);
+	uint32_t (*words)[1024] = pool_alloc_array(&pool, words);
+ */
+#define pool_alloc_array(_pool_, _arrp_) (( _arrp_ = h_pool_alloc_chk("pool_alloc_array()", _pool_, _arrp_) ))
+
+#define pool_calloc_array(_pool_, _arrp_) \
+	(( _arrp_ = h_pool_zero(h_pool_alloc_chk("pool_calloc_array()", _pool_, _arrp_), ARRAY_SIZE_BYTES(_arrp_)) ))
+
+/* pool_thread_flush(pool)
+ * Returns objects cached by the calling thread to the pool.
+ * Every thread which used a pool, except the one calling pool_destroy(), should call it before the pool is destroyed.
+ */
+static inline void pool_thread_flush(poor_pool *pool);
+
+/* pool_destroy(pool)
+ * Releases all memory of a pool. All objects allocated from the pool become invalid.
+ */
+static inline void pool_destroy(poor_pool *pool);
+
+/****** Implementation ******/
+
+/* Free object. Only the first object of a magazine uses next_mag and count */
+struct h_pool_obj {
+	struct h_pool_obj *next;
+	struct h_pool_obj *next_mag;
+	size_t count;
+};
+
+struct h_pool_slab {
+	struct h_pool_slab *next;
+};
+
+/* Thread cache of a pool. (prev) magazine is either full or empty */
+struct h_pool_cache {
+	poor_pool *pool;
+	struct h_pool_obj *loaded;
+	size_t loaded_cnt;
+	struct h_pool_obj *prev;
+};
+
+static inline bool pool_init(poor_pool *pool, size_t obj_size, size_t align) {
+	if(!align || (align & (align - 1)) || !obj_size)
+		return false;
+	if(align < _Alignof(struct h_pool_obj))
+		align = _Alignof(struct h_pool_obj);
+	if(obj_size < sizeof(struct h_pool_obj))
+		obj_size = sizeof(struct h_pool_obj);
+	if(obj_size > (SIZE_MAX - sizeof(struct h_pool_slab) - align) / (2 * POOR_POOL_MAGAZINE))
+		return false;
+
+	pool->obj_size = (obj_size + align - 1) & ~(align - 1);
+	pool->align = align;
+	pool->slab_objs = POOR_POOL_SLAB_SIZE / pool->obj_size;
+	if(pool->slab_objs < 2 * POOR_POOL_MAGAZINE)
+		pool->slab_objs = 2 * POOR_POOL_MAGAZINE;
+
+	atomic_init(&pool->magazines, NULL);
+	atomic_init(&pool->slabs, NULL);
+	atomic_flag_clear(&pool->pop_lock);
+	return true;
+}
+
+/* Pushes a list of (count) objects to the stack of magazines. Lock-free, pushes are safe from ABA problem */
+static inline void h_pool_push(poor_pool *pool, struct h_pool_obj *mag, size_t count) {
+	mag->count = count;
+	struct h_pool_obj *top = atomic_load_explicit(&pool->magazines, memory_order_relaxed);
+	do {
+		mag->next_mag = top;
+	} while(!atomic_compare_exchange_weak_explicit(&pool->magazines, &top, mag,
+		memory_order_release, memory_order_relaxed));
+}
+
+/* Pops a magazine. Pops are serialized by pop_lock, with a single popper a popped object can't be pushed back
+ * before CAS, so there is no ABA problem. Pushes are not blocked by the lock */
+static inline struct h_pool_obj *h_pool_pop(poor_pool *pool) {
+	if(!atomic_load_explicit(&pool->magazines, memory_order_relaxed))
+		return NULL;
+
+	while(atomic_flag_test_and_set_explicit(&pool->pop_lock, memory_order_acquire))
+		;
+
+	struct h_pool_obj *top = atomic_load_explicit(&pool->magazines, memory_order_acquire);
+	while(top && !atomic_compare_exchange_weak_explicit(&pool->magazines, &top, top->next_mag,
+		memory_order_acquire, memory_order_acquire))
+		;
+
+	atomic_flag_clear_explicit(&pool->pop_lock, memory_order_release);
+	return top;
+}
+
+/* Returns both magazines of a thread cache to it's pool */
+static inline void h_pool_cache_flush(struct h_pool_cache *c) {
+	if(c->loaded)
+		h_pool_push(c->pool, c->loaded, c->loaded_cnt);
+	if(c->prev)
+		h_pool_push(c->pool, c->prev, POOR_POOL_MAGAZINE);
+	c->loaded = c->prev = NULL;
+	c->loaded_cnt = 0;
+}
+
+/* Returns thread cache of a pool */
+static inline struct h_pool_cache *h_pool_cache(poor_pool *pool) {
+	static _Thread_local struct h_pool_cache caches[POOR_POOL_CACHES];
+	struct h_pool_cache *const c = &caches[((uintptr_t)pool / sizeof(poor_pool)) % POOR_POOL_CACHES];
+	if(c->pool != pool) {
+		if(c->pool)
+			h_pool_cache_flush(c);
+		c->pool = pool;
+	}
+	return c;
+}
+
+/* Allocates a new slab and carves it into magazines. The first magazine is returned, the rest are pushed to the pool */
+static inline struct h_pool_obj *h_pool_new_slab(poor_pool *pool) {
+	const size_t header = (sizeof(struct h_pool_slab) + pool->align - 1) & ~(pool->align - 1);
+	unsigned char *const raw = malloc(header + pool->slab_objs * pool->obj_size + pool->align);
+	if(!raw)
+		return NULL;
+
+	struct h_pool_slab *const slab = (void*)raw;
+	slab->next = atomic_load_explicit(&pool->slabs, memory_order_relaxed);
+	while(!atomic_compare_exchange_weak_explicit(&pool->slabs, &slab->next, slab,
+		memory_order_release, memory_order_relaxed))
+		;
+
+	unsigned char *const first = (unsigned char*)(((uintptr_t)raw + header + pool->align - 1) & ~(uintptr_t)(pool->align - 1));
+	for(size_t i = 0; i < pool->slab_objs; i++) {
+		struct h_pool_obj *const obj = (void*)&first[i * pool->obj_size];
+		const bool mag_end = (i + 1) % POOR_POOL_MAGAZINE == 0 || i + 1 == pool->slab_objs;
+		obj->next = mag_end ? NULL : (void*)&first[(i + 1) * pool->obj_size];
+	}
+
+	for(size_t i = POOR_POOL_MAGAZINE; i < pool->slab_objs; i += POOR_POOL_MAGAZINE) {
+		const size_t left = pool->slab_objs - i;
+		h_pool_push(pool, (void*)&first[i * pool->obj_size], left < POOR_POOL_MAGAZINE ? left : POOR_POOL_MAGAZINE);
+	}
+	return (void*)first;
+}
+
+/* Fills empty loaded magazine of a thread cache */
+static inline bool h_pool_refill(poor_pool *pool, struct h_pool_cache *c) {
+	if(c->prev) {
+		c->loaded = c->prev;
+		c->loaded_cnt = POOR_POOL_MAGAZINE;
+		c->prev = NULL;
+		return true;
+	}
+
+	struct h_pool_obj *mag = h_pool_pop(pool);
+	if(mag) {
+		c->loaded_cnt = mag->count;
+	} else {
+		mag = h_pool_new_slab(pool);
+		c->loaded_cnt = mag ? POOR_POOL_MAGAZINE : 0;
+	}
+	c->loaded = mag;
+	return mag;
+}
+
+static inline void *pool_alloc(poor_pool *pool) {
+	struct h_pool_cache *const c = h_pool_cache(pool);
+	if(!c->loaded && !h_pool_refill(pool, c))
+		return NULL;
+
+	struct h_pool_obj *const obj = c->loaded;
+	c->loaded = obj->next;
+	c->loaded_cnt--;
+	return obj;
+}
+
+static inline void pool_free(poor_pool *pool, void *ptr) {
+	if(!ptr)
+		return;
+
+	struct h_pool_cache *const c = h_pool_cache(pool);
+	if(c->loaded_cnt == POOR_POOL_MAGAZINE) {
+		if(c->prev)
+			h_pool_push(pool, c->prev, POOR_POOL_MAGAZINE);
+		c->prev = c->loaded;
+		c->loaded = NULL;
+		c->loaded_cnt = 0;
+	}
+
+	struct h_pool_obj *const obj = ptr;
+	obj->next = c->loaded;
+	c->loaded = obj;
+	c->loaded_cnt++;
+}
+
+static inline void pool_thread_flush(poor_pool *pool) {
+	struct h_pool_cache *const c = h_pool_cache(pool);
+	h_pool_cache_flush(c);
+	c->pool = NULL;
+}
+
+static inline void pool_destroy(poor_pool *pool) {
+	struct h_pool_cache *const c = h_pool_cache(pool);
+	c->loaded = c->prev = NULL;
+	c->loaded_cnt = 0;
+	c->pool = NULL;
+
+	for(struct h_pool_slab *slab = atomic_load(&pool->slabs), *next; slab; slab = next) {
+		next = slab->next;
+		free(slab);
+	}
+	atomic_store(&pool->slabs, NULL);
+	atomic_store(&pool->magazines, NULL);
+}
+
+static inline void *h_pool_zero(void *p, size_t size) {
+	return p ? memset(p, 0, size) : p;
+}
+
+/* Allocates an object for an array pointed by (_arrp_), checks that the array fits into the object */
+#define h_pool_alloc_chk(_macro_name_, _pool_, _arrp_) (		\
+	(void)h_pool_chk_sel(_macro_name_, _pool_, _arrp_),		\
+	pool_alloc(_pool_)						\
+)
+
+#define h_pool_chk_sel(_macro_name_, _pool_, _arrp_) \
+	POOR_ARR_CHK_SEL(h_pool_chk_none, h_pool_chk_none, h_pool_chk_dyn)(_macro_name_, _pool_, _arrp_)
+
+#define h_pool_chk_none(...) 0
+#define h_pool_chk_dyn(_macro_name_, _pool_, _arrp_) (						\
+	ARR_ASSERT_MSG(ARRAY_SIZE_BYTES(_arrp_) <= (_pool_)->obj_size &&			\
+		__alignof__(*(_arrp_)) <= (_pool_)->align,					\
+		CRED _macro_name_ ": Array doesn't fit into pool object"			\
+		" (" #_arrp_ " size:", ARRAY_SIZE_BYTES(_arrp_), " align:", __alignof__(*(_arrp_)),	\
+		" object size:", (_pool_)->obj_size, " align:", (_pool_)->align, ")"		\
+		" at " FILE_AND_LINE CRESET), 0)
+
+#endif // POOR_POOL_H
@@ -0,0 +1,930 @@
+// SPDX-License-Identifier: MIT
+/*
+ * Copyright (C) 2020 Alexandrov Stanislav <lightofmysoul@gmail.com>
+ */
+#ifndef POOR_ROARING_H
+#define POOR_ROARING_H
+
+#include <poor_array.h>
+#include <poor_common.h>
+#include <poor_bits.h>
+#include <poor_search.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Compressed bitmap of 32-bit values, in the same layout as Roaring bitmaps.
+ * Value space is split into chunks of 65536 values by the high 16 bits of a value, and each non-empty chunk
+ * is stored in a container, which holds the low 16 bits of its values in one of three forms:
+ *	ROARING_ARRAY:  sorted array of up to ROARING_ARRAY_MAX uint16_t values
+ *	ROARING_BITSET: bitset of 65536 bits, uint64_t[1024], handled by poor_bits.h macros
+ *	ROARING_RUN:    sorted array of runs [first, last], created by roaring_run_optimize()
+ * Containers are kept sorted by their key, the high 16 bits.
+ *
+ * Zero-initialized roaring_bitmap is an empty bitmap, roaring_free() releases memory of a bitmap.
+ * Functions which allocate memory return false if allocation failed, bitmap stays valid in that case.
+ */
+enum { ROARING_ARRAY, ROARING_BITSET, ROARING_RUN };
+
+/* Maximum number of values in array container, larger containers are stored as bitsets */
+#define ROARING_ARRAY_MAX 4096
+#define ROARING_BITSET_WORDS 1024
+
+typedef struct roaring_container {
+	uint16_t key;		/* high 16 bits of all values in the container */
+	uint8_t type;		/* ROARING_ARRAY, ROARING_BITSET or ROARING_RUN */
+	uint32_t card;		/* number of values in the container */
+	uint32_t n;		/* number of array elements or runs, unused for bitsets */
+	uint32_t cap;		/* allocated number of array elements or runs */
+	union {
+		void *data;
+		uint16_t *array;
+		uint64_t (*bitset)[ROARING_BITSET_WORDS];
+		uint16_t (*runs)[2];
+	};
+} roaring_container;
+
+typedef struct roaring_bitmap {
+	roaring_container *c;	/* containers sorted by key */
+	uint32_t count;		/* number of containers */
+	uint32_t cap;		/* allocated number of containers */
+} roaring_bitmap;
+
+/* Releases memory of a bitmap and makes it empty */
+static inline void roaring_free(roaring_bitmap *rb);
+
+/* roaring_add(rb, val), roaring_remove(rb, val)
+ * Adds value to or removes value from a bitmap. Returns false if memory allocation failed.
+ * Array container becomes a bitset when it grows over ROARING_ARRAY_MAX values, and bitset becomes an array
+ * when it shrinks to ROARING_ARRAY_MAX values. Run containers are converted to array or bitset before they are changed.
+ */
+static inline bool roaring_add(roaring_bitmap *rb, uint32_t val);
+static inline bool roaring_remove(roaring_bitmap *rb, uint32_t val);
+
+/* Returns true if bitmap contains the value */
+static inline bool roaring_contains(const roaring_bitmap *rb, uint32_t val);
+
+/* Returns number of values in a bitmap */
+static inline uint64_t roaring_cardinality(const roaring_bitmap *rb);
+
+/* roaring_and(dst, a, b): dst = a & b
+ * roaring_or(dst, a, b): dst = a | b
+ * Computes intersection or union of two bitmaps. Previous content of (dst) is released, (dst) may be the same bitmap as (a) or (b).
+ * Returns false if memory allocation failed, (dst) is not changed in that case.
+ *
+ * Intersection of two arrays compares each value of the smaller array with a vector of values of the larger one,
+ * or uses galloping search if one array is much smaller. Bitsets are combined with array_bits_and() and array_bits_or()
+ * and counted with array_popcount(). Run containers are expanded to arrays or bitsets before they are combined
+ * with another container.
+ */
+static inline bool roaring_and(roaring_bitmap *dst, const roaring_bitmap *a, const roaring_bitmap *b);
+static inline bool roaring_or(roaring_bitmap *dst, const roaring_bitmap *a, const roaring_bitmap *b);
+
+/* Converts containers to run containers, when runs take less memory. Returns false if memory allocation failed */
+static inline bool roaring_run_optimize(roaring_bitmap *rb);
+
+/* roaring_serialized_size(rb), roaring_serialize(rb, buf), roaring_deserialize(rb, buf, size)
+ * Bitmaps are serialized in the portable Roaring format, which is readable by other Roaring implementations.
+ * roaring_serialize() writes roaring_serialized_size() bytes to (buf) and returns number of written bytes.
+ * roaring_deserialize() replaces content of (rb) with bitmap read from (buf) of (size) bytes.
+ * It returns false if data is malformed or memory allocation failed, (rb) is not changed in that case.
+ */
+static inline size_t roaring_serialized_size(const roaring_bitmap *rb);
+static inline size_t roaring_serialize(const roaring_bitmap *rb, void *buf);
+static inline bool roaring_deserialize(roaring_bitmap *rb, const void *buf, size_t size);
+
+/* roaring_add_array(rb, _arrm_)
+ * Adds all values of an array to a bitmap. Returns false if memory allocation failed
+ * @_arrm_: an array or a pointer to an array of integers
+ */
+#define roaring_add_array(_rb_, _arrm_) __extension__ ({	\
+	roaring_bitmap *const _raa_rb_ = (_rb_);		\
+	bool _raa_ok_ = true;					\
+	foreach_array_const_ref(_arrm_, _raa_ref_)		\
+		if(!(_raa_ok_ = roaring_add(_raa_rb_, (uint32_t)*_raa_ref_)))	\
+			break;					\
+	_raa_ok_;						\
+})
+
+/* foreach_roaring(rb, _val_name_)
+ * Iterates over values of a bitmap in ascending order.
+ * @rb: pointer to roaring_bitmap, bitmap should not be changed in the loop
+ * @_val_name_: name of uint32_t variable, which will contain current value
+ *
+ * Bitset containers are iterated with the same code as foreach_array_set_bit()
+ * break and continue can be used in the loop body.
+ *
+ * example:
+
+	roaring_bitmap rb = {0};
+	roaring_add(&rb, 7);
+	roaring_add(&rb, 1 << 20);
+	foreach_roaring(&rb, val)
+		print(val, " "); //prints: 7 1048576
+	roaring_free(&rb);
+ */
+#define foreach_roaring(_rb_, _val_name_)							\
+	for(h_roar_iter _rit_ = h_roar_iter_init(_rb_), *_rit_once_ = &_rit_; _rit_once_; _rit_once_ = NULL)	\
+	for(uint32_t _val_name_; h_roar_next(&_rit_, &_val_name_);)
+
+/****** Implementation ******/
+
+#define h_roar_key_less(_c_, _key_) ((_c_).key < (_key_))
+
+/* Returns index of the first container with key not less than (key) */
+static inline uint32_t h_roar_lower(const roaring_bitmap *rb, uint16_t key) {
+	if(!rb->count)
+		return 0;
+	const roaring_container (*cs)[rb->count] = (const void *)rb->c;
+	return (uint32_t)array_ref_index(cs, array_lower_bound_by(cs, key, h_roar_key_less));
+}
+
+/* Returns index of the first element of sorted uint16_t array, which is not less than (val) */
+static inline uint32_t h_roar_lower16(const uint16_t *a, uint32_t n, uint16_t val) {
+	if(!n)
+		return 0;
+	const uint16_t (*arr)[n] = (const void *)a;
+	return (uint32_t)array_ref_index(arr, array_lower_bound(arr, val));
+}
+
+/* Returns number of values in runs */
+static inline uint32_t h_roar_runs_card(const uint16_t (*runs)[2], uint32_t n) {
+	uint32_t card = 0;
+	for(uint32_t i = 0; i < n; i++)
+		card += (uint32_t)runs[i][1] - runs[i][0] + 1;
+	return card;
+}
+
+static inline void h_roar_free_container(roaring_container *c) {
+	free(c->data);
+	c->data = NULL;
+}
+
+static inline void roaring_free(roaring_bitmap *rb) {
+	for(uint32_t i = 0; i < rb->count; i++)
+		h_roar_free_container(&rb->c[i]);
+	free(rb->c);
+	*rb = (roaring_bitmap){0};
+}
+
+/* Makes room for (n) values in array container */
+static inline bool h_roar_reserve(roaring_container *c, uint32_t n) {
+	if(n <= c->cap)
+		return true;
+
+	uint32_t cap = c->cap < 4 ? 4 : c->cap * 2;
+	if(cap < n)
+		cap = n;
+	if(cap > ROARING_ARRAY_MAX)
+		cap = ROARING_ARRAY_MAX;
+
+	uint16_t *a = realloc(c->array, cap * sizeof(*a));
+	if(!a)
+		return false;
+	c->array = a;
+	c->cap = cap;
+	return true;
+}
+
+/* Container conversions. On allocation failure container is not changed */
+static inline bool h_roar_to_bitset(roaring_container *c) {
+	uint64_t (*bs)[ROARING_BITSET_WORDS] = calloc(1, sizeof(*bs));
+	if(!bs)
+		return false;
+
+	if(c->type == ROARING_ARRAY)
+		for(uint32_t i = 0; i < c->n; i++)
+			array_set_bit(bs, c->array[i]);
+	else if(c->type == ROARING_RUN)
+		for(uint32_t i = 0; i < c->n; i++)
+			array_set_bit_range(bs, c->runs[i][0], (size_t)c->runs[i][1] + 1);
+	else
+		return free(bs), true;
+
+	free(c->data);
+	c->bitset = bs;
+	c->type = ROARING_BITSET;
+	c->n = c->cap = 0;
+	return true;
+}
+
+static inline bool h_roar_to_array(roaring_container *c) {
+	if(c->type == ROARING_ARRAY)
+		return true;
+
+	const uint32_t cap = c->card < 4 ? 4 : c->card;
+	uint16_t *a = malloc(cap * sizeof(*a));
+	if(!a)
+		return false;
+
+	uint32_t n = 0;
+	if(c->type == ROARING_BITSET)
+		foreach_array_set_bit(c->bitset, bit)
+			a[n++] = (uint16_t)bit;
+	else
+		for(uint32_t i = 0; i < c->n; i++)
+			for(uint32_t v = c->runs[i][0]; v <= c->runs[i][1]; v++)
+				a[n++] = (uint16_t)v;
+
+	free(c->data);
+	c->array = a;
+	c->type = ROARING_ARRAY;
+	c->n = n;
+	c->cap = cap;
+	return true;
+}
+
+/* Converts run container into array or bitset, depending on number of values */
+static inline bool h_roar_unrun(roaring_container *c) {
+	if(c->type != ROARING_RUN)
+		return true;
+	return c->card > ROARING_ARRAY_MAX ? h_roar_to_bitset(c) : h_roar_to_array(c);
+}
+
+/* Counts runs in array or bitset container */
+static inline uint32_t h_roar_count_runs(const roaring_container *c) {
+	uint32_t runs = 0;
+	if(c->type == ROARING_ARRAY) {
+		for(uint32_t i = 0; i < c->n; i++)
+			runs += !i || c->array[i] != c->array[i - 1] + 1;
+	} else if(c->type == ROARING_BITSET) {
+		uint64_t carry = 0;
+		for(size_t i = 0; i < ROARING_BITSET_WORDS; i++) {
+			const uint64_t w = (*c->bitset)[i];
+			runs += (uint32_t)h_bits_popcount64(w & ~((w << 1) | carry));
+			carry = w >> 63;
+		}
+	} else {
+		runs = c->n;
+	}
+	return runs;
+}
+
+static inline bool h_roar_to_runs(roaring_container *c, uint32_t nruns) {
+	uint16_t (*runs)[2] = malloc((nruns ? nruns : 1) * sizeof(*runs));
+	if(!runs)
+		return false;
+
+	uint32_t n = 0;
+	if(c->type == ROARING_ARRAY) {
+		for(uint32_t i = 0; i < c->n; i++) {
+			if(n && c->array[i] == runs[n - 1][1] + 1)
+				runs[n - 1][1] = c->array[i];
+			else
+				runs[n][0] = runs[n][1] = c->array[i], n++;
+		}
+	} else {
+		/* Runs of ones are found with one count trailing zeros per run border */
+		const uint64_t *const w = *c->bitset;
+		size_t i = 0;
+		uint64_t cur = w[0];
+		for(;;) {
+			while(!cur && i < ROARING_BITSET_WORDS - 1)
+				cur = w[++i];
+			if(!cur)
+				break;
+			const size_t first = i * 64 + h_bits_ctz(cur);
+			uint64_t ones = cur | (cur - 1);
+			while(ones == UINT64_MAX && i < ROARING_BITSET_WORDS - 1)
+				ones = w[++i];
+			if(ones == UINT64_MAX) {
+				runs[n][0] = (uint16_t)first, runs[n++][1] = UINT16_MAX;
+				break;
+			}
+			runs[n][0] = (uint16_t)first, runs[n++][1] = (uint16_t)(i * 64 + h_bits_ctz(~ones) - 1);
+			cur = ones & (ones + 1);
+		}
+	}
+
+	free(c->data);
+	c->runs = runs;
+	c->type = ROARING_RUN;
+	c->n = c->cap = n;
+	return true;
+}
+
+/* Converts array with too many values into bitset and bitset with few values into array */
+static inline void h_roar_normalize(roaring_container *c) {
+	if(c->type == ROARING_ARRAY && c->card > ROARING_ARRAY_MAX)
+		(void)h_roar_to_bitset(c);
+	else if(c->type == ROARING_BITSET && c->card <= ROARING_ARRAY_MAX)
+		(void)h_roar_to_array(c);
+}
+
+/* Inserts empty array container with (key) at index (idx) */
+static inline roaring_container *h_roar_insert(roaring_bitmap *rb, uint32_t idx, uint16_t key) {
+	if(rb->count == rb->cap) {
+		const uint32_t cap = rb->cap ? rb->cap * 2 : 4;
+		roaring_container *cs = realloc(rb->c, cap * sizeof(*cs));
+		if(!cs)
+			return NULL;
+		rb->c = cs;
+		rb->cap = cap;
+	}
+	memmove(&rb->c[idx + 1], &rb->c[idx], (rb->count - idx) * sizeof(*rb->c));
+	rb->count++;
+	rb->c[idx] = (roaring_container){.key = key, .type = ROARING_ARRAY};
+	return &rb->c[idx];
+}
+
+static inline void h_roar_erase(roaring_bitmap *rb, uint32_t idx) {
+	h_roar_free_container(&rb->c[idx]);
+	memmove(&rb->c[idx], &rb->c[idx + 1], (rb->count - idx - 1) * sizeof(*rb->c));
+	rb->count--;
+}
+
+static inline bool roaring_add(roaring_bitmap *rb, uint32_t val) {
+	const uint16_t key = (uint16_t)(val >> 16), low = (uint16_t)val;
+	const uint32_t idx = h_roar_lower(rb, key);
+	roaring_container *c = idx < rb->count && rb->c[idx].key == key ? &rb->c[idx] : NULL;
+	if(!c) {
+		c = h_roar_insert(rb, idx, key);
+		if(!c)
+			return false;
+		if(!h_roar_reserve(c, 1))
+			return h_roar_erase(rb, idx), false;
+	}
+
+	if(c->type == ROARING_RUN) {
+		if(roaring_contains(rb, val))
+			return true;
+		if(!h_roar_unrun(c))
+			return false;
+	}
+
+	if(c->type == ROARING_ARRAY) {
+		const uint32_t pos = h_roar_lower16(c->array, c->n, low);
+		if(pos < c->n && c->array[pos] == low)
+			return true;
+		if(c->n == ROARING_ARRAY_MAX) {
+			if(!h_roar_to_bitset(c))
+				return false;
+		} else {
+			if(!h_roar_reserve(c, c->n + 1))
+				return false;
+			memmove(&c->array[pos + 1], &c->array[pos], (c->n - pos) * sizeof(*c->array));
+			c->array[pos] = low;
+			c->n++;
+			c->card++;
+			return true;
+		}
+	}
+
+	if(!array_get_bit(c->bitset, low)) {
+		array_set_bit(c->bitset, low);
+		c->card++;
+	}
+	return true;
+}
+
+static inline bool roaring_remove(roaring_bitmap *rb, uint32_t val) {
+	const uint16_t key = (uint16_t)(val >> 16), low = (uint16_t)val;
+	const uint32_t idx = h_roar_lower(rb, key);
+	if(idx >= rb->count || rb->c[idx].key != key || !roaring_contains(rb, val))
+		return true;
+
+	roaring_container *const c = &rb->c[idx];
+	if(c->card == 1)
+		return h_roar_erase(rb, idx), true;
+	if(!h_roar_unrun(c))
+		return false;
+
+	if(c->type == ROARING_ARRAY) {
+		const uint32_t pos = h_roar_lower16(c->array, c->n, low);
+		memmove(&c->array[pos], &c->array[pos + 1], (c->n - pos - 1) * sizeof(*c->array));
+		c->n--;
+	} else {
+		array_unset_bit(c->bitset, low);
+	}
+	c->card--;
+	h_roar_normalize(c);
+	return true;
+}
+
+static inline bool roaring_contains(const roaring_bitmap *rb, uint32_t val) {
+	const uint16_t key = (uint16_t)(val >> 16), low = (uint16_t)val;
+	const uint32_t idx = h_roar_lower(rb, key);
+	if(idx >= rb->count || rb->c[idx].key != key)
+		return false;
+
+	const roaring_container *const c = &rb->c[idx];
+	switch(c->type) {
+	case ROARING_ARRAY: {
+		const uint32_t pos = h_roar_lower16(c->array, c->n, low);
+		return pos < c->n && c->array[pos] == low;
+	}
+	case ROARING_BITSET:
+		return array_get_bit(c->bitset, low);
+	default: {
+		/* the last run which starts not after low */
+		uint32_t lo = 0, hi = c->n;
+		while(lo < hi) {
+			const uint32_t mid = lo + (hi - lo) / 2;
+			if(c->runs[mid][0] <= low)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		return lo && low <= c->runs[lo - 1][1];
+	}
+	}
+}
+
+static inline uint64_t roaring_cardinality(const roaring_bitmap *rb) {
+	uint64_t card = 0;
+	for(uint32_t i = 0; i < rb->count; i++)
+		card += rb->c[i].card;
+	return card;
+}
+
+/* Deep copy of a container, run containers are expanded */
+static inline bool h_roar_clone(roaring_container *dst, const roaring_container *src, bool unrun) {
+	*dst = *src;
+	const size_t bytes = src->type == ROARING_ARRAY ? src->n * sizeof(*src->array) :
+			     src->type == ROARING_RUN ? src->n * sizeof(*src->runs) : sizeof(*src->bitset);
+	dst->data = malloc(bytes ? bytes : 1);
+	if(!dst->data)
+		return false;
+	memcpy(dst->data, src->data, bytes);
+	dst->cap = dst->n;
+	if(unrun && !h_roar_unrun(dst))
+		return h_roar_free_container(dst), false;
+	return true;
+}
+
+/* Number of uint16_t values compared at once by array intersection */
+#define h_roar_lanes (POOR_SIMD_BYTES / sizeof(uint16_t))
+
+/* Intersection of sorted arrays, (a) should not be larger than (b). Returns number of values written to (out) */
+static inline uint32_t h_roar_intersect16(const uint16_t *a, uint32_t na, const uint16_t *b, uint32_t nb, uint16_t *out) {
+	uint32_t i = 0, j = 0, k = 0;
+	if(na * 64 < nb) {
+		/* galloping: each value of a small array is searched in the rest of a large array */
+		for(; i < na && j < nb; i++) {
+			uint32_t step = 1;
+			while(j + step < nb && b[j + step] < a[i])
+				step *= 2;
+			const uint32_t end = j + step < nb ? j + step + 1 : nb;
+			j += h_roar_lower16(&b[j], end - j, a[i]);
+			if(j < nb && b[j] == a[i])
+				out[k++] = a[i];
+		}
+		return k;
+	}
+
+#if defined __GNUC__ || defined __clang__
+	/* each value of (a) is compared with a block of h_roar_lanes values of (b) which may contain it */
+	typedef uint16_t h_roar_vec __attribute__((vector_size(POOR_SIMD_BYTES)));
+	for(; i < na; i++) {
+		const uint16_t v = a[i];
+		while(j + h_roar_lanes <= nb && b[j + h_roar_lanes - 1] < v)
+			j += h_roar_lanes;
+		if(j + h_roar_lanes > nb)
+			break;
+
+		h_roar_vec vb;
+		memcpy(&vb, &b[j], sizeof(vb));
+		const h_roar_vec eq = (h_roar_vec)(vb == v);
+		uint64_t w[POOR_SIMD_BYTES / 8], any = 0;
+		memcpy(w, &eq, sizeof(w));
+		for(size_t m = 0; m < POOR_SIMD_BYTES / 8; m++)
+			any |= w[m];
+		if(any)
+			out[k++] = v;
+	}
+#endif
+	while(i < na && j < nb) {
+		if(a[i] < b[j])
+			i++;
+		else if(b[j] < a[i])
+			j++;
+		else
+			out[k++] = a[i], i++, j++;
+	}
+	return k;
+}
+
+/* Intersection of two array or bitset containers with the same key. Result may be empty */
+static inline bool h_roar_and_container(roaring_container *out, const roaring_container *x, const roaring_container *y) {
+	if(x->type == ROARING_BITSET && y->type == ROARING_ARRAY) {
+		const roaring_container *const t = x;
+		x = y;
+		y = t;
+	}
+
+	*out = (roaring_container){.key = x->key, .type = ROARING_ARRAY};
+	if(x->type == ROARING_ARRAY) {
+		const uint32_t cap = x->card < y->card ? x->card : y->card;
+		if(!h_roar_reserve(out, cap ? cap : 1))
+			return false;
+		if(y->type == ROARING_ARRAY) {
+			out->n = x->n <= y->n ? h_roar_intersect16(x->array, x->n, y->array, y->n, out->array) :
+						h_roar_intersect16(y->array, y->n, x->array, x->n, out->array);
+		} else {
+			for(uint32_t i = 0; i < x->n; i++) {
+				out->array[out->n] = x->array[i];
+				out->n += array_get_bit(y->bitset, x->array[i]);
+			}
+		}
+		out->card = out->n;
+		return true;
+	}
+
+	out->type = ROARING_BITSET;
+	out->bitset = malloc(sizeof(*out->bitset));
+	if(!out->bitset)
+		return false;
+	array_bits_and(out->bitset, x->bitset, y->bitset);
+	out->card = (uint32_t)array_popcount(out->bitset);
+	h_roar_normalize(out);
+	return true;
+}
+
+/* Union of two array or bitset containers with the same key */
+static inline bool h_roar_or_container(roaring_container *out, const roaring_container *x, const roaring_container *y) {
+	if(x->type == ROARING_BITSET && y->type == ROARING_ARRAY) {
+		const roaring_container *const t = x;
+		x = y;
+		y = t;
+	}
+
+	*out = (roaring_container){.key = x->key, .type = ROARING_ARRAY};
+	if(x->type == ROARING_ARRAY && y->type == ROARING_ARRAY && x->n + y->n <= ROARING_ARRAY_MAX) {
+		if(!h_roar_reserve(out, x->n + y->n))
+			return false;
+		uint32_t i = 0, j = 0;
+		while(i < x->n && j < y->n) {
+			const uint16_t a = x->array[i], b = y->array[j];
+			out->array[out->n++] = a < b ? a : b;
+			i += a <= b;
+			j += b <= a;
+		}
+		while(i < x->n)
+			out->array[out->n++] = x->array[i++];
+		while(j < y->n)
+			out->array[out->n++] = y->array[j++];
+		out->card = out->n;
+		return true;
+	}
+
+	out->type = ROARING_BITSET;
+	out->bitset = calloc(1, sizeof(*out->bitset));
+	if(!out->bitset)
+		return false;
+	if(y->type == ROARING_BITSET) {
+		if(x->type == ROARING_BITSET)
+			array_bits_or(out->bitset, x->bitset, y->bitset);
+		else
+			copy_array(out->bitset, y->bitset);
+	}
+	if(x->type == ROARING_ARRAY)
+		for(uint32_t i = 0; i < x->n; i++)
+			array_set_bit(out->bitset, x->array[i]);
+	if(y->type == ROARING_ARRAY)
+		for(uint32_t i = 0; i < y->n; i++)
+			array_set_bit(out->bitset, y->array[i]);
+	out->card = (uint32_t)array_popcount(out->bitset);
+	h_roar_normalize(out);
+	return true;
+}
+
+/* Appends container to a bitmap being built, frees container on failure */
+static inline bool h_roar_append(roaring_bitmap *rb, roaring_container *c) {
+	if(!c->card)
+		return h_roar_free_container(c), true;
+	roaring_container *const slot = h_roar_insert(rb, rb->count, c->key);
+	if(!slot)
+		return h_roar_free_container(c), false;
+	*slot = *c;
+	return true;
+}
+
+/* Applies container operation to containers with the same key, for roaring_or() also copies other containers */
+static inline bool h_roar_merge(roaring_bitmap *dst, const roaring_bitmap *a, const roaring_bitmap *b, bool is_or) {
+	roaring_bitmap res = {0};
+	uint32_t i = 0, j = 0;
+	bool ok = true;
+	while(ok && (i < a->count || j < b->count)) {
+		roaring_container out;
+		if(j >= b->count || (i < a->count && a->c[i].key < b->c[j].key)) {
+			if(!is_or) {
+				i++;
+				continue;
+			}
+			ok = h_roar_clone(&out, &a->c[i++], false) && h_roar_append(&res, &out);
+		} else if(i >= a->count || b->c[j].key < a->c[i].key) {
+			if(!is_or) {
+				j++;
+				continue;
+			}
+			ok = h_roar_clone(&out, &b->c[j++], false) && h_roar_append(&res, &out);
+		} else {
+			roaring_container x, y;
+			const roaring_container *px = &a->c[i++], *py = &b->c[j++];
+			bool tx = false, ty = false;
+			if(px->type == ROARING_RUN) {
+				ok = tx = h_roar_clone(&x, px, true);
+				px = &x;
+			}
+			if(ok && py->type == ROARING_RUN) {
+				ok = ty = h_roar_clone(&y, py, true);
+				py = &y;
+			}
+			if(ok)
+				ok = (is_or ? h_roar_or_container(&out, px, py) : h_roar_and_container(&out, px, py)) &&
+					h_roar_append(&res, &out);
+			if(tx)
+				h_roar_free_container(&x);
+			if(ty)
+				h_roar_free_container(&y);
+		}
+	}
+
+	if(!ok)
+		return roaring_free(&res), false;
+	roaring_free(dst);
+	*dst = res;
+	return true;
+}
+
+static inline bool roaring_and(roaring_bitmap *dst, const roaring_bitmap *a, const roaring_bitmap *b) {
+	return h_roar_merge(dst, a, b, false);
+}
+
+static inline bool roaring_or(roaring_bitmap *dst, const roaring_bitmap *a, const roaring_bitmap *b) {
+	return h_roar_merge(dst, a, b, true);
+}
+
+static inline bool roaring_run_optimize(roaring_bitmap *rb) {
+	for(uint32_t i = 0; i < rb->count; i++) {
+		roaring_container *const c = &rb->c[i];
+		if(c->type == ROARING_RUN)
+			continue;
+		const uint32_t runs = h_roar_count_runs(c);
+		const size_t size = c->type == ROARING_ARRAY ? c->card * 2 : sizeof(*c->bitset);
+		if(2 + runs * 4 < size && !h_roar_to_runs(c, runs))
+			return false;
+	}
+	return true;
+}
+
+/* Portable serialization format */
+#define h_roar_cookie_no_runs 12346
+#define h_roar_cookie_runs 12347
+#define h_roar_no_offset_threshold 4
+
+static inline void h_roar_put16(unsigned char **p, uint16_t v) {
+	(*p)[0] = (unsigned char)v;
+	(*p)[1] = (unsigned char)(v >> 8);
+	*p += 2;
+}
+
+static inline void h_roar_put32(unsigned char **p, uint32_t v) {
+	h_roar_put16(p, (uint16_t)v);
+	h_roar_put16(p, (uint16_t)(v >> 16));
+}
+
+static inline uint16_t h_roar_get16(const unsigned char *p) {
+	return (uint16_t)(p[0] | p[1] << 8);
+}
+
+static inline uint32_t h_roar_get32(const unsigned char *p) {
+	return h_roar_get16(p) | (uint32_t)h_roar_get16(p + 2) << 16;
+}
+
+static inline bool h_roar_has_runs(const roaring_bitmap *rb) {
+	for(uint32_t i = 0; i < rb->count; i++)
+		if(rb->c[i].type == ROARING_RUN)
+			return true;
+	return false;
+}
+
+/* Containers without runs are written as arrays or bitsets depending only on cardinality */
+static inline size_t h_roar_container_bytes(const roaring_container *c) {
+	return c->type == ROARING_RUN ? 2 + (size_t)c->n * 4 :
+	       c->card <= ROARING_ARRAY_MAX ? (size_t)c->card * 2 : ROARING_BITSET_WORDS * 8;
+}
+
+/* Size of header: cookie, run flags, keys with cardinalities and offsets */
+static inline size_t h_roar_header_bytes(const roaring_bitmap *rb) {
+	const bool runs = h_roar_has_runs(rb);
+	size_t size = runs ? 4 + (rb->count + 7) / 8 : 8;
+	size += (size_t)rb->count * 4;
+	if(!runs || rb->count >= h_roar_no_offset_threshold)
+		size += (size_t)rb->count * 4;
+	return size;
+}
+
+static inline size_t roaring_serialized_size(const roaring_bitmap *rb) {
+	size_t size = h_roar_header_bytes(rb);
+	for(uint32_t i = 0; i < rb->count; i++)
+		size += h_roar_container_bytes(&rb->c[i]);
+	return size;
+}
+
+static inline size_t roaring_serialize(const roaring_bitmap *rb, void *buf) {
+	unsigned char *p = buf;
+	const bool runs = h_roar_has_runs(rb);
+	if(runs) {
+		h_roar_put32(&p, h_roar_cookie_runs | (rb->count - 1) << 16);
+		memset(p, 0, (rb->count + 7) / 8);
+		for(uint32_t i = 0; i < rb->count; i++)
+			p[i / 8] |= (unsigned char)((rb->c[i].type == ROARING_RUN) << (i % 8));
+		p += (rb->count + 7) / 8;
+	} else {
+		h_roar_put32(&p, h_roar_cookie_no_runs);
+		h_roar_put32(&p, rb->count);
+	}
+
+	for(uint32_t i = 0; i < rb->count; i++) {
+		h_roar_put16(&p, rb->c[i].key);
+		h_roar_put16(&p, (uint16_t)(rb->c[i].card - 1));
+	}
+
+	if(!runs || rb->count >= h_roar_no_offset_threshold) {
+		size_t offset = h_roar_header_bytes(rb);
+		for(uint32_t i = 0; i < rb->count; i++) {
+			h_roar_put32(&p, (uint32_t)offset);
+			offset += h_roar_container_bytes(&rb->c[i]);
+		}
+	}
+
+	for(uint32_t i = 0; i < rb->count; i++) {
+		const roaring_container *const c = &rb->c[i];
+		if(c->type == ROARING_RUN) {
+			h_roar_put16(&p, (uint16_t)c->n);
+			for(uint32_t k = 0; k < c->n; k++) {
+				h_roar_put16(&p, c->runs[k][0]);
+				h_roar_put16(&p, (uint16_t)(c->runs[k][1] - c->runs[k][0]));
+			}
+		} else if(c->card <= ROARING_ARRAY_MAX) {
+			if(c->type == ROARING_ARRAY)
+				for(uint32_t k = 0; k < c->n; k++)
+					h_roar_put16(&p, c->array[k]);
+			else
+				foreach_array_set_bit(c->bitset, bit)
+					h_roar_put16(&p, (uint16_t)bit);
+		} else {
+			uint64_t words[ROARING_BITSET_WORDS] = {0};
+			if(c->type == ROARING_ARRAY)
+				for(uint32_t k = 0; k < c->n; k++)
+					array_set_bit(words, c->array[k]);
+			else
+				copy_array(words, c->bitset);
+			for(size_t k = 0; k < ROARING_BITSET_WORDS; k++) {
+				h_roar_put32(&p, (uint32_t)words[k]);
+				h_roar_put32(&p, (uint32_t)(words[k] >> 32));
+			}
+		}
+	}
+	return (size_t)(p - (unsigned char *)buf);
+}
+
+/* Reads one container from (p), checks that values are sorted and match cardinality from header */
+static inline bool h_roar_read_container(roaring_container *c, const unsigned char **pp, const unsigned char *end) {
+	const unsigned char *p = *pp;
+	if(c->type == ROARING_RUN) {
+		if(end - p < 2)
+			return false;
+		const uint32_t n = h_roar_get16(p);
+		p += 2;
+		if((size_t)(end - p) < (size_t)n * 4 || !(c->runs = malloc((n ? n : 1) * sizeof(*c->runs))))
+			return false;
+		for(uint32_t k = 0; k < n; k++, p += 4) {
+			const uint32_t first = h_roar_get16(p), last = first + h_roar_get16(p + 2);
+			if(last > UINT16_MAX || (k && first <= (uint32_t)c->runs[k - 1][1] + 1))
+				return false;
+			c->runs[k][0] = (uint16_t)first;
+			c->runs[k][1] = (uint16_t)last;
+		}
+		c->n = c->cap = n;
+		*pp = p;
+		return h_roar_runs_card((const uint16_t (*)[2])c->runs, n) == c->card;
+	}
+
+	if(c->card <= ROARING_ARRAY_MAX) {
+		c->type = ROARING_ARRAY;
+		if((size_t)(end - p) < (size_t)c->card * 2 || !(c->array = malloc(c->card * sizeof(*c->array))))
+			return false;
+		for(uint32_t k = 0; k < c->card; k++, p += 2) {
+			c->array[k] = h_roar_get16(p);
+			if(k && c->array[k] <= c->array[k - 1])
+				return false;
+		}
+		c->n = c->cap = c->card;
+	} else {
+		c->type = ROARING_BITSET;
+		if(end - p < ROARING_BITSET_WORDS * 8 || !(c->bitset = malloc(sizeof(*c->bitset))))
+			return false;
+		for(size_t k = 0; k < ROARING_BITSET_WORDS; k++, p += 8)
+			(*c->bitset)[k] = h_roar_get32(p) | (uint64_t)h_roar_get32(p + 4) << 32;
+		if(array_popcount(c->bitset) != c->card)
+			return false;
+	}
+	*pp = p;
+	return true;
+}
+
+static inline bool roaring_deserialize(roaring_bitmap *rb, const void *buf, size_t size) {
+	const unsigned char *p = buf, *const end = p + size;
+	if(size < 4)
+		return false;
+
+	const uint32_t cookie = h_roar_get32(p);
+	uint32_t count;
+	const unsigned char *run_flags = NULL;
+	p += 4;
+	if((cookie & 0xffff) == h_roar_cookie_runs) {
+		count = (cookie >> 16) + 1;
+		run_flags = p;
+		p += (count + 7) / 8;
+	} else if(cookie == h_roar_cookie_no_runs) {
+		if(size < 8)
+			return false;
+		count = h_roar_get32(p);
+		p += 4;
+	} else {
+		return false;
+	}
+	if(count > 1 << 16 || p > end || (size_t)(end - p) < (size_t)count * 4)
+		return false;
+
+	roaring_bitmap res = {0};
+	if(count && !(res.c = calloc(count, sizeof(*res.c))))
+		return false;
+	res.cap = count;
+
+	const unsigned char *const keys = p;
+	p += (size_t)count * 4;
+	if(!run_flags || count >= h_roar_no_offset_threshold)
+		p += (size_t)count * 4;
+	if(p > end)
+		return roaring_free(&res), false;
+
+	for(uint32_t i = 0; i < count; i++) {
+		roaring_container *const c = &res.c[i];
+		c->key = h_roar_get16(&keys[i * 4]);
+		c->card = (uint32_t)h_roar_get16(&keys[i * 4 + 2]) + 1;
+		c->type = run_flags && (run_flags[i / 8] >> (i % 8) & 1) ? ROARING_RUN : ROARING_ARRAY;
+		res.count = i + 1;
+		if((i && c->key <= res.c[i - 1].key) || !h_roar_read_container(c, &p, end))
+			return roaring_free(&res), false;
+	}
+
+	roaring_free(rb);
+	*rb = res;
+	return true;
+}
+
+/* foreach_roaring() iterator */
+typedef struct h_roar_iter {
+	const roaring_bitmap *rb;
+	uint32_t ci;		/* index of the current container */
+	uint32_t pos;		/* index in array or index of run */
+	uint32_t next;		/* next value in the current run */
+	size_t widx;		/* foreach_array_set_bit() state for bitsets */
+	unsigned long long word;
+} h_roar_iter;
+
+static inline void h_roar_iter_enter(h_roar_iter *it) {
+	it->pos = 0;
+	it->widx = SIZE_MAX;
+	it->word = 0;
+	if(it->ci < it->rb->count && it->rb->c[it->ci].type == ROARING_RUN)
+		it->next = it->rb->c[it->ci].runs[0][0];
+}
+
+static inline h_roar_iter h_roar_iter_init(const roaring_bitmap *rb) {
+	h_roar_iter it = {.rb = rb};
+	h_roar_iter_enter(&it);
+	return it;
+}
+
+static inline bool h_roar_next(h_roar_iter *it, uint32_t *val) {
+	for(; it->ci < it->rb->count; it->ci++, h_roar_iter_enter(it)) {
+		const roaring_container *const c = &it->rb->c[it->ci];
+		const uint32_t high = (uint32_t)c->key << 16;
+		if(c->type == ROARING_ARRAY) {
+			if(it->pos < c->n)
+				return *val = high | c->array[it->pos++], true;
+		} else if(c->type == ROARING_BITSET) {
+			const size_t bit = h_bits_next_set(c->bitset, sizeof(uint64_t), ROARING_BITSET_WORDS, &it->widx, &it->word);
+			if(bit < ROARING_BITSET_WORDS * 64)
+				return *val = high | (uint32_t)bit, true;
+		} else if(it->pos < c->n) {
+			*val = high | it->next;
+			if(it->next == c->runs[it->pos][1]) {
+				if(++it->pos < c->n)
+					it->next = c->runs[it->pos][0];
+			} else {
+				it->next++;
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+#endif // POOR_ROARING_H
@@ -0,0 +1,545 @@
+// SPDX-License-Identifier: MIT
+/*
+ * Copyright (C) 2020 Alexandrov Stanislav <lightofmysoul@gmail.com>
+ */
+#ifndef POOR_SEARCH_H
+#define POOR_SEARCH_H
+
+#include <poor_array.h>
+#include <poor_common.h>
+#include <poor_traits.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Searching in arrays.
+ * Macros which look up an element return a reference (pointer) to it, which can be passed to array_ref_index(),
+ * or array_end_ref() of the same array if there is no such element.
+ *
+ * Comparison is a function or function-like macro less(a, b), same as in sort_array_by() */
+
+/* array_lower_bound(_arrm_, _key_)
+ * Returns reference to the first element of a sorted array which is not less than _key_, or array_end_ref()
+ * @_arrm_: an array or a pointer to an array, sorted in ascending order
+ * @_key_: value to search for, compared with elements by operator <
+ *
+ * Binary search is branchless: each step halves the range with a conditional move, so there is no
+ * branch misprediction per step, and both possible next middle elements are prefetched.
+ *
+ * example:
+
+	const int a[] = {1, 3, 3, 5};
+	println(array_ref_index(a, array_lower_bound(a, 3))); //prints: 1
+	println(array_ref_index(a, array_upper_bound(a, 3))); //prints: 3
+	println(array_lower_bound(a, 6) == array_end_ref(a)); //prints: 1
+ */
+#define array_lower_bound(_arrm_, _key_) array_lower_bound_by(_arrm_, _key_, h_search_less)
+
+/* array_upper_bound(_arrm_, _key_)
+ * Returns reference to the first element of a sorted array which is greater than _key_, or array_end_ref()
+ */
+#define array_upper_bound(_arrm_, _key_) array_upper_bound_by(_arrm_, _key_, h_search_less)
+
+/* array_lower_bound_by(_arrm_, _key_, _less_), array_upper_bound_by(_arrm_, _key_, _less_)
+ * Same as array_lower_bound() and array_upper_bound(), but with custom comparison.
+ * Array should be sorted by the same comparison. Lower bound calls less(element, key), upper bound calls less(key, element)
+ * example:
+
+	struct rec { uint32_t id; float val; } recs[] = {{1, 0.5f}, {4, 1.5f}, {9, 2.5f}};
+	#define rec_id_less(r, key) ((r).id < (key))
+	struct rec *r = array_lower_bound_by(recs, 4, rec_id_less);
+ */
+#define array_lower_bound_by(_arrm_, _key_, _less_) \
+	h_bound(array_first_ref(_arrm_), ARRAY_SIZE(_arrm_), _key_, _less_, h_search_lb_step)
+
+#define array_upper_bound_by(_arrm_, _key_, _less_) \
+	h_bound(array_first_ref(_arrm_), ARRAY_SIZE(_arrm_), _key_, _less_, h_search_ub_step)
+
+/* make_eytzinger_array(_arrm_dst_, _arrm_sorted_src_)
+ * Copies sorted array into another array of the same size in Eytzinger (breadth-first) layout:
+ * root of implicit binary search tree is at index 0, and children of element k are at 2k+1 and 2k+2.
+ * First levels of the tree share a few cache lines, and sixteen descendants of an element four levels
+ * below are adjacent, so eytzinger_search() prefetches them while it walks, unlike binary search,
+ * which touches a new cache line at every level.
+ *
+ * example:
+
+	uint32_t (*sorted)[n] = load_sorted_ids();
+	uint32_t (*eyt)[n] = malloc_array(eyt);
+	make_eytzinger_array(eyt, sorted);
+	uint32_t *ref = eytzinger_search(eyt, 42);
+	if(ref != array_end_ref(eyt) && *ref == 42)
+		found(array_ref_index(eyt, ref));
+ */
+#define make_eytzinger_array(_arrm_dst_, _arrm_sorted_src_) do {				\
+	(void)h_chk_same_size("make_eytzinger_array()", _arrm_dst_, _arrm_sorted_src_);	\
+	h_make_eytzinger(array_first_ref(_arrm_dst_), array_first_ref(_arrm_sorted_src_),	\
+		h_copy_min(ARRAY_SIZE(_arrm_dst_), ARRAY_SIZE(_arrm_sorted_src_)));		\
+} while(0)
+
+/* eytzinger_search(_arrm_, _key_)
+ * Returns reference to the smallest element of an array in Eytzinger layout, which is not less than _key_, or array_end_ref().
+ * i.e. same element as array_lower_bound() returns for the sorted array.
+ * Returned reference points into Eytzinger array, so array_ref_index() returns index in Eytzinger array.
+ * @_arrm_: an array or a pointer to an array, created by make_eytzinger_array()
+ * @_key_: value to search for, compared with elements by operator <
+ */
+#define eytzinger_search(_arrm_, _key_) eytzinger_search_by(_arrm_, _key_, h_search_less)
+
+/* eytzinger_search_by(_arrm_, _key_, _less_)
+ * Same as eytzinger_search(), but with custom comparison less(element, key)
+ */
+#define eytzinger_search_by(_arrm_, _key_, _less_) \
+	h_eytzinger_search(array_first_ref(_arrm_), ARRAY_SIZE(_arrm_), _key_, _less_)
+
+/* array_find(_arrm_, _value_)
+ * Returns reference to the first element of an array which is equal to _value_, or array_end_ref()
+ * @_arrm_: an array or a pointer to an array of arithmetic type
+ * @_value_: value to search for, converted to array element type
+ *
+ * Arrays of 1 byte elements are searched by memchr(). For other types elements are compared
+ * POOR_SIMD_BYTES at a time with vector instructions, and only a block which contains
+ * a match is compared element by element.
+ *
+ * example:
+
+	const uint32_t ids[] = {7, 3, 9, 3};
+	println(array_ref_index(ids, array_find(ids, 3))); //prints: 1
+	println(array_find(ids, 4) == array_end_ref(ids)); //prints: 1
+ */
+#define array_find(_arrm_, _value_) \
+	(array_first_ref(_arrm_) + h_search_generic(h_array_find_, &auto_arr(_arrm_))(ARRAY_SIZE(_arrm_), array_first_ref(_arrm_), (_value_)))
+
+/* array_count(_arrm_, _value_)
+ * Returns number of elements of an array which are equal to _value_. Arguments are the same as for array_find()
+ * example:
+
+	const short a[] = {1, 2, 1, 1};
+	println(array_count(a, 1)); //prints: 3
+ */
+#define array_count(_arrm_, _value_) \
+	h_search_generic(h_array_count_, &auto_arr(_arrm_))(ARRAY_SIZE(_arrm_), array_first_ref(_arrm_), (_value_))
+
+/* array_contains(_arrm_, _value_)
+ * Returns true if an array contains element equal to _value_. Arguments are the same as for array_find()
+ */
+#define array_contains(_arrm_, _value_) \
+	(h_search_generic(h_array_find_, &auto_arr(_arrm_))(ARRAY_SIZE(_arrm_), array_first_ref(_arrm_), (_value_)) < ARRAY_SIZE(_arrm_))
+
+/* array_find_if(_arrm_, _pred_)
+ * Returns reference to the first element of an array for which pred(element) is true, or array_end_ref()
+ * @_arrm_: an array or a pointer to an array of any type
+ * @_pred_: function or function-like macro pred(element)
+ * example:
+
+	struct rec recs[] = {{1, 0.5f}, {4, -1.5f}};
+	#define negative_val(r) ((r).val < 0)
+	struct rec *r = array_find_if(recs, negative_val);
+ */
+#define array_find_if(_arrm_, _pred_) __extension__ ({			\
+	const make_arrview_full(_fif_arrp_, _arrm_);			\
+	size_t _fif_i_ = 0;						\
+	while(_fif_i_ < UNSAFE_ARRAY_SIZE(*_fif_arrp_) && !_pred_((*_fif_arrp_)[_fif_i_]))	\
+		_fif_i_++;						\
+	array_first_ref(_arrm_) + _fif_i_;				\
+})
+
+/* array_find_subarray(_arrm_haystack_, _arrm_needle_)
+ * Searches for the first occurrence of an array inside another array, like memmem() does for bytes.
+ * Returns arrview of the match: pointer to an array of ARRAY_SIZE(needle) elements inside of haystack, or NULL
+ * @_arrm_haystack_: an array or a pointer to an array to search in
+ * @_arrm_needle_: an array or a pointer to an array of the same type to search for
+ *
+ * Elements are compared by their bytes, like memcmp() does, so arrays should not contain padding,
+ * and floating point elements are equal only if they have same bits (0.0 != -0.0).
+ * Matches always start at element boundary.
+ *
+ * Candidates are found by comparing first and last bytes of the needle with POOR_SIMD_BYTES of haystack
+ * at once, and are checked by memcmp(). If checking of candidates takes too much time, search continues with
+ * Two-Way algorithm, so worst case time is linear in size of both arrays.
+ *
+ * example:
+
+	make_arrview_str(text, "find a needle in a haystack");
+	make_arrview_str(word, "needle");
+	char (*match)[ARRAY_SIZE(word)] = array_find_subarray(text, word);
+	if(match)
+		println(array_ref_index(text, array_first_ref(match))); //prints: 7
+
+	const uint16_t samples[] = {1, 2, 3, 2, 3, 4};
+	const uint16_t pattern[] = {2, 3, 4};
+	const uint16_t (*m)[3] = array_find_subarray(samples, pattern); //m points to samples[3]
+ */
+#define array_find_subarray(_arrm_haystack_, _arrm_needle_) __extension__ ({						\
+	(void)h_chk_same_type("array_find_subarray()", _arrm_haystack_, _arrm_needle_);				\
+	const size_t _fsa_off_ = h_find_subarray_fn(array_first_ref(_arrm_haystack_), ARRAY_SIZE_BYTES(_arrm_haystack_),	\
+		array_first_ref(_arrm_needle_), ARRAY_SIZE_BYTES(_arrm_needle_), ARRAY_ELEMENT_SIZE(_arrm_haystack_));	\
+	(unsafe_make_arrptr(, ARRAY_SIZE(_arrm_needle_), &auto_arr(_arrm_haystack_)))						\
+		(_fsa_off_ == SIZE_MAX ? NULL : &auto_arr(_arrm_haystack_)[_fsa_off_ / ARRAY_ELEMENT_SIZE(_arrm_haystack_)]);	\
+})
+
+/****** Implementation ******/
+
+#define h_search_less(_a_, _b_) ((_a_) < (_b_))
+
+#if defined __GNUC__ || defined __clang__
+#define POOR_PREFETCH(_addr_) __builtin_prefetch(_addr_)
+#else
+#define POOR_PREFETCH(_addr_) ((void)(_addr_))
+#endif
+
+/* Steps of lower and upper bound: is answer after element _el_ */
+#define h_search_lb_step(_el_, _key_, _less_) _less_(_el_, _key_)
+#define h_search_ub_step(_el_, _key_, _less_) (!_less_(_key_, _el_))
+
+/* Range [_bnd_base_, _bnd_base_ + _bnd_n_] always contains the answer. Middle element of the next step
+ * is either in the lower or in the upper half, both of them are prefetched before the comparison */
+#define h_bound(_first_, _n_, _key_, _less_, _step_) __extension__ ({				\
+	typeof(&*(_first_)) _bnd_base_ = (_first_);						\
+	size_t _bnd_n_ = (_n_);									\
+	const typeof(_key_) _bnd_key_ = (_key_);						\
+	if(_bnd_n_) {										\
+		while(_bnd_n_ > 1) {								\
+			const size_t _bnd_half_ = _bnd_n_ / 2;					\
+			POOR_PREFETCH(&_bnd_base_[(_bnd_n_ - _bnd_half_) / 2]);			\
+			POOR_PREFETCH(&_bnd_base_[_bnd_half_ + (_bnd_n_ - _bnd_half_) / 2]);	\
+			_bnd_base_ += (size_t)_step_(_bnd_base_[_bnd_half_], _bnd_key_, _less_) * _bnd_half_;	\
+			_bnd_n_ -= _bnd_half_;							\
+		}									\
+		_bnd_base_ += (size_t)_step_(*_bnd_base_, _bnd_key_, _less_);			\
+	}										\
+	_bnd_base_;										\
+})
+
+/* Copies sorted elements in order of in-order traversal of the implicit tree */
+#define h_make_eytzinger(_dst_, _src_, _n_) do {						\
+	typeof(&*(_dst_)) const _eyt_dst_ = (_dst_);						\
+	typeof(&*(_src_)) const _eyt_src_ = (_src_);						\
+	const size_t _eyt_n_ = (_n_);								\
+	size_t _eyt_k_ = 0;									\
+	while(2 * _eyt_k_ + 1 < _eyt_n_)							\
+		_eyt_k_ = 2 * _eyt_k_ + 1;							\
+												\
+	for(size_t _eyt_i_ = 0; _eyt_i_ < _eyt_n_; _eyt_i_++) {				\
+		_eyt_dst_[_eyt_k_] = _eyt_src_[_eyt_i_];					\
+		if(2 * _eyt_k_ + 2 < _eyt_n_) {							\
+			/* leftmost element of the right subtree */				\
+			_eyt_k_ = 2 * _eyt_k_ + 2;						\
+			while(2 * _eyt_k_ + 1 < _eyt_n_)					\
+				_eyt_k_ = 2 * _eyt_k_ + 1;					\
+		} else {									\
+			/* go up while current element is a right child, then up once more */	\
+			while(_eyt_k_ && !(_eyt_k_ % 2))					\
+				_eyt_k_ = (_eyt_k_ - 1) / 2;					\
+			_eyt_k_ = _eyt_k_ ? (_eyt_k_ - 1) / 2 : 0;				\
+		}									\
+	}										\
+} while(0)
+
+/* Walks down the tree, going right when element is less than the key. In 1-based indexes,
+ * each right turn appends 1 bit to the index, and left turn appends 0 bit, so the answer is
+ * the element where the last left turn was made: index without trailing ones and one more bit.
+ * Index of an element sixteen times further is the first of it's descendants four levels below */
+#define h_eytzinger_search(_first_, _n_, _key_, _less_) __extension__ ({			\
+	typeof(&*(_first_)) const _eyts_a_ = (_first_);						\
+	const size_t _eyts_n_ = (_n_);								\
+	const typeof(_key_) _eyts_key_ = (_key_);						\
+	size_t _eyts_j_ = 1;									\
+	while(_eyts_j_ <= _eyts_n_) {								\
+		const size_t _eyts_pf_ = 16 * _eyts_j_ - 1;					\
+		POOR_PREFETCH(&_eyts_a_[_eyts_pf_ < _eyts_n_ ? _eyts_pf_ : 0]);		\
+		_eyts_j_ = 2 * _eyts_j_ + (size_t)_less_(_eyts_a_[_eyts_j_ - 1], _eyts_key_);	\
+	}										\
+	_eyts_j_ >>= h_search_trailing_ones(_eyts_j_) + 1;					\
+	_eyts_j_ ? &_eyts_a_[_eyts_j_ - 1] : &_eyts_a_[_eyts_n_];				\
+})
+
+static inline unsigned h_search_trailing_ones(size_t x) {
+#if defined __GNUC__ || defined __clang__
+	return (unsigned)__builtin_ctzll(~(unsigned long long)x);
+#else
+	unsigned cnt = 0;
+	for(; x & 1; x >>= 1)
+		cnt++;
+	return cnt;
+#endif
+}
+
+/* Calls _macro_(suffix, type, category) for each type supported by array_find() and array_count().
+ * Categories: b - one byte types, v - types which can be vector elements, s - other types */
+#define h_search_types(_macro_)				\
+	_macro_(c,   char,               b)		\
+	_macro_(sc,  signed char,        b)		\
+	_macro_(uc,  unsigned char,      b)		\
+	_macro_(ss,  short,              v)		\
+	_macro_(us,  unsigned short,     v)		\
+	_macro_(si,  int,                v)		\
+	_macro_(ui,  unsigned,           v)		\
+	_macro_(sl,  long,               v)		\
+	_macro_(ul,  unsigned long,      v)		\
+	_macro_(sll, long long,          v)		\
+	_macro_(ull, unsigned long long, v)		\
+	_macro_(f,   float,              v)		\
+	_macro_(d,   double,             v)		\
+	_macro_(ld,  long double,        s)
+
+#define h_search_generic(_prefix_, _arrp_) _Generic((*(_arrp_))[0],	\
+	char:			_prefix_ ## c,				\
+	signed char:		_prefix_ ## sc,				\
+	unsigned char:		_prefix_ ## uc,				\
+	short:			_prefix_ ## ss,				\
+	unsigned short:		_prefix_ ## us,				\
+	int:			_prefix_ ## si,				\
+	unsigned:		_prefix_ ## ui,				\
+	long:			_prefix_ ## sl,				\
+	unsigned long:		_prefix_ ## ul,				\
+	long long:		_prefix_ ## sll,			\
+	unsigned long long:	_prefix_ ## ull,			\
+	float:			_prefix_ ## f,				\
+	double:			_prefix_ ## d,				\
+	long double:		_prefix_ ## ld)
+
+/* Vector part of search kernels uses GNU vector extensions, other compilers use scalar loops only.
+ * Vectors are loaded with memcpy(), which compiles to unaligned vector loads.
+ * Result of comparison of two vectors is a vector of signed integers of the same size,
+ * where each element is either 0 or -1 */
+#if defined __GNUC__ || defined __clang__
+#define h_search_vec_t(_type_) typeof(_type_ __attribute__((vector_size(POOR_SIMD_BYTES))))
+#define h_search_vec_cnt(_type_) (POOR_SIMD_BYTES / sizeof(_type_))
+
+#define h_search_vec_load(_vec_, _ptr_) memcpy(&(_vec_), (_ptr_), sizeof(_vec_))
+
+/* Returns index of the first block of four vectors which contains _v_, or index after the last full block */
+#define h_search_vec_find(_type_, _n_, _a_, _v_) __extension__ ({				\
+	const h_search_vec_t(_type_) _vv_ = (_v_) + (h_search_vec_t(_type_)){0};		\
+	size_t _vi_ = 0;									\
+	for(; _vi_ + 4 * h_search_vec_cnt(_type_) <= (_n_); _vi_ += 4 * h_search_vec_cnt(_type_)) {	\
+		h_search_vec_t(_type_) _x0_, _x1_, _x2_, _x3_;					\
+		h_search_vec_load(_x0_, &(_a_)[_vi_]);						\
+		h_search_vec_load(_x1_, &(_a_)[_vi_ + h_search_vec_cnt(_type_)]);		\
+		h_search_vec_load(_x2_, &(_a_)[_vi_ + 2 * h_search_vec_cnt(_type_)]);		\
+		h_search_vec_load(_x3_, &(_a_)[_vi_ + 3 * h_search_vec_cnt(_type_)]);		\
+		const typeof(_x0_ == _vv_) _m_ = (_x0_ == _vv_) | (_x1_ == _vv_) | (_x2_ == _vv_) | (_x3_ == _vv_);	\
+		uint64_t _w_[POOR_SIMD_BYTES / 8], _any_ = 0;					\
+		memcpy(_w_, &_m_, sizeof(_w_));							\
+		for(size_t _k_ = 0; _k_ < POOR_SIMD_BYTES / 8; _k_++)				\
+			_any_ |= _w_[_k_];							\
+		if(_any_)									\
+			break;									\
+	}											\
+	_vi_;											\
+})
+
+/* Counts elements equal to _v_ in vector sized steps. Counters in each vector lane are subtracted
+ * by comparison results, and are added to the total before they can overflow. Sets _i_ to the first uncounted index */
+#define h_search_vec_count(_type_, _n_, _a_, _v_, _i_) __extension__ ({			\
+	const h_search_vec_t(_type_) _vv_ = (_v_) + (h_search_vec_t(_type_)){0};		\
+	size_t _vcnt_ = 0;									\
+	while((_i_) + h_search_vec_cnt(_type_) <= (_n_)) {					\
+		typeof(_vv_ == _vv_) _acc_ = (_vv_ == _vv_) ^ (_vv_ == _vv_);			\
+		for(unsigned _k_ = 0; _k_ < 127 && (_i_) + h_search_vec_cnt(_type_) <= (_n_); _k_++) {	\
+			h_search_vec_t(_type_) _x_;						\
+			h_search_vec_load(_x_, &(_a_)[_i_]);					\
+			_acc_ -= _x_ == _vv_;							\
+			(_i_) += h_search_vec_cnt(_type_);					\
+		}									\
+		for(size_t _k_ = 0; _k_ < h_search_vec_cnt(_type_); _k_++)			\
+			_vcnt_ += (size_t)_acc_[_k_];						\
+	}											\
+	_vcnt_;											\
+})
+#else
+#define h_search_vec_find(_type_, _n_, _a_, _v_) ((size_t)0)
+#define h_search_vec_count(_type_, _n_, _a_, _v_, _i_) ((size_t)0)
+#endif
+
+/* Search kernels for each category */
+#define h_search_find_b(_type_, _n_, _a_, _v_) do {					\
+	const unsigned char *const _ptr_ = _n_ ? memchr(_a_, (unsigned char)(_v_), _n_) : NULL;	\
+	return _ptr_ ? (size_t)(_ptr_ - (const unsigned char *)(_a_)) : (_n_);		\
+} while(0)
+
+#define h_search_find_v(_type_, _n_, _a_, _v_) do {					\
+	size_t _i_ = h_search_vec_find(_type_, _n_, _a_, _v_);				\
+	while(_i_ < (_n_) && (_a_)[_i_] != (_v_))					\
+		_i_++;									\
+	return _i_;									\
+} while(0)
+
+#define h_search_find_s(_type_, _n_, _a_, _v_) do {					\
+	size_t _i_ = 0;									\
+	while(_i_ < (_n_) && (_a_)[_i_] != (_v_))					\
+		_i_++;									\
+	return _i_;									\
+} while(0)
+
+#define h_search_count_b h_search_count_v
+#define h_search_count_v(_type_, _n_, _a_, _v_) do {					\
+	size_t _i_ = 0;									\
+	size_t _cnt_ = h_search_vec_count(_type_, _n_, _a_, _v_, _i_);			\
+	const _type_ *const _rest_ = &(_a_)[_i_];					\
+	for(size_t _k_ = 0; _k_ < (_n_) - _i_; _k_++)					\
+		_cnt_ += _rest_[_k_] == (_v_);						\
+	return _cnt_;									\
+} while(0)
+
+#define h_search_count_s(_type_, _n_, _a_, _v_) do {					\
+	size_t _cnt_ = 0;								\
+	for(size_t _i_ = 0; _i_ < (_n_); _i_++)						\
+		_cnt_ += (_a_)[_i_] == (_v_);						\
+	return _cnt_;									\
+} while(0)
+
+#define h_define_array_find(_sfx_, _type_, _cat_)					\
+static inline size_t h_array_find_ ## _sfx_(size_t n, const _type_ *a, _type_ v) {	\
+	h_search_find_ ## _cat_(_type_, n, a, v);					\
+}											\
+											\
+static inline size_t h_array_count_ ## _sfx_(size_t n, const _type_ *a, _type_ v) {	\
+	h_search_count_ ## _cat_(_type_, n, a, v);					\
+}
+
+h_search_types(h_define_array_find)
+
+/* array_find_subarray() implementation.
+ * Returns offset in bytes of the first occurrence of needle in haystack, which is multiple of _el_size_, or SIZE_MAX */
+static inline size_t h_two_way_fn(const unsigned char *hay, size_t hn, const unsigned char *nd, size_t nn, size_t el_size);
+
+static inline size_t h_find_subarray_fn(const void *haystack, size_t hn, const void *needle, size_t nn, size_t el_size) {
+	const unsigned char *const hay = haystack, *const nd = needle;
+	if(!nn)
+		return 0;
+	if(nn > hn)
+		return SIZE_MAX;
+
+	/* Checking of candidates is allowed to take as long as scanning of haystack.
+	 * Past that point input is adversarial and Two-Way continues from the current position */
+	const size_t last = hn - nn;
+	size_t i = 0, cost = 0;
+#if defined __GNUC__ || defined __clang__
+	const h_search_vec_t(unsigned char) vf = nd[0] + (h_search_vec_t(unsigned char)){0};
+	const h_search_vec_t(unsigned char) vl = nd[nn - 1] + (h_search_vec_t(unsigned char)){0};
+	for(; i + POOR_SIMD_BYTES <= last + 1; i += POOR_SIMD_BYTES) {
+		h_search_vec_t(unsigned char) f, l;
+		h_search_vec_load(f, &hay[i]);
+		h_search_vec_load(l, &hay[i + nn - 1]);
+		const typeof(f == vf) m = (f == vf) & (l == vl);
+
+		uint64_t w[POOR_SIMD_BYTES / 8], any = 0;
+		memcpy(w, &m, sizeof(w));
+		for(size_t k = 0; k < POOR_SIMD_BYTES / 8; k++)
+			any |= w[k];
+		if(!any)
+			continue;
+
+		for(size_t k = 0; k < POOR_SIMD_BYTES; k++) {
+			if(m[k] && !((i + k) % el_size)) {
+				if(!memcmp(&hay[i + k], nd, nn))
+					return i + k;
+				cost += nn;
+			}
+		}
+		if(cost > 2 * i + 256)
+			goto two_way;
+	}
+#endif
+	for(; i <= last; i++) {
+		if(hay[i] == nd[0] && hay[i + nn - 1] == nd[nn - 1] && !(i % el_size)) {
+			if(!memcmp(&hay[i], nd, nn))
+				return i;
+			cost += nn;
+			if(cost > 2 * i + 256)
+				goto two_way;
+		}
+	}
+	return SIZE_MAX;
+
+two_way:
+	i -= i % el_size;
+	const size_t off = h_two_way_fn(&hay[i], hn - i, nd, nn, el_size);
+	return off == SIZE_MAX ? SIZE_MAX : i + off;
+}
+
+/* Returns start of the maximal suffix of needle, and it's period in _period_.
+ * Suffix is maximal by byte order if (rev) is false, or by reverse byte order otherwise.
+ * SIZE_MAX is used as index -1 and wraps around to 0 when added to positive numbers */
+static inline size_t h_two_way_max_suffix(const unsigned char *nd, size_t nn, size_t *period, int rev) {
+	size_t ms = SIZE_MAX, j = 0, k = 1, p = 1;
+	while(j + k < nn) {
+		const unsigned char a = nd[j + k], b = nd[ms + k];
+		if(rev ? b < a : a < b) {
+			j += k;
+			k = 1;
+			p = j - ms;
+		} else if(a == b) {
+			if(k != p) {
+				k++;
+			} else {
+				j += p;
+				k = 1;
+			}
+		} else {
+			ms = j++;
+			k = p = 1;
+		}
+	}
+	*period = p;
+	return ms;
+}
+
+/* Two-Way string matching by Crochemore and Perrin. Needle is split at critical factorization,
+ * right part is matched from left to right, then left part from right to left.
+ * Matches which don't start at element boundary are skipped as mismatches */
+static inline size_t h_two_way_fn(const unsigned char *hay, size_t hn, const unsigned char *nd, size_t nn, size_t el_size) {
+	size_t period, period_rev;
+	const size_t ms = h_two_way_max_suffix(nd, nn, &period, 0);
+	const size_t ms_rev = h_two_way_max_suffix(nd, nn, &period_rev, 1);
+	size_t suffix = ms + 1;
+	if(!(ms_rev + 1 < ms + 1)) {
+		suffix = ms_rev + 1;
+		period = period_rev;
+	}
+
+	if(!memcmp(nd, nd + period, suffix)) {
+		/* Periodic needle: bytes which already matched after shift by period are remembered */
+		size_t memory = 0;
+		for(size_t j = 0; j <= hn - nn;) {
+			size_t i = suffix > memory ? suffix : memory;
+			while(i < nn && nd[i] == hay[i + j])
+				i++;
+			if(i < nn) {
+				j += i - suffix + 1;
+				memory = 0;
+				continue;
+			}
+			i = suffix - 1;
+			while(memory < i + 1 && nd[i] == hay[i + j])
+				i--;
+			if(i + 1 < memory + 1 && !(j % el_size))
+				return j;
+			j += period;
+			memory = nn - period;
+		}
+	} else {
+		period = (suffix > nn - suffix ? suffix : nn - suffix) + 1;
+		for(size_t j = 0; j <= hn - nn;) {
+			size_t i = suffix;
+			while(i < nn && nd[i] == hay[i + j])
+				i++;
+			if(i < nn) {
+				j += i - suffix + 1;
+				continue;
+			}
+			i = suffix - 1;
+			while(i != SIZE_MAX && nd[i] == hay[i + j])
+				i--;
+			if(i == SIZE_MAX && !(j % el_size))
+				return j;
+			j += period;
+		}
+	}
+	return SIZE_MAX;
+}
+
+#endif // POOR_SEARCH_H
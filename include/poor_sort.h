@@ -0,0 +1,801 @@
+// SPDX-License-Identifier: MIT
+/*
+ * Copyright (C) 2020 Alexandrov Stanislav <lightofmysoul@gmail.com>
+ */
+#ifndef POOR_SORT_H
+#define POOR_SORT_H
+
+#include <poor_array.h>
+#include <poor_common.h>
+#include <poor_parallel.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Sorting of arrays.
+ *
+ * Unlike qsort(), sorting code is expanded inline for array element type,
+ * so comparisons are not function calls and elements are moved by assignment, not by memcpy().
+ *
+ * Comparison is a function or function-like macro less(a, b), which returns true if (a) should be placed before (b).
+ * Arguments of less() never have side effects, so it is safe to use them multiple times inside a macro. */
+
+/* Ranges smaller than this are sorted by insertion sort */
+#ifndef POOR_SORT_INSERTION
+#define POOR_SORT_INSERTION 24
+#endif
+
+/* Ranges larger than this use pseudomedian of nine as a pivot, instead of median of three */
+#ifndef POOR_SORT_NINTHER
+#define POOR_SORT_NINTHER 128
+#endif
+
+/* Arrays with constant size up to this are sorted by sorting networks, can't be greater than 32 */
+#ifndef POOR_SORT_NETWORK_MAX
+#define POOR_SORT_NETWORK_MAX 32
+#endif
+
+/* Arrays smaller than this are sorted by radix_sort_array() with comparisons */
+#ifndef POOR_RADIX_MIN
+#define POOR_RADIX_MIN 64
+#endif
+
+/* sort_array(_arrm_)
+ * Sorts an array in ascending order using operator <
+ * @_arrm_: an array or a pointer to an array
+ *
+ * Algorithm is pattern-defeating quicksort: median of three (or nine) pivot, insertion sort for
+ * small ranges, special handling of equal elements and already sorted ranges, and heapsort fallback
+ * which limits worst case to O(n log n). Sort is not stable.
+ *
+ * If array size is a constant expression not greater than POOR_SORT_NETWORK_MAX, then array is sorted
+ * by a sorting network instead: fixed sequence of compare-exchange operations, which is fully unrolled
+ * and compiles to conditional moves without branches for arithmetic types.
+ *
+ * example:
+
+	int a[] = {5, 2, 9, 1};
+	sort_array(a);
+	print_array(a); //prints: [1,2,5,9]
+ */
+#define sort_array(_arrm_) sort_array_by(_arrm_, h_sort_less)
+
+/* sort_array_by(_arrm_, _less_)
+ * Sorts an array with custom comparison
+ * @_arrm_: an array or a pointer to an array
+ * @_less_: function or function-like macro less(a, b), receives array elements (not pointers to them)
+ *
+ * example:
+
+	struct item {
+		int key;
+		const char *name;
+	} items[] = {{3, "c"}, {1, "a"}, {2, "b"}};
+
+	#define item_less(a, b) ((a).key < (b).key)
+	sort_array_by(items, item_less);
+
+	//descending order
+	#define greater(a, b) ((a) > (b))
+	long v[] = {1, 3, 2};
+	sort_array_by(v, greater);
+	print_array(v); //prints: [3,2,1]
+ */
+#define sort_array_by(_arrm_, _less_) do {								\
+	if(is_const_expr(ARRAY_SIZE(_arrm_)) && ARRAY_SIZE(_arrm_) <= POOR_SORT_NETWORK_MAX)		\
+		h_sort_network(array_first_ref(_arrm_), ARRAY_SIZE(_arrm_), _less_);			\
+	else												\
+		h_sort_range(array_first_ref(_arrm_), ARRAY_SIZE(_arrm_), _less_);			\
+} while(0)
+
+/* parallel_sort_array(_arrm_), parallel_sort_array_by(_arrm_, _less_)
+ * Multi-threaded variants of sort_array() and sort_array_by(). See poor_parallel.h
+ *
+ * Array is split into one arrview per worker, each arrview is sorted by sort_array_by(),
+ * then sorted arrviews are merged pairwise through a temporary buffer of the same size as the array.
+ * If there is only one worker, or temporary buffer can't be allocated, array is sorted on the calling thread.
+ *
+ * example:
+
+	int64_t (*ids)[100000000] = load_ids();
+	parallel_sort_array(ids);
+ */
+#define parallel_sort_array(_arrm_) parallel_sort_array_by(_arrm_, h_sort_less)
+#define parallel_sort_array_by(_arrm_, _less_) h_parallel_sort(&auto_arr(_arrm_), _less_)
+
+/* radix_sort_array(_arrm_)
+ * Sorts an array of integers or floating point numbers in ascending order by LSD radix sort
+ * @_arrm_: an array or a pointer to an array of 8, 16, 32 or 64 bit integers, float or double
+ *
+ * Elements are distributed byte by byte through a temporary array of the same size, allocated by malloc_array().
+ * Histograms of all bytes are counted in a single pass over the array, and passes over a byte,
+ * which is the same for all elements, are skipped. So sorting of i.e. timestamps within one day
+ * touches the array only a few times regardless of element size.
+ *
+ * Floating point numbers are sorted by their bit patterns mapped to order-preserving integers:
+ * -0.0 is placed before 0.0, negative NaNs before all numbers and positive NaNs after them.
+ *
+ * Arrays smaller than POOR_RADIX_MIN elements, or if temporary array can't be allocated,
+ * are sorted by sort_array_by() with the same ordering.
+ *
+ * example:
+
+	uint64_t (*ts)[n] = malloc_array(ts);
+	read_timestamps(ts);
+	radix_sort_array(ts);
+ */
+#define radix_sort_array(_arrm_) \
+	h_radix_generic(&auto_arr(_arrm_))(ARRAY_SIZE(_arrm_), array_first_ref(_arrm_))
+
+/****** Implementation ******/
+
+#define h_sort_less(_a_, _b_) ((_a_) < (_b_))
+
+#define h_sort_swap(_x_, _y_) do {	\
+	const typeof(_x_) _swp_ = (_x_);	\
+	(_x_) = (_y_);			\
+	(_y_) = _swp_;			\
+} while(0)
+
+/* Sorts two or three elements of array _a_ at indexes _i_, _j_, _k_ */
+#define h_sort2(_a_, _i_, _j_, _less_) do {		\
+	if(_less_((_a_)[_j_], (_a_)[_i_]))		\
+		h_sort_swap((_a_)[_i_], (_a_)[_j_]);	\
+} while(0)
+
+#define h_sort3(_a_, _i_, _j_, _k_, _less_) do {	\
+	h_sort2(_a_, _i_, _j_, _less_);			\
+	h_sort2(_a_, _j_, _k_, _less_);			\
+	h_sort2(_a_, _i_, _j_, _less_);			\
+} while(0)
+
+/* Sorts range [_lo_, _hi_) of array _a_ by insertion sort */
+#define h_insertion_sort(_a_, _lo_, _hi_, _less_) do {					\
+	for(size_t _ins_i_ = (_lo_) + 1; _ins_i_ < (_hi_); _ins_i_++) {			\
+		if(!_less_((_a_)[_ins_i_], (_a_)[_ins_i_ - 1]))				\
+			continue;							\
+											\
+		const typeof((_a_)[0]) _ins_tmp_ = (_a_)[_ins_i_];			\
+		size_t _ins_j_ = _ins_i_;						\
+		do {									\
+			(_a_)[_ins_j_] = (_a_)[_ins_j_ - 1];				\
+			_ins_j_--;							\
+		} while(_ins_j_ > (_lo_) && _less_(_ins_tmp_, (_a_)[_ins_j_ - 1]));	\
+		(_a_)[_ins_j_] = _ins_tmp_;						\
+	}										\
+} while(0)
+
+/* Same as h_insertion_sort(), but gives up after moving 8 elements, and sets _ok_ to false in that case */
+#define h_partial_insertion_sort(_a_, _lo_, _hi_, _less_, _ok_) do {			\
+	size_t _pis_moves_ = 0;								\
+	(_ok_) = true;									\
+	for(size_t _ins_i_ = (_lo_) + 1; _ins_i_ < (_hi_); _ins_i_++) {			\
+		if(!_less_((_a_)[_ins_i_], (_a_)[_ins_i_ - 1]))				\
+			continue;							\
+											\
+		const typeof((_a_)[0]) _ins_tmp_ = (_a_)[_ins_i_];			\
+		size_t _ins_j_ = _ins_i_;						\
+		do {									\
+			(_a_)[_ins_j_] = (_a_)[_ins_j_ - 1];				\
+			_ins_j_--;							\
+		} while(_ins_j_ > (_lo_) && _less_(_ins_tmp_, (_a_)[_ins_j_ - 1]));	\
+		(_a_)[_ins_j_] = _ins_tmp_;						\
+											\
+		_pis_moves_ += _ins_i_ - _ins_j_;					\
+		if(_pis_moves_ > 8) {							\
+			(_ok_) = false;							\
+			break;								\
+		}									\
+	}										\
+} while(0)
+
+/* Sorts range [_lo_, _hi_) of array _a_ by heapsort */
+#define h_heap_sort(_a_, _lo_, _hi_, _less_) do {					\
+	typeof(&(_a_)[0]) const _hs_h_ = &(_a_)[_lo_];					\
+	const size_t _hs_n_ = (_hi_) - (_lo_);						\
+	for(size_t _hs_i_ = _hs_n_ / 2; _hs_i_-- > 0;)					\
+		h_heap_sift(_hs_h_, _hs_i_, _hs_n_, _less_);				\
+	for(size_t _hs_i_ = _hs_n_; _hs_i_-- > 1;) {					\
+		h_sort_swap(_hs_h_[0], _hs_h_[_hs_i_]);					\
+		h_heap_sift(_hs_h_, 0, _hs_i_, _less_);					\
+	}										\
+} while(0)
+
+#define h_heap_sift(_h_, _root_, _size_, _less_) do {					\
+	size_t _sft_r_ = (_root_);							\
+	for(;;) {									\
+		size_t _sft_c_ = 2 * _sft_r_ + 1;					\
+		if(_sft_c_ >= (_size_))							\
+			break;								\
+		if(_sft_c_ + 1 < (_size_) && _less_((_h_)[_sft_c_], (_h_)[_sft_c_ + 1]))	\
+			_sft_c_++;							\
+		if(!_less_((_h_)[_sft_r_], (_h_)[_sft_c_]))				\
+			break;								\
+		h_sort_swap((_h_)[_sft_r_], (_h_)[_sft_c_]);				\
+		_sft_r_ = _sft_c_;							\
+	}										\
+} while(0)
+
+/* Swaps elements of unbalanced partition [_lo_, _hi_) to break patterns which cause bad pivots */
+#define h_sort_break_patterns(_a_, _lo_, _hi_) do {					\
+	const size_t _bp_len_ = (_hi_) - (_lo_);					\
+	if(_bp_len_ >= POOR_SORT_INSERTION) {						\
+		const size_t _bp_q_ = _bp_len_ / 4;					\
+		h_sort_swap((_a_)[_lo_], (_a_)[(_lo_) + _bp_q_]);			\
+		h_sort_swap((_a_)[(_hi_) - 1], (_a_)[(_hi_) - _bp_q_]);			\
+		if(_bp_len_ > POOR_SORT_NINTHER) {					\
+			h_sort_swap((_a_)[(_lo_) + 1], (_a_)[(_lo_) + _bp_q_ + 1]);	\
+			h_sort_swap((_a_)[(_lo_) + 2], (_a_)[(_lo_) + _bp_q_ + 2]);	\
+			h_sort_swap((_a_)[(_hi_) - 2], (_a_)[(_hi_) - _bp_q_ - 1]);	\
+			h_sort_swap((_a_)[(_hi_) - 3], (_a_)[(_hi_) - _bp_q_ - 2]);	\
+		}									\
+	}										\
+} while(0)
+
+/* Pattern-defeating quicksort of _n_ elements starting at pointer _first_.
+ * Larger partition is pushed to the stack and smaller one is processed immediately,
+ * so stack never holds more than log2(n) ranges */
+#define h_sort_range(_first_, _n_, _less_) do {						\
+	typeof(&*(_first_)) const _srt_a_ = (_first_);					\
+	struct { size_t lo, hi; unsigned bad; } _srt_stk_[sizeof(size_t) * 8];		\
+	size_t _srt_sp_ = 0;								\
+											\
+	_srt_stk_[0].lo = 0;								\
+	_srt_stk_[0].hi = (_n_);							\
+	_srt_stk_[0].bad = 0;								\
+	for(size_t _srt_t_ = _srt_stk_[0].hi; _srt_t_ >>= 1;)				\
+		_srt_stk_[0].bad++;							\
+	_srt_sp_++;									\
+											\
+	while(_srt_sp_) {								\
+		_srt_sp_--;								\
+		size_t _srt_lo_ = _srt_stk_[_srt_sp_].lo;				\
+		size_t _srt_hi_ = _srt_stk_[_srt_sp_].hi;				\
+		unsigned _srt_bad_ = _srt_stk_[_srt_sp_].bad;				\
+											\
+		for(;;) {								\
+			const size_t _srt_len_ = _srt_hi_ - _srt_lo_;			\
+			if(_srt_len_ < POOR_SORT_INSERTION) {				\
+				h_insertion_sort(_srt_a_, _srt_lo_, _srt_hi_, _less_);	\
+				break;							\
+			}								\
+											\
+			h_sort_pivot(_srt_a_, _srt_lo_, _srt_hi_, _less_);		\
+											\
+			/* Pivot is equal to the element before the range, so every element equal */	\
+			/* to the pivot is at it's final position. Put them to the left and skip */	\
+			if(_srt_lo_ > 0 && !_less_(_srt_a_[_srt_lo_ - 1], _srt_a_[_srt_lo_])) {	\
+				h_sort_partition_left(_srt_a_, _srt_lo_, _srt_hi_, _less_);	\
+				continue;						\
+			}								\
+											\
+			size_t _srt_p_;							\
+			bool _srt_done_;						\
+			h_sort_partition_right(_srt_a_, _srt_lo_, _srt_hi_, _less_, _srt_p_, _srt_done_);	\
+											\
+			const size_t _srt_l_size_ = _srt_p_ - _srt_lo_;			\
+			const size_t _srt_r_size_ = _srt_hi_ - _srt_p_ - 1;		\
+			if(_srt_l_size_ < _srt_len_ / 8 || _srt_r_size_ < _srt_len_ / 8) {	\
+				if(!_srt_bad_) {					\
+					h_heap_sort(_srt_a_, _srt_lo_, _srt_hi_, _less_);	\
+					break;						\
+				}							\
+				_srt_bad_--;						\
+				h_sort_break_patterns(_srt_a_, _srt_lo_, _srt_p_);	\
+				h_sort_break_patterns(_srt_a_, _srt_p_ + 1, _srt_hi_);	\
+			} else if(_srt_done_) {						\
+				/* range was already partitioned, try to finish it with insertion sort */	\
+				bool _srt_ok_;						\
+				h_partial_insertion_sort(_srt_a_, _srt_lo_, _srt_p_, _less_, _srt_ok_);	\
+				if(_srt_ok_)						\
+					h_partial_insertion_sort(_srt_a_, _srt_p_ + 1, _srt_hi_, _less_, _srt_ok_);	\
+				if(_srt_ok_)						\
+					break;						\
+			}								\
+											\
+			_srt_stk_[_srt_sp_].bad = _srt_bad_;				\
+			if(_srt_l_size_ > _srt_r_size_) {				\
+				_srt_stk_[_srt_sp_].lo = _srt_lo_;			\
+				_srt_stk_[_srt_sp_].hi = _srt_p_;			\
+				_srt_lo_ = _srt_p_ + 1;					\
+			} else {							\
+				_srt_stk_[_srt_sp_].lo = _srt_p_ + 1;			\
+				_srt_stk_[_srt_sp_].hi = _srt_hi_;			\
+				_srt_hi_ = _srt_p_;					\
+			}								\
+			_srt_sp_++;							\
+		}									\
+	}										\
+} while(0)
+
+/* Moves pivot to position _lo_. After that, there is an element not less than pivot at position _hi_ - 1 */
+#define h_sort_pivot(_a_, _lo_, _hi_, _less_) do {					\
+	const size_t _pv_mid_ = (_lo_) + ((_hi_) - (_lo_)) / 2;				\
+	if((_hi_) - (_lo_) > POOR_SORT_NINTHER) {					\
+		h_sort3(_a_, _lo_, _pv_mid_, (_hi_) - 1, _less_);			\
+		h_sort3(_a_, (_lo_) + 1, _pv_mid_ - 1, (_hi_) - 2, _less_);		\
+		h_sort3(_a_, (_lo_) + 2, _pv_mid_ + 1, (_hi_) - 3, _less_);		\
+		h_sort3(_a_, _pv_mid_ - 1, _pv_mid_, _pv_mid_ + 1, _less_);		\
+		h_sort_swap((_a_)[_lo_], (_a_)[_pv_mid_]);				\
+	} else {									\
+		h_sort3(_a_, _pv_mid_, _lo_, (_hi_) - 1, _less_);			\
+	}										\
+} while(0)
+
+/* Partitions [_lo_, _hi_) around pivot at _lo_, elements equal to pivot go to the right.
+ * Stores final pivot position into _p_, and sets _done_ if no elements were swapped */
+#define h_sort_partition_right(_a_, _lo_, _hi_, _less_, _p_, _done_) do {		\
+	const typeof((_a_)[0]) _pr_pivot_ = (_a_)[_lo_];				\
+	size_t _pr_i_ = (_lo_), _pr_j_ = (_hi_);					\
+											\
+	do _pr_i_++; while(_less_((_a_)[_pr_i_], _pr_pivot_));				\
+	if(_pr_i_ - 1 == (_lo_)) {							\
+		while(_pr_i_ < _pr_j_) {						\
+			_pr_j_--;							\
+			if(_less_((_a_)[_pr_j_], _pr_pivot_))				\
+				break;							\
+		}									\
+	} else {									\
+		do _pr_j_--; while(!_less_((_a_)[_pr_j_], _pr_pivot_));			\
+	}										\
+											\
+	(_done_) = _pr_i_ >= _pr_j_;							\
+	while(_pr_i_ < _pr_j_) {							\
+		h_sort_swap((_a_)[_pr_i_], (_a_)[_pr_j_]);				\
+		do _pr_i_++; while(_less_((_a_)[_pr_i_], _pr_pivot_));			\
+		do _pr_j_--; while(!_less_((_a_)[_pr_j_], _pr_pivot_));			\
+	}										\
+											\
+	(_p_) = _pr_i_ - 1;								\
+	(_a_)[_lo_] = (_a_)[_p_];							\
+	(_a_)[_p_] = _pr_pivot_;							\
+} while(0)
+
+/* Partitions [_lo_, _hi_) around pivot at _lo_, elements equal to pivot go to the left.
+ * Sets _lo_ to the position after the last element equal to pivot */
+#define h_sort_partition_left(_a_, _lo_, _hi_, _less_) do {				\
+	const typeof((_a_)[0]) _pl_pivot_ = (_a_)[_lo_];				\
+	size_t _pl_i_ = (_lo_), _pl_j_ = (_hi_);					\
+											\
+	do _pl_j_--; while(_less_(_pl_pivot_, (_a_)[_pl_j_]));				\
+	if(_pl_j_ + 1 == (_hi_)) {							\
+		while(_pl_i_ < _pl_j_) {						\
+			_pl_i_++;							\
+			if(_less_(_pl_pivot_, (_a_)[_pl_i_]))				\
+				break;							\
+		}									\
+	} else {									\
+		do _pl_i_++; while(!_less_(_pl_pivot_, (_a_)[_pl_i_]));			\
+	}										\
+											\
+	while(_pl_i_ < _pl_j_) {							\
+		h_sort_swap((_a_)[_pl_i_], (_a_)[_pl_j_]);				\
+		do _pl_j_--; while(_less_(_pl_pivot_, (_a_)[_pl_j_]));			\
+		do _pl_i_++; while(!_less_(_pl_pivot_, (_a_)[_pl_i_]));			\
+	}										\
+											\
+	(_a_)[_lo_] = (_a_)[_pl_j_];							\
+	(_a_)[_pl_j_] = _pl_pivot_;							\
+	(_lo_) = _pl_j_ + 1;								\
+} while(0)
+
+/* Merges sorted ranges [_lo_, _mid_) and [_mid_, _hi_) of array _src_ into the same range of array _dst_ */
+#define h_sort_merge(_src_, _dst_, _lo_, _mid_, _hi_, _less_) do {			\
+	size_t _mrg_i_ = (_lo_), _mrg_j_ = (_mid_), _mrg_k_ = (_lo_);			\
+	while(_mrg_i_ < (_mid_) && _mrg_j_ < (_hi_)) {					\
+		if(_less_((_src_)[_mrg_j_], (_src_)[_mrg_i_]))				\
+			(_dst_)[_mrg_k_++] = (_src_)[_mrg_j_++];			\
+		else									\
+			(_dst_)[_mrg_k_++] = (_src_)[_mrg_i_++];			\
+	}										\
+	memcpy(&(_dst_)[_mrg_k_], &(_src_)[_mrg_i_], ((_mid_) - _mrg_i_) * sizeof((_src_)[0]));	\
+	_mrg_k_ += (_mid_) - _mrg_i_;							\
+	memcpy(&(_dst_)[_mrg_k_], &(_src_)[_mrg_j_], ((_hi_) - _mrg_j_) * sizeof((_src_)[0]));	\
+} while(0)
+
+/* Sorts _n_ elements starting at pointer _first_ by a sorting network from h_sort_net_pairs.
+ * With constant _n_ loop is unrolled and table lookups are folded by compiler, so elements stay in registers */
+#define h_sort_network(_first_, _n_, _less_) do {						\
+	typeof(&*(_first_)) const _net_a_ = (_first_);						\
+	h_sort_net_unroll									\
+	for(size_t _net_k_ = h_sort_net_offs[_n_]; _net_k_ < h_sort_net_offs[(_n_) + 1]; _net_k_++)	\
+		h_sort_cmpxchg(_net_a_[h_sort_net_pairs[_net_k_][0]], _net_a_[h_sort_net_pairs[_net_k_][1]], _less_);	\
+} while(0)
+
+/* Branchless compare-exchange: puts smaller element to _x_, and larger to _y_ */
+#define h_sort_cmpxchg(_x_, _y_, _less_) do {				\
+	const bool _cx_lt_ = _less_(_y_, _x_);				\
+	const typeof(_x_) _cx_lo_ = _cx_lt_ ? (_y_) : (_x_);		\
+	const typeof(_x_) _cx_hi_ = _cx_lt_ ? (_x_) : (_y_);		\
+	(_x_) = _cx_lo_;						\
+	(_y_) = _cx_hi_;						\
+} while(0)
+
+#if defined __GNUC__ || defined __clang__
+#define h_sort_net_unroll h_pragma(GCC unroll 256)
+#else
+#define h_sort_net_unroll
+#endif
+
+/* Comparators of sorting networks for 0..32 elements, network for n elements is
+ * h_sort_net_pairs[h_sort_net_offs[n]] .. h_sort_net_pairs[h_sort_net_offs[n + 1] - 1].
+ * Networks are Batcher's odd-even merge sort for the next power of two, without comparators
+ * which touch elements past n. They are optimal for up to 8 elements, for others they use 3-20% more
+ * comparators than best known networks, e.g. 63, 85 and 132 instead of 60, 71 and 120 for 16, 17 and 24 elements */
+static const unsigned short h_sort_net_offs[] = {
+	0, 0, 0, 1, 4, 9, 18, 30, 46, 65, 93, 125, 163, 205, 253, 306, 365, 428, 513, 603, 701,
+	804, 916, 1035, 1162, 1294, 1434, 1581, 1737, 1899, 2070, 2248, 2434, 2625
+};
+
+static const unsigned char h_sort_net_pairs[][2] = {
+	/*  2 */ {0,1},
+	/*  3 */ {0,1}, {0,2}, {1,2},
+	/*  4 */ {0,1}, {2,3}, {0,2}, {1,3}, {1,2},
+	/*  5 */ {0,1}, {2,3}, {0,2}, {1,3}, {1,2}, {0,4}, {2,4}, {1,2}, {3,4},
+	/*  6 */ {0,1}, {2,3}, {4,5}, {0,2}, {1,3}, {1,2}, {0,4}, {1,5}, {2,4}, {3,5}, {1,2}, {3,4},
+	/*  7 */ {0,1}, {2,3}, {4,5}, {0,2}, {1,3}, {4,6}, {1,2}, {5,6}, {0,4}, {1,5}, {2,6}, {2,4}, {3,5}, {1,2},
+		 {3,4}, {5,6},
+	/*  8 */ {0,1}, {2,3}, {4,5}, {6,7}, {0,2}, {1,3}, {4,6}, {5,7}, {1,2}, {5,6}, {0,4}, {1,5}, {2,6}, {3,7},
+		 {2,4}, {3,5}, {1,2}, {3,4}, {5,6},
+	/*  9 */ {0,1}, {2,3}, {4,5}, {6,7}, {0,2}, {1,3}, {4,6}, {5,7}, {1,2}, {5,6}, {0,4}, {1,5}, {2,6}, {3,7},
+		 {2,4}, {3,5}, {1,2}, {3,4}, {5,6}, {0,8}, {4,8}, {2,4}, {3,5}, {6,8}, {1,2}, {3,4}, {5,6}, {7,8},
+	/* 10 */ {0,1}, {2,3}, {4,5}, {6,7}, {8,9}, {0,2}, {1,3}, {4,6}, {5,7}, {1,2}, {5,6}, {0,4}, {1,5}, {2,6},
+		 {3,7}, {2,4}, {3,5}, {1,2}, {3,4}, {5,6}, {0,8}, {1,9}, {4,8}, {5,9}, {2,4}, {3,5}, {6,8}, {7,9},
+		 {1,2}, {3,4}, {5,6}, {7,8},
+	/* 11 */ {0,1}, {2,3}, {4,5}, {6,7}, {8,9}, {0,2}, {1,3}, {4,6}, {5,7}, {8,10}, {1,2}, {5,6}, {9,10}, {0,4},
+		 {1,5}, {2,6}, {3,7}, {2,4}, {3,5}, {1,2}, {3,4}, {5,6}, {9,10}, {0,8}, {1,9}, {2,10}, {4,8}, {5,9},
+		 {6,10}, {2,4}, {3,5}, {6,8}, {7,9}, {1,2}, {3,4}, {5,6}, {7,8}, {9,10},
+	/* 12 */ {0,1}, {2,3}, {4,5}, {6,7}, {8,9}, {10,11}, {0,2}, {1,3}, {4,6}, {5,7}, {8,10}, {9,11}, {1,2},
+		 {5,6}, {9,10}, {0,4}, {1,5}, {2,6}, {3,7}, {2,4}, {3,5}, {1,2}, {3,4}, {5,6}, {9,10}, {0,8}, {1,9},
+		 {2,10}, {3,11}, {4,8}, {5,9}, {6,10}, {7,11}, {2,4}, {3,5}, {6,8}, {7,9}, {1,2}, {3,4}, {5,6},
+		 {7,8}, {9,10},
+	/* 13 */ {0,1}, {2,3}, {4,5}, {6,7}, {8,9}, {10,11}, {0,2}, {1,3}, {4,6}, {5,7}, {8,10}, {9,11}, {1,2},
+		 {5,6}, {9,10}, {0,4}, {1,5}, {2,6}, {3,7}, {8,12}, {2,4}, {3,5}, {10,12}, {1,2}, {3,4}, {5,6},
+		 {9,10}, {11,12}, {0,8}, {1,9}, {2,10}, {3,11}, {4,12}, {4,8}, {5,9}, {6,10}, {7,11}, {2,4}, {3,5},
+		 {6,8}, {7,9}, {10,12}, {1,2}, {3,4}, {5,6}, {7,8}, {9,10}, {11,12},
+	/* 14 */ {0,1}, {2,3}, {4,5}, {6,7}, {8,9}, {10,11}, {12,13}, {0,2}, {1,3}, {4,6}, {5,7}, {8,10}, {9,11},
+		 {1,2}, {5,6}, {9,10}, {0,4}, {1,5}, {2,6}, {3,7}, {8,12}, {9,13}, {2,4}, {3,5}, {10,12}, {11,13},
+		 {1,2}, {3,4}, {5,6}, {9,10}, {11,12}, {0,8}, {1,9}, {2,10}, {3,11}, {4,12}, {5,13}, {4,8}, {5,9},
+		 {6,10}, {7,11}, {2,4}, {3,5}, {6,8}, {7,9}, {10,12}, {11,13}, {1,2}, {3,4}, {5,6}, {7,8}, {9,10},
+		 {11,12},
+	/* 15 */ {0,1}, {2,3}, {4,5}, {6,7}, {8,9}, {10,11}, {12,13}, {0,2}, {1,3}, {4,6}, {5,7}, {8,10}, {9,11},
+		 {12,14}, {1,2}, {5,6}, {9,10}, {13,14}, {0,4}, {1,5}, {2,6}, {3,7}, {8,12}, {9,13}, {10,14}, {2,4},
+		 {3,5}, {10,12}, {11,13}, {1,2}, {3,4}, {5,6}, {9,10}, {11,12}, {13,14}, {0,8}, {1,9}, {2,10},
+		 {3,11}, {4,12}, {5,13}, {6,14}, {4,8}, {5,9}, {6,10}, {7,11}, {2,4}, {3,5}, {6,8}, {7,9}, {10,12},
+		 {11,13}, {1,2}, {3,4}, {5,6}, {7,8}, {9,10}, {11,12}, {13,14},
+	/* 16 */ {0,1}, {2,3}, {4,5}, {6,7}, {8,9}, {10,11}, {12,13}, {14,15}, {0,2}, {1,3}, {4,6}, {5,7}, {8,10},
+		 {9,11}, {12,14}, {13,15}, {1,2}, {5,6}, {9,10}, {13,14}, {0,4}, {1,5}, {2,6}, {3,7}, {8,12}, {9,13},
+		 {10,14}, {11,15}, {2,4}, {3,5}, {10,12}, {11,13}, {1,2}, {3,4}, {5,6}, {9,10}, {11,12}, {13,14},
+		 {0,8}, {1,9}, {2,10}, {3,11}, {4,12}, {5,13}, {6,14}, {7,15}, {4,8}, {5,9}, {6,10}, {7,11}, {2,4},
+		 {3,5}, {6,8}, {7,9}, {10,12}, {11,13}, {1,2}, {3,4}, {5,6}, {7,8}, {9,10}, {11,12}, {13,14},
+	/* 17 */ {0,1}, {2,3}, {4,5}, {6,7}, {8,9}, {10,11}, {12,13}, {14,15}, {0,2}, {1,3}, {4,6}, {5,7}, {8,10},
+		 {9,11}, {12,14}, {13,15}, {1,2}, {5,6}, {9,10}, {13,14}, {0,4}, {1,5}, {2,6}, {3,7}, {8,12}, {9,13},
+		 {10,14}, {11,15}, {2,4}, {3,5}, {10,12}, {11,13}, {1,2}, {3,4}, {5,6}, {9,10}, {11,12}, {13,14},
+		 {0,8}, {1,9}, {2,10}, {3,11}, {4,12}, {5,13}, {6,14}, {7,15}, {4,8}, {5,9}, {6,10}, {7,11}, {2,4},
+		 {3,5}, {6,8}, {7,9}, {10,12}, {11,13}, {1,2}, {3,4}, {5,6}, {7,8}, {9,10}, {11,12}, {13,14}, {0,16},
+		 {8,16}, {4,8}, {5,9}, {6,10}, {7,11}, {12,16}, {2,4}, {3,5}, {6,8}, {7,9}, {10,12}, {11,13},
+		 {14,16}, {1,2}, {3,4}, {5,6}, {7,8}, {9,10}, {11,12}, {13,14}, {15,16},
+	/* 18 */ {0,1}, {2,3}, {4,5}, {6,7}, {8,9}, {10,11}, {12,13}, {14,15}, {16,17}, {0,2}, {1,3}, {4,6}, {5,7},
+		 {8,10}, {9,11}, {12,14}, {13,15}, {1,2}, {5,6}, {9,10}, {13,14}, {0,4}, {1,5}, {2,6}, {3,7}, {8,12},
+		 {9,13}, {10,14}, {11,15}, {2,4}, {3,5}, {10,12}, {11,13}, {1,2}, {3,4}, {5,6}, {9,10}, {11,12},
+		 {13,14}, {0,8}, {1,9}, {2,10}, {3,11}, {4,12}, {5,13}, {6,14}, {7,15}, {4,8}, {5,9}, {6,10}, {7,11},
+		 {2,4}, {3,5}, {6,8}, {7,9}, {10,12}, {11,13}, {1,2}, {3,4}, {5,6}, {7,8}, {9,10}, {11,12}, {13,14},
+		 {0,16}, {1,17}, {8,16}, {9,17}, {4,8}, {5,9}, {6,10}, {7,11}, {12,16}, {13,17}, {2,4}, {3,5}, {6,8},
+		 {7,9}, {10,12}, {11,13}, {14,16}, {15,17}, {1,2}, {3,4}, {5,6}, {7,8}, {9,10}, {11,12}, {13,14},
+		 {15,16},
+	/* 19 */ {0,1}, {2,3}, {4,5}, {6,7}, {8,9}, {10,11}, {12,13}, {14,15}, {16,17}, {0,2}, {1,3}, {4,6}, {5,7},
+		 {8,10}, {9,11}, {12,14}, {13,15}, {16,18}, {1,2}, {5,6}, {9,10}, {13,14}, {17,18}, {0,4}, {1,5},
+		 {2,6}, {3,7}, {8,12}, {9,13}, {10,14}, {11,15}, {2,4}, {3,5}, {10,12}, {11,13}, {1,2}, {3,4}, {5,6},
+		 {9,10}, {11,12}, {13,14}, {17,18}, {0,8}, {1,9}, {2,10}, {3,11}, {4,12}, {5,13}, {6,14}, {7,15},
+		 {4,8}, {5,9}, {6,10}, {7,11}, {2,4}, {3,5}, {6,8}, {7,9}, {10,12}, {11,13}, {1,2}, {3,4}, {5,6},
+		 {7,8}, {9,10}, {11,12}, {13,14}, {17,18}, {0,16}, {1,17}, {2,18}, {8,16}, {9,17}, {10,18}, {4,8},
+		 {5,9}, {6,10}, {7,11}, {12,16}, {13,17}, {14,18}, {2,4}, {3,5}, {6,8}, {7,9}, {10,12}, {11,13},
+		 {14,16}, {15,17}, {1,2}, {3,4}, {5,6}, {7,8}, {9,10}, {11,12}, {13,14}, {15,16}, {17,18},
+	/* 20 */ {0,1}, {2,3}, {4,5}, {6,7}, {8,9}, {10,11}, {12,13}, {14,15}, {16,17}, {18,19}, {0,2}, {1,3},
+		 {4,6}, {5,7}, {8,10}, {9,11}, {12,14}, {13,15}, {16,18}, {17,19}, {1,2}, {5,6}, {9,10}, {13,14},
+		 {17,18}, {0,4}, {1,5}, {2,6}, {3,7}, {8,12}, {9,13}, {10,14}, {11,15}, {2,4}, {3,5}, {10,12},
+		 {11,13}, {1,2}, {3,4}, {5,6}, {9,10}, {11,12}, {13,14}, {17,18}, {0,8}, {1,9}, {2,10}, {3,11},
+		 {4,12}, {5,13}, {6,14}, {7,15}, {4,8}, {5,9}, {6,10}, {7,11}, {2,4}, {3,5}, {6,8}, {7,9}, {10,12},
+		 {11,13}, {1,2}, {3,4}, {5,6}, {7,8}, {9,10}, {11,12}, {13,14}, {17,18}, {0,16}, {1,17}, {2,18},
+		 {3,19}, {8,16}, {9,17}, {10,18}, {11,19}, {4,8}, {5,9}, {6,10}, {7,11}, {12,16}, {13,17}, {14,18},
+		 {15,19}, {2,4}, {3,5}, {6,8}, {7,9}, {10,12}, {11,13}, {14,16}, {15,17}, {1,2}, {3,4}, {5,6}, {7,8},
+		 {9,10}, {11,12}, {13,14}, {15,16}, {17,18},
+	/* 21 */ {0,1}, {2,3}, {4,5}, {6,7}, {8,9}, {10,11}, {12,13}, {14,15}, {16,17}, {18,19}, {0,2}, {1,3},
+		 {4,6}, {5,7}, {8,10}, {9,11}, {12,14}, {13,15}, {16,18}, {17,19}, {1,2}, {5,6}, {9,10}, {13,14},
+		 {17,18}, {0,4}, {1,5}, {2,6}, {3,7}, {8,12}, {9,13}, {10,14}, {11,15}, {16,20}, {2,4}, {3,5},
+		 {10,12}, {11,13}, {18,20}, {1,2}, {3,4}, {5,6}, {9,10}, {11,12}, {13,14}, {17,18}, {19,20}, {0,8},
+		 {1,9}, {2,10}, {3,11}, {4,12}, {5,13}, {6,14}, {7,15}, {4,8}, {5,9}, {6,10}, {7,11}, {2,4}, {3,5},
+		 {6,8}, {7,9}, {10,12}, {11,13}, {18,20}, {1,2}, {3,4}, {5,6}, {7,8}, {9,10}, {11,12}, {13,14},
+		 {17,18}, {19,20}, {0,16}, {1,17}, {2,18}, {3,19}, {4,20}, {8,16}, {9,17}, {10,18}, {11,19}, {12,20},
+		 {4,8}, {5,9}, {6,10}, {7,11}, {12,16}, {13,17}, {14,18}, {15,19}, {2,4}, {3,5}, {6,8}, {7,9},
+		 {10,12}, {11,13}, {14,16}, {15,17}, {18,20}, {1,2}, {3,4}, {5,6}, {7,8}, {9,10}, {11,12}, {13,14},
+		 {15,16}, {17,18}, {19,20},
+	/* 22 */ {0,1}, {2,3}, {4,5}, {6,7}, {8,9}, {10,11}, {12,13}, {14,15}, {16,17}, {18,19}, {20,21}, {0,2},
+		 {1,3}, {4,6}, {5,7}, {8,10}, {9,11}, {12,14}, {13,15}, {16,18}, {17,19}, {1,2}, {5,6}, {9,10},
+		 {13,14}, {17,18}, {0,4}, {1,5}, {2,6}, {3,7}, {8,12}, {9,13}, {10,14}, {11,15}, {16,20}, {17,21},
+		 {2,4}, {3,5}, {10,12}, {11,13}, {18,20}, {19,21}, {1,2}, {3,4}, {5,6}, {9,10}, {11,12}, {13,14},
+		 {17,18}, {19,20}, {0,8}, {1,9}, {2,10}, {3,11}, {4,12}, {5,13}, {6,14}, {7,15}, {4,8}, {5,9},
+		 {6,10}, {7,11}, {2,4}, {3,5}, {6,8}, {7,9}, {10,12}, {11,13}, {18,20}, {19,21}, {1,2}, {3,4}, {5,6},
+		 {7,8}, {9,10}, {11,12}, {13,14}, {17,18}, {19,20}, {0,16}, {1,17}, {2,18}, {3,19}, {4,20}, {5,21},
+		 {8,16}, {9,17}, {10,18}, {11,19}, {12,20}, {13,21}, {4,8}, {5,9}, {6,10}, {7,11}, {12,16}, {13,17},
+		 {14,18}, {15,19}, {2,4}, {3,5}, {6,8}, {7,9}, {10,12}, {11,13}, {14,16}, {15,17}, {18,20}, {19,21},
+		 {1,2}, {3,4}, {5,6}, {7,8}, {9,10}, {11,12}, {13,14}, {15,16}, {17,18}, {19,20},
+	/* 23 */ {0,1}, {2,3}, {4,5}, {6,7}, {8,9}, {10,11}, {12,13}, {14,15}, {16,17}, {18,19}, {20,21}, {0,2},
+		 {1,3}, {4,6}, {5,7}, {8,10}, {9,11}, {12,14}, {13,15}, {16,18}, {17,19}, {20,22}, {1,2}, {5,6},
+		 {9,10}, {13,14}, {17,18}, {21,22}, {0,4}, {1,5}, {2,6}, {3,7}, {8,12}, {9,13}, {10,14}, {11,15},
+		 {16,20}, {17,21}, {18,22}, {2,4}, {3,5}, {10,12}, {11,13}, {18,20}, {19,21}, {1,2}, {3,4}, {5,6},
+		 {9,10}, {11,12}, {13,14}, {17,18}, {19,20}, {21,22}, {0,8}, {1,9}, {2,10}, {3,11}, {4,12}, {5,13},
+		 {6,14}, {7,15}, {4,8}, {5,9}, {6,10}, {7,11}, {2,4}, {3,5}, {6,8}, {7,9}, {10,12}, {11,13}, {18,20},
+		 {19,21}, {1,2}, {3,4}, {5,6}, {7,8}, {9,10}, {11,12}, {13,14}, {17,18}, {19,20}, {21,22}, {0,16},
+		 {1,17}, {2,18}, {3,19}, {4,20}, {5,21}, {6,22}, {8,16}, {9,17}, {10,18}, {11,19}, {12,20}, {13,21},
+		 {14,22}, {4,8}, {5,9}, {6,10}, {7,11}, {12,16}, {13,17}, {14,18}, {15,19}, {2,4}, {3,5}, {6,8},
+		 {7,9}, {10,12}, {11,13}, {14,16}, {15,17}, {18,20}, {19,21}, {1,2}, {3,4}, {5,6}, {7,8}, {9,10},
+		 {11,12}, {13,14}, {15,16}, {17,18}, {19,20}, {21,22},
+	/* 24 */ {0,1}, {2,3}, {4,5}, {6,7}, {8,9}, {10,11}, {12,13}, {14,15}, {16,17}, {18,19}, {20,21}, {22,23},
+		 {0,2}, {1,3}, {4,6}, {5,7}, {8,10}, {9,11}, {12,14}, {13,15}, {16,18}, {17,19}, {20,22}, {21,23},
+		 {1,2}, {5,6}, {9,10}, {13,14}, {17,18}, {21,22}, {0,4}, {1,5}, {2,6}, {3,7}, {8,12}, {9,13},
+		 {10,14}, {11,15}, {16,20}, {17,21}, {18,22}, {19,23}, {2,4}, {3,5}, {10,12}, {11,13}, {18,20},
+		 {19,21}, {1,2}, {3,4}, {5,6}, {9,10}, {11,12}, {13,14}, {17,18}, {19,20}, {21,22}, {0,8}, {1,9},
+		 {2,10}, {3,11}, {4,12}, {5,13}, {6,14}, {7,15}, {4,8}, {5,9}, {6,10}, {7,11}, {2,4}, {3,5}, {6,8},
+		 {7,9}, {10,12}, {11,13}, {18,20}, {19,21}, {1,2}, {3,4}, {5,6}, {7,8}, {9,10}, {11,12}, {13,14},
+		 {17,18}, {19,20}, {21,22}, {0,16}, {1,17}, {2,18}, {3,19}, {4,20}, {5,21}, {6,22}, {7,23}, {8,16},
+		 {9,17}, {10,18}, {11,19}, {12,20}, {13,21}, {14,22}, {15,23}, {4,8}, {5,9}, {6,10}, {7,11}, {12,16},
+		 {13,17}, {14,18}, {15,19}, {2,4}, {3,5}, {6,8}, {7,9}, {10,12}, {11,13}, {14,16}, {15,17}, {18,20},
+		 {19,21}, {1,2}, {3,4}, {5,6}, {7,8}, {9,10}, {11,12}, {13,14}, {15,16}, {17,18}, {19,20}, {21,22},
+	/* 25 */ {0,1}, {2,3}, {4,5}, {6,7}, {8,9}, {10,11}, {12,13}, {14,15}, {16,17}, {18,19}, {20,21}, {22,23},
+		 {0,2}, {1,3}, {4,6}, {5,7}, {8,10}, {9,11}, {12,14}, {13,15}, {16,18}, {17,19}, {20,22}, {21,23},
+		 {1,2}, {5,6}, {9,10}, {13,14}, {17,18}, {21,22}, {0,4}, {1,5}, {2,6}, {3,7}, {8,12}, {9,13},
+		 {10,14}, {11,15}, {16,20}, {17,21}, {18,22}, {19,23}, {2,4}, {3,5}, {10,12}, {11,13}, {18,20},
+		 {19,21}, {1,2}, {3,4}, {5,6}, {9,10}, {11,12}, {13,14}, {17,18}, {19,20}, {21,22}, {0,8}, {1,9},
+		 {2,10}, {3,11}, {4,12}, {5,13}, {6,14}, {7,15}, {16,24}, {4,8}, {5,9}, {6,10}, {7,11}, {20,24},
+		 {2,4}, {3,5}, {6,8}, {7,9}, {10,12}, {11,13}, {18,20}, {19,21}, {22,24}, {1,2}, {3,4}, {5,6}, {7,8},
+		 {9,10}, {11,12}, {13,14}, {17,18}, {19,20}, {21,22}, {23,24}, {0,16}, {1,17}, {2,18}, {3,19},
+		 {4,20}, {5,21}, {6,22}, {7,23}, {8,24}, {8,16}, {9,17}, {10,18}, {11,19}, {12,20}, {13,21}, {14,22},
+		 {15,23}, {4,8}, {5,9}, {6,10}, {7,11}, {12,16}, {13,17}, {14,18}, {15,19}, {20,24}, {2,4}, {3,5},
+		 {6,8}, {7,9}, {10,12}, {11,13}, {14,16}, {15,17}, {18,20}, {19,21}, {22,24}, {1,2}, {3,4}, {5,6},
+		 {7,8}, {9,10}, {11,12}, {13,14}, {15,16}, {17,18}, {19,20}, {21,22}, {23,24},
+	/* 26 */ {0,1}, {2,3}, {4,5}, {6,7}, {8,9}, {10,11}, {12,13}, {14,15}, {16,17}, {18,19}, {20,21}, {22,23},
+		 {24,25}, {0,2}, {1,3}, {4,6}, {5,7}, {8,10}, {9,11}, {12,14}, {13,15}, {16,18}, {17,19}, {20,22},
+		 {21,23}, {1,2}, {5,6}, {9,10}, {13,14}, {17,18}, {21,22}, {0,4}, {1,5}, {2,6}, {3,7}, {8,12},
+		 {9,13}, {10,14}, {11,15}, {16,20}, {17,21}, {18,22}, {19,23}, {2,4}, {3,5}, {10,12}, {11,13},
+		 {18,20}, {19,21}, {1,2}, {3,4}, {5,6}, {9,10}, {11,12}, {13,14}, {17,18}, {19,20}, {21,22}, {0,8},
+		 {1,9}, {2,10}, {3,11}, {4,12}, {5,13}, {6,14}, {7,15}, {16,24}, {17,25}, {4,8}, {5,9}, {6,10},
+		 {7,11}, {20,24}, {21,25}, {2,4}, {3,5}, {6,8}, {7,9}, {10,12}, {11,13}, {18,20}, {19,21}, {22,24},
+		 {23,25}, {1,2}, {3,4}, {5,6}, {7,8}, {9,10}, {11,12}, {13,14}, {17,18}, {19,20}, {21,22}, {23,24},
+		 {0,16}, {1,17}, {2,18}, {3,19}, {4,20}, {5,21}, {6,22}, {7,23}, {8,24}, {9,25}, {8,16}, {9,17},
+		 {10,18}, {11,19}, {12,20}, {13,21}, {14,22}, {15,23}, {4,8}, {5,9}, {6,10}, {7,11}, {12,16},
+		 {13,17}, {14,18}, {15,19}, {20,24}, {21,25}, {2,4}, {3,5}, {6,8}, {7,9}, {10,12}, {11,13}, {14,16},
+		 {15,17}, {18,20}, {19,21}, {22,24}, {23,25}, {1,2}, {3,4}, {5,6}, {7,8}, {9,10}, {11,12}, {13,14},
+		 {15,16}, {17,18}, {19,20}, {21,22}, {23,24},
+	/* 27 */ {0,1}, {2,3}, {4,5}, {6,7}, {8,9}, {10,11}, {12,13}, {14,15}, {16,17}, {18,19}, {20,21}, {22,23},
+		 {24,25}, {0,2}, {1,3}, {4,6}, {5,7}, {8,10}, {9,11}, {12,14}, {13,15}, {16,18}, {17,19}, {20,22},
+		 {21,23}, {24,26}, {1,2}, {5,6}, {9,10}, {13,14}, {17,18}, {21,22}, {25,26}, {0,4}, {1,5}, {2,6},
+		 {3,7}, {8,12}, {9,13}, {10,14}, {11,15}, {16,20}, {17,21}, {18,22}, {19,23}, {2,4}, {3,5}, {10,12},
+		 {11,13}, {18,20}, {19,21}, {1,2}, {3,4}, {5,6}, {9,10}, {11,12}, {13,14}, {17,18}, {19,20}, {21,22},
+		 {25,26}, {0,8}, {1,9}, {2,10}, {3,11}, {4,12}, {5,13}, {6,14}, {7,15}, {16,24}, {17,25}, {18,26},
+		 {4,8}, {5,9}, {6,10}, {7,11}, {20,24}, {21,25}, {22,26}, {2,4}, {3,5}, {6,8}, {7,9}, {10,12},
+		 {11,13}, {18,20}, {19,21}, {22,24}, {23,25}, {1,2}, {3,4}, {5,6}, {7,8}, {9,10}, {11,12}, {13,14},
+		 {17,18}, {19,20}, {21,22}, {23,24}, {25,26}, {0,16}, {1,17}, {2,18}, {3,19}, {4,20}, {5,21}, {6,22},
+		 {7,23}, {8,24}, {9,25}, {10,26}, {8,16}, {9,17}, {10,18}, {11,19}, {12,20}, {13,21}, {14,22},
+		 {15,23}, {4,8}, {5,9}, {6,10}, {7,11}, {12,16}, {13,17}, {14,18}, {15,19}, {20,24}, {21,25},
+		 {22,26}, {2,4}, {3,5}, {6,8}, {7,9}, {10,12}, {11,13}, {14,16}, {15,17}, {18,20}, {19,21}, {22,24},
+		 {23,25}, {1,2}, {3,4}, {5,6}, {7,8}, {9,10}, {11,12}, {13,14}, {15,16}, {17,18}, {19,20}, {21,22},
+		 {23,24}, {25,26},
+	/* 28 */ {0,1}, {2,3}, {4,5}, {6,7}, {8,9}, {10,11}, {12,13}, {14,15}, {16,17}, {18,19}, {20,21}, {22,23},
+		 {24,25}, {26,27}, {0,2}, {1,3}, {4,6}, {5,7}, {8,10}, {9,11}, {12,14}, {13,15}, {16,18}, {17,19},
+		 {20,22}, {21,23}, {24,26}, {25,27}, {1,2}, {5,6}, {9,10}, {13,14}, {17,18}, {21,22}, {25,26}, {0,4},
+		 {1,5}, {2,6}, {3,7}, {8,12}, {9,13}, {10,14}, {11,15}, {16,20}, {17,21}, {18,22}, {19,23}, {2,4},
+		 {3,5}, {10,12}, {11,13}, {18,20}, {19,21}, {1,2}, {3,4}, {5,6}, {9,10}, {11,12}, {13,14}, {17,18},
+		 {19,20}, {21,22}, {25,26}, {0,8}, {1,9}, {2,10}, {3,11}, {4,12}, {5,13}, {6,14}, {7,15}, {16,24},
+		 {17,25}, {18,26}, {19,27}, {4,8}, {5,9}, {6,10}, {7,11}, {20,24}, {21,25}, {22,26}, {23,27}, {2,4},
+		 {3,5}, {6,8}, {7,9}, {10,12}, {11,13}, {18,20}, {19,21}, {22,24}, {23,25}, {1,2}, {3,4}, {5,6},
+		 {7,8}, {9,10}, {11,12}, {13,14}, {17,18}, {19,20}, {21,22}, {23,24}, {25,26}, {0,16}, {1,17},
+		 {2,18}, {3,19}, {4,20}, {5,21}, {6,22}, {7,23}, {8,24}, {9,25}, {10,26}, {11,27}, {8,16}, {9,17},
+		 {10,18}, {11,19}, {12,20}, {13,21}, {14,22}, {15,23}, {4,8}, {5,9}, {6,10}, {7,11}, {12,16},
+		 {13,17}, {14,18}, {15,19}, {20,24}, {21,25}, {22,26}, {23,27}, {2,4}, {3,5}, {6,8}, {7,9}, {10,12},
+		 {11,13}, {14,16}, {15,17}, {18,20}, {19,21}, {22,24}, {23,25}, {1,2}, {3,4}, {5,6}, {7,8}, {9,10},
+		 {11,12}, {13,14}, {15,16}, {17,18}, {19,20}, {21,22}, {23,24}, {25,26},
+	/* 29 */ {0,1}, {2,3}, {4,5}, {6,7}, {8,9}, {10,11}, {12,13}, {14,15}, {16,17}, {18,19}, {20,21}, {22,23},
+		 {24,25}, {26,27}, {0,2}, {1,3}, {4,6}, {5,7}, {8,10}, {9,11}, {12,14}, {13,15}, {16,18}, {17,19},
+		 {20,22}, {21,23}, {24,26}, {25,27}, {1,2}, {5,6}, {9,10}, {13,14}, {17,18}, {21,22}, {25,26}, {0,4},
+		 {1,5}, {2,6}, {3,7}, {8,12}, {9,13}, {10,14}, {11,15}, {16,20}, {17,21}, {18,22}, {19,23}, {24,28},
+		 {2,4}, {3,5}, {10,12}, {11,13}, {18,20}, {19,21}, {26,28}, {1,2}, {3,4}, {5,6}, {9,10}, {11,12},
+		 {13,14}, {17,18}, {19,20}, {21,22}, {25,26}, {27,28}, {0,8}, {1,9}, {2,10}, {3,11}, {4,12}, {5,13},
+		 {6,14}, {7,15}, {16,24}, {17,25}, {18,26}, {19,27}, {20,28}, {4,8}, {5,9}, {6,10}, {7,11}, {20,24},
+		 {21,25}, {22,26}, {23,27}, {2,4}, {3,5}, {6,8}, {7,9}, {10,12}, {11,13}, {18,20}, {19,21}, {22,24},
+		 {23,25}, {26,28}, {1,2}, {3,4}, {5,6}, {7,8}, {9,10}, {11,12}, {13,14}, {17,18}, {19,20}, {21,22},
+		 {23,24}, {25,26}, {27,28}, {0,16}, {1,17}, {2,18}, {3,19}, {4,20}, {5,21}, {6,22}, {7,23}, {8,24},
+		 {9,25}, {10,26}, {11,27}, {12,28}, {8,16}, {9,17}, {10,18}, {11,19}, {12,20}, {13,21}, {14,22},
+		 {15,23}, {4,8}, {5,9}, {6,10}, {7,11}, {12,16}, {13,17}, {14,18}, {15,19}, {20,24}, {21,25},
+		 {22,26}, {23,27}, {2,4}, {3,5}, {6,8}, {7,9}, {10,12}, {11,13}, {14,16}, {15,17}, {18,20}, {19,21},
+		 {22,24}, {23,25}, {26,28}, {1,2}, {3,4}, {5,6}, {7,8}, {9,10}, {11,12}, {13,14}, {15,16}, {17,18},
+		 {19,20}, {21,22}, {23,24}, {25,26}, {27,28},
+	/* 30 */ {0,1}, {2,3}, {4,5}, {6,7}, {8,9}, {10,11}, {12,13}, {14,15}, {16,17}, {18,19}, {20,21}, {22,23},
+		 {24,25}, {26,27}, {28,29}, {0,2}, {1,3}, {4,6}, {5,7}, {8,10}, {9,11}, {12,14}, {13,15}, {16,18},
+		 {17,19}, {20,22}, {21,23}, {24,26}, {25,27}, {1,2}, {5,6}, {9,10}, {13,14}, {17,18}, {21,22},
+		 {25,26}, {0,4}, {1,5}, {2,6}, {3,7}, {8,12}, {9,13}, {10,14}, {11,15}, {16,20}, {17,21}, {18,22},
+		 {19,23}, {24,28}, {25,29}, {2,4}, {3,5}, {10,12}, {11,13}, {18,20}, {19,21}, {26,28}, {27,29},
+		 {1,2}, {3,4}, {5,6}, {9,10}, {11,12}, {13,14}, {17,18}, {19,20}, {21,22}, {25,26}, {27,28}, {0,8},
+		 {1,9}, {2,10}, {3,11}, {4,12}, {5,13}, {6,14}, {7,15}, {16,24}, {17,25}, {18,26}, {19,27}, {20,28},
+		 {21,29}, {4,8}, {5,9}, {6,10}, {7,11}, {20,24}, {21,25}, {22,26}, {23,27}, {2,4}, {3,5}, {6,8},
+		 {7,9}, {10,12}, {11,13}, {18,20}, {19,21}, {22,24}, {23,25}, {26,28}, {27,29}, {1,2}, {3,4}, {5,6},
+		 {7,8}, {9,10}, {11,12}, {13,14}, {17,18}, {19,20}, {21,22}, {23,24}, {25,26}, {27,28}, {0,16},
+		 {1,17}, {2,18}, {3,19}, {4,20}, {5,21}, {6,22}, {7,23}, {8,24}, {9,25}, {10,26}, {11,27}, {12,28},
+		 {13,29}, {8,16}, {9,17}, {10,18}, {11,19}, {12,20}, {13,21}, {14,22}, {15,23}, {4,8}, {5,9}, {6,10},
+		 {7,11}, {12,16}, {13,17}, {14,18}, {15,19}, {20,24}, {21,25}, {22,26}, {23,27}, {2,4}, {3,5}, {6,8},
+		 {7,9}, {10,12}, {11,13}, {14,16}, {15,17}, {18,20}, {19,21}, {22,24}, {23,25}, {26,28}, {27,29},
+		 {1,2}, {3,4}, {5,6}, {7,8}, {9,10}, {11,12}, {13,14}, {15,16}, {17,18}, {19,20}, {21,22}, {23,24},
+		 {25,26}, {27,28},
+	/* 31 */ {0,1}, {2,3}, {4,5}, {6,7}, {8,9}, {10,11}, {12,13}, {14,15}, {16,17}, {18,19}, {20,21}, {22,23},
+		 {24,25}, {26,27}, {28,29}, {0,2}, {1,3}, {4,6}, {5,7}, {8,10}, {9,11}, {12,14}, {13,15}, {16,18},
+		 {17,19}, {20,22}, {21,23}, {24,26}, {25,27}, {28,30}, {1,2}, {5,6}, {9,10}, {13,14}, {17,18},
+		 {21,22}, {25,26}, {29,30}, {0,4}, {1,5}, {2,6}, {3,7}, {8,12}, {9,13}, {10,14}, {11,15}, {16,20},
+		 {17,21}, {18,22}, {19,23}, {24,28}, {25,29}, {26,30}, {2,4}, {3,5}, {10,12}, {11,13}, {18,20},
+		 {19,21}, {26,28}, {27,29}, {1,2}, {3,4}, {5,6}, {9,10}, {11,12}, {13,14}, {17,18}, {19,20}, {21,22},
+		 {25,26}, {27,28}, {29,30}, {0,8}, {1,9}, {2,10}, {3,11}, {4,12}, {5,13}, {6,14}, {7,15}, {16,24},
+		 {17,25}, {18,26}, {19,27}, {20,28}, {21,29}, {22,30}, {4,8}, {5,9}, {6,10}, {7,11}, {20,24},
+		 {21,25}, {22,26}, {23,27}, {2,4}, {3,5}, {6,8}, {7,9}, {10,12}, {11,13}, {18,20}, {19,21}, {22,24},
+		 {23,25}, {26,28}, {27,29}, {1,2}, {3,4}, {5,6}, {7,8}, {9,10}, {11,12}, {13,14}, {17,18}, {19,20},
+		 {21,22}, {23,24}, {25,26}, {27,28}, {29,30}, {0,16}, {1,17}, {2,18}, {3,19}, {4,20}, {5,21}, {6,22},
+		 {7,23}, {8,24}, {9,25}, {10,26}, {11,27}, {12,28}, {13,29}, {14,30}, {8,16}, {9,17}, {10,18},
+		 {11,19}, {12,20}, {13,21}, {14,22}, {15,23}, {4,8}, {5,9}, {6,10}, {7,11}, {12,16}, {13,17},
+		 {14,18}, {15,19}, {20,24}, {21,25}, {22,26}, {23,27}, {2,4}, {3,5}, {6,8}, {7,9}, {10,12}, {11,13},
+		 {14,16}, {15,17}, {18,20}, {19,21}, {22,24}, {23,25}, {26,28}, {27,29}, {1,2}, {3,4}, {5,6}, {7,8},
+		 {9,10}, {11,12}, {13,14}, {15,16}, {17,18}, {19,20}, {21,22}, {23,24}, {25,26}, {27,28}, {29,30},
+	/* 32 */ {0,1}, {2,3}, {4,5}, {6,7}, {8,9}, {10,11}, {12,13}, {14,15}, {16,17}, {18,19}, {20,21}, {22,23},
+		 {24,25}, {26,27}, {28,29}, {30,31}, {0,2}, {1,3}, {4,6}, {5,7}, {8,10}, {9,11}, {12,14}, {13,15},
+		 {16,18}, {17,19}, {20,22}, {21,23}, {24,26}, {25,27}, {28,30}, {29,31}, {1,2}, {5,6}, {9,10},
+		 {13,14}, {17,18}, {21,22}, {25,26}, {29,30}, {0,4}, {1,5}, {2,6}, {3,7}, {8,12}, {9,13}, {10,14},
+		 {11,15}, {16,20}, {17,21}, {18,22}, {19,23}, {24,28}, {25,29}, {26,30}, {27,31}, {2,4}, {3,5},
+		 {10,12}, {11,13}, {18,20}, {19,21}, {26,28}, {27,29}, {1,2}, {3,4}, {5,6}, {9,10}, {11,12}, {13,14},
+		 {17,18}, {19,20}, {21,22}, {25,26}, {27,28}, {29,30}, {0,8}, {1,9}, {2,10}, {3,11}, {4,12}, {5,13},
+		 {6,14}, {7,15}, {16,24}, {17,25}, {18,26}, {19,27}, {20,28}, {21,29}, {22,30}, {23,31}, {4,8},
+		 {5,9}, {6,10}, {7,11}, {20,24}, {21,25}, {22,26}, {23,27}, {2,4}, {3,5}, {6,8}, {7,9}, {10,12},
+		 {11,13}, {18,20}, {19,21}, {22,24}, {23,25}, {26,28}, {27,29}, {1,2}, {3,4}, {5,6}, {7,8}, {9,10},
+		 {11,12}, {13,14}, {17,18}, {19,20}, {21,22}, {23,24}, {25,26}, {27,28}, {29,30}, {0,16}, {1,17},
+		 {2,18}, {3,19}, {4,20}, {5,21}, {6,22}, {7,23}, {8,24}, {9,25}, {10,26}, {11,27}, {12,28}, {13,29},
+		 {14,30}, {15,31}, {8,16}, {9,17}, {10,18}, {11,19}, {12,20}, {13,21}, {14,22}, {15,23}, {4,8},
+		 {5,9}, {6,10}, {7,11}, {12,16}, {13,17}, {14,18}, {15,19}, {20,24}, {21,25}, {22,26}, {23,27},
+		 {2,4}, {3,5}, {6,8}, {7,9}, {10,12}, {11,13}, {14,16}, {15,17}, {18,20}, {19,21}, {22,24}, {23,25},
+		 {26,28}, {27,29}, {1,2}, {3,4}, {5,6}, {7,8}, {9,10}, {11,12}, {13,14}, {15,16}, {17,18}, {19,20},
+		 {21,22}, {23,24}, {25,26}, {27,28}, {29,30},
+};
+
+/* parallel_sort_array_by() implementation */
+#define h_parallel_sort(_arrp_, _less_) do {							\
+	typeof(&(*(_arrp_))[0]) const _psrt_a_ = &(*(_arrp_))[0];				\
+	const size_t _psrt_n_ = UNSAFE_ARRAY_SIZE(*(_arrp_));					\
+	const size_t _psrt_parts_ = h_par_parts(_arrp_);					\
+	typeof(&(*(_arrp_))[0]) const _psrt_tmp_ = _psrt_parts_ > 1 ? malloc(UNSAFE_ARRAY_SIZE_BYTES(*(_arrp_))) : NULL;	\
+	if(!_psrt_tmp_) {									\
+		h_sort_range(_psrt_a_, _psrt_n_, _less_);					\
+		break;										\
+	}											\
+												\
+	size_t _psrt_bnd_[_psrt_parts_ + 1];							\
+	for(size_t _psrt_i_ = 0; _psrt_i_ <= _psrt_parts_; _psrt_i_++)				\
+		_psrt_bnd_[_psrt_i_] = h_par_split(_arrp_, _psrt_parts_, _psrt_i_);		\
+												\
+	POOR_OMP(parallel for schedule(static, 1))						\
+	for(size_t _psrt_i_ = 0; _psrt_i_ < _psrt_parts_; _psrt_i_++)				\
+		h_sort_range(&_psrt_a_[_psrt_bnd_[_psrt_i_]],					\
+			_psrt_bnd_[_psrt_i_ + 1] - _psrt_bnd_[_psrt_i_], _less_);		\
+												\
+	typeof(&(*(_arrp_))[0]) _psrt_src_ = _psrt_a_, _psrt_dst_ = _psrt_tmp_;		\
+	for(size_t _psrt_w_ = 1; _psrt_w_ < _psrt_parts_; _psrt_w_ *= 2) {			\
+		POOR_OMP(parallel for schedule(static, 1))					\
+		for(size_t _psrt_i_ = 0; _psrt_i_ < _psrt_parts_; _psrt_i_ += 2 * _psrt_w_) {	\
+			const size_t _psrt_mid_ = h_copy_min(_psrt_i_ + _psrt_w_, _psrt_parts_);	\
+			const size_t _psrt_end_ = h_copy_min(_psrt_i_ + 2 * _psrt_w_, _psrt_parts_);	\
+			h_sort_merge(_psrt_src_, _psrt_dst_, _psrt_bnd_[_psrt_i_],		\
+				_psrt_bnd_[_psrt_mid_], _psrt_bnd_[_psrt_end_], _less_);	\
+		}									\
+		h_sort_swap(_psrt_src_, _psrt_dst_);						\
+	}											\
+												\
+	if(_psrt_src_ != _psrt_a_)								\
+		memcpy(_psrt_a_, _psrt_src_, _psrt_n_ * sizeof(*_psrt_a_));			\
+	free(_psrt_tmp_);									\
+} while(0)
+
+/* radix_sort_array() implementation.
+ * Calls _macro_(suffix, type, key type, category) for each supported element type.
+ * Key is an unsigned integer of the same size as element, which has the same order as elements */
+#define h_radix_types(_macro_)						\
+	_macro_(c,   char,               unsigned char,      c)		\
+	_macro_(sc,  signed char,        unsigned char,      s)		\
+	_macro_(uc,  unsigned char,      unsigned char,      u)		\
+	_macro_(ss,  short,              unsigned short,     s)		\
+	_macro_(us,  unsigned short,     unsigned short,     u)		\
+	_macro_(si,  int,                unsigned,           s)		\
+	_macro_(ui,  unsigned,           unsigned,           u)		\
+	_macro_(sl,  long,               unsigned long,      s)		\
+	_macro_(ul,  unsigned long,      unsigned long,      u)		\
+	_macro_(sll, long long,          unsigned long long, s)		\
+	_macro_(ull, unsigned long long, unsigned long long, u)		\
+	_macro_(f,   float,              uint32_t,           f)		\
+	_macro_(d,   double,             uint64_t,           f)
+
+#define h_radix_generic(_arrp_) _Generic((*(_arrp_))[0],		\
+	char:			h_radix_sort_c,				\
+	signed char:		h_radix_sort_sc,			\
+	unsigned char:		h_radix_sort_uc,			\
+	short:			h_radix_sort_ss,			\
+	unsigned short:		h_radix_sort_us,			\
+	int:			h_radix_sort_si,			\
+	unsigned:		h_radix_sort_ui,			\
+	long:			h_radix_sort_sl,			\
+	unsigned long:		h_radix_sort_ul,			\
+	long long:		h_radix_sort_sll,			\
+	unsigned long long:	h_radix_sort_ull,			\
+	float:			h_radix_sort_f,				\
+	double:			h_radix_sort_d)
+
+/* Key of each category: sign bit of signed integers is flipped, unsigned integers are used as is,
+ * for floating point numbers all bits of negative numbers are flipped, and sign bit of positive ones */
+#define h_radix_sign(_key_type_) ((_key_type_)1 << (sizeof(_key_type_) * 8 - 1))
+
+#define h_radix_map_s(_key_type_, _v_) return (_key_type_)((_key_type_)(_v_) ^ h_radix_sign(_key_type_));
+#define h_radix_map_u(_key_type_, _v_) return (_v_);
+#define h_radix_map_c(_key_type_, _v_) return (_key_type_)((_key_type_)(_v_) ^ (CHAR_MIN < 0 ? h_radix_sign(_key_type_) : 0));
+
+#define h_radix_map_f(_key_type_, _v_)						\
+	_key_type_ _k_;									\
+	static_assert(sizeof(_k_) == sizeof(_v_), "unsupported floating point format");	\
+	memcpy(&_k_, &(_v_), sizeof(_k_));						\
+	return _k_ & h_radix_sign(_key_type_) ? ~_k_ : _k_ | h_radix_sign(_key_type_);
+
+#define h_define_radix_sort(_sfx_, _type_, _key_type_, _cat_)					\
+static inline _key_type_ h_radix_key_ ## _sfx_(_type_ v) {					\
+	h_radix_map_ ## _cat_(_key_type_, v)							\
+}												\
+												\
+static inline bool h_radix_less_ ## _sfx_(_type_ a, _type_ b) {				\
+	return h_radix_key_ ## _sfx_(a) < h_radix_key_ ## _sfx_(b);				\
+}												\
+												\
+static inline void h_radix_sort_ ## _sfx_(size_t n, _type_ *a) {				\
+	_type_ (*tmp)[n];									\
+	if(n < POOR_RADIX_MIN || !malloc_array(tmp)) {						\
+		h_sort_range(a, n, h_radix_less_ ## _sfx_);					\
+		return;										\
+	}											\
+												\
+	size_t hist[sizeof(_type_)][256] = {0};							\
+	for(size_t i = 0; i < n; i++) {								\
+		const _key_type_ k = h_radix_key_ ## _sfx_(a[i]);				\
+		for(size_t b = 0; b < sizeof(_type_); b++)					\
+			hist[b][(k >> (b * 8)) & 0xff]++;					\
+	}											\
+												\
+	_type_ *src = a, *dst = *tmp;								\
+	const _key_type_ first = h_radix_key_ ## _sfx_(a[0]);					\
+	for(size_t b = 0; b < sizeof(_type_); b++) {						\
+		size_t *const offs = hist[b];							\
+		if(offs[(first >> (b * 8)) & 0xff] == n)					\
+			continue;								\
+												\
+		for(size_t d = 0, off = 0; d < 256; d++) {					\
+			const size_t cnt = offs[d];						\
+			offs[d] = off;								\
+			off += cnt;								\
+		}										\
+		for(size_t i = 0; i < n; i++)							\
+			dst[offs[(h_radix_key_ ## _sfx_(src[i]) >> (b * 8)) & 0xff]++] = src[i];	\
+												\
+		_type_ *const swp = src;							\
+		src = dst;									\
+		dst = swp;									\
+	}											\
+												\
+	if(src != a)										\
+		memcpy(a, src, n * sizeof(*a));							\
+	free(tmp);										\
+}
+
+h_radix_types(h_define_radix_sort)
+
+#endif // POOR_SORT_H
@@ -0,0 +1,299 @@
+// SPDX-License-Identifier: MIT
+/*
+ * Copyright (C) 2020 Alexandrov Stanislav <lightofmysoul@gmail.com>
+ */
+#ifndef POOR_VEC_H
+#define POOR_VEC_H
+
+#include <poor_array.h>
+#include <poor_traits.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Growable vector.
+ * A vector is a struct with a pointer to heap memory, a number of live elements (len) and a number of allocated elements (cap).
+ * Live elements are exposed as a pointer to array T (*)[len] by vec_arrview(), so all array macros work on them:
+
+	make_vec(v, int);
+	vec_push(v, 3);
+	vec_push(v, 1);
+	sort_array(vec_arrview(v));
+	print_array(vec_arrview(v)); //prints: [1,3]
+	vec_free(v);
+
+ * Vector macros take the vector itself (an lvalue), not a pointer to it. Pass (*vp) when vector is accessed by a pointer.
+ * The vector expression is evaluated only once.
+ *
+ * Macros which allocate memory return false when allocation fails, and leave the vector unchanged in this case.
+ * Capacity grows geometrically, so pushing n elements one by one takes O(n) time and O(log n) reallocations.
+ * Growth moves elements, so pointers and arrviews to the elements are invalidated by any macro which may allocate. */
+
+/* Capacity of a vector after the first allocation by vec_push() and others */
+#ifndef POOR_VEC_MIN_CAP
+#define POOR_VEC_MIN_CAP 8
+#endif
+
+/* vec_t(_type_)
+ * Type of a vector of elements of type (_type_). Each vec_t() is a distinct anonymous struct type,
+ * so use typedef to pass vectors between functions:
+
+	typedef vec_t(struct point) point_vec;
+	static void add_point(point_vec *pv, struct point p) { vec_push(*pv, p); }
+ */
+#define vec_t(_type_) struct { _type_ *data; size_t len, cap; }
+
+/* make_vec(_name_, _type_)
+ * Declares an empty vector (_name_) of elements of type (_type_). An empty vector doesn't allocate memory.
+ * Any zero-initialized vec_t() is an empty vector as well.
+ */
+#define make_vec(_name_, _type_) vec_t(_type_) _name_ = {0}
+
+/* vec_arrview(_vec_), make_vec_arrview(_name_, _vec_)
+ * Returns a pointer to array T (*)[len] over live elements of a vector,
+ * or declares such pointer with name (_name_).
+ * Arrview is valid until the next macro which changes size of the vector.
+ * Arrays of zero size are not allowed in C, so don't make an arrview of an empty vector,
+ * check length of the vector first. This is checked at run-time with RUNTIME_CHECK.
+ * example:
+
+	make_vec(v, long);
+	vec_append_array(v, (long[]){5, 6, 7});
+	make_vec_arrview(view, v);
+	foreach_array_ref(view, ref)
+		*ref *= 2;
+	print_array(view); //prints: [10,12,14]
+ */
+#define vec_arrview(_vec_) __extension__ ({							\
+	typeof(&(_vec_)) _varv_ = &(_vec_);							\
+	(void)h_vec_chk_view("vec_arrview()", _varv_);						\
+	(typeof(_varv_->data[0]) (*)[_varv_->len])_varv_->data;					\
+})
+
+#define make_vec_arrview(_name_, _vec_)								\
+	typeof(&(_vec_)) const _name_ ## _vecp_ = &(_vec_);					\
+	typeof(_name_ ## _vecp_->data[0]) (*_name_)						\
+		[((void)h_vec_chk_view("make_vec_arrview()", _name_ ## _vecp_), _name_ ## _vecp_->len)] = (void*)_name_ ## _vecp_->data
+
+/* vec_push(_vec_, _val_)
+ * Appends value (_val_) to the end of the vector. Returns true on success.
+ * (_val_) is copied before the vector grows, so it may refer to an element of the same vector.
+ */
+#define vec_push(_vec_, ...) __extension__ ({								\
+	typeof(&(_vec_)) _vpush_ = &(_vec_);								\
+	const typeof(_vpush_->data[0]) _vpush_val_ = (__VA_ARGS__);					\
+	const bool _vpush_ok_ = _vpush_->len < _vpush_->cap || h_vec_grow(_vpush_, _vpush_->len + 1);	\
+	if(_vpush_ok_)											\
+		_vpush_->data[_vpush_->len++] = _vpush_val_;						\
+	_vpush_ok_;											\
+})
+
+/* vec_pop(_vec_)
+ * Removes the last element of a non-empty vector and returns it. Memory is not released.
+ */
+#define vec_pop(_vec_) __extension__ ({						\
+	typeof(&(_vec_)) _vpop_ = &(_vec_);					\
+	(void)h_vec_chk_index("vec_pop()", _vpop_, 0, _vpop_->len);		\
+	_vpop_->data[--_vpop_->len];						\
+})
+
+/* vec_insert(_vec_, _idx_, _val_)
+ * Inserts value (_val_) before element with index (_idx_), moving following elements towards the end.
+ * (_idx_) may be equal to the length of the vector, then value is appended. Returns true on success.
+ * Unlike array_insert(), the last element is never lost, the vector grows instead.
+ */
+#define vec_insert(_vec_, _idx_, ...) __extension__ ({							\
+	typeof(&(_vec_)) _vins_ = &(_vec_);								\
+	const size_t _vins_idx_ = (_idx_);								\
+	const typeof(_vins_->data[0]) _vins_val_ = (__VA_ARGS__);					\
+	(void)h_vec_chk_index("vec_insert()", _vins_, _vins_idx_, _vins_->len + 1);			\
+	const bool _vins_ok_ = _vins_->len < _vins_->cap || h_vec_grow(_vins_, _vins_->len + 1);	\
+	if(_vins_ok_) {											\
+		memmove(&_vins_->data[_vins_idx_ + 1], &_vins_->data[_vins_idx_],			\
+			(_vins_->len - _vins_idx_) * sizeof(_vins_->data[0]));				\
+		_vins_->data[_vins_idx_] = _vins_val_;							\
+		_vins_->len++;										\
+	}												\
+	_vins_ok_;											\
+})
+
+/* vec_insert_array(_vec_, _idx_, _arrm_src_)
+ * Inserts all elements of array (_arrm_src_) before element with index (_idx_). Returns true on success.
+ * Elements are converted to type of vector elements if types differ, like copy_array() does.
+ * Source array should not point into the same vector.
+ * example:
+
+	make_vec(v, int);
+	vec_append_array(v, (int[]){0, 1, 2});
+	vec_insert_array(v, 1, (short[]){7, 8});
+	print_array(vec_arrview(v)); //prints: [0,7,8,1,2]
+ */
+#define vec_insert_array(_vec_, _idx_, ...) h_vec_insert_array("vec_insert_array()", _vec_, (_idx_), false, __VA_ARGS__)
+
+/* vec_append_array(_vec_, _arrm_src_)
+ * Appends all elements of array (_arrm_src_) to the end of the vector. Returns true on success.
+ */
+#define vec_append_array(_vec_, ...) h_vec_insert_array("vec_append_array()", _vec_, 0, true, __VA_ARGS__)
+
+/* vec_erase(_vec_, _idx_)
+ * Removes element with index (_idx_), moving following elements towards the front. Memory is not released.
+ */
+#define vec_erase(_vec_, _idx_) __extension__ ({ const size_t _verase_idx_ = (_idx_);	\
+	vec_erase_range(_vec_, _verase_idx_, _verase_idx_ + 1); })
+
+/* vec_erase_range(_vec_, _begin_, _end_)
+ * Removes elements with indexes in range [_begin_, _end_), moving following elements towards the front.
+ */
+#define vec_erase_range(_vec_, _begin_, _end_) do {							\
+	typeof(&(_vec_)) _vrng_ = &(_vec_);								\
+	const size_t _vrng_b_ = (_begin_), _vrng_e_ = (_end_);						\
+	(void)h_vec_chk_range("vec_erase_range()", _vrng_, _vrng_b_, _vrng_e_);				\
+	if(_vrng_b_ < _vrng_e_) {									\
+		memmove(&_vrng_->data[_vrng_b_], &_vrng_->data[_vrng_e_],				\
+			(_vrng_->len - _vrng_e_) * sizeof(_vrng_->data[0]));				\
+		_vrng_->len -= _vrng_e_ - _vrng_b_;							\
+	}												\
+} while(0)
+
+/* vec_resize(_vec_, _len_, _val_)
+ * Changes length of the vector to (_len_). New elements are set to (_val_), extra elements are dropped.
+ * Returns true on success.
+ */
+#define vec_resize(_vec_, _len_, ...) __extension__ ({							\
+	typeof(&(_vec_)) _vrsz_ = &(_vec_);								\
+	const size_t _vrsz_len_ = (_len_);								\
+	const typeof(_vrsz_->data[0]) _vrsz_val_ = (__VA_ARGS__);					\
+	const bool _vrsz_ok_ = _vrsz_len_ <= _vrsz_->cap || h_vec_grow(_vrsz_, _vrsz_len_);		\
+	if(_vrsz_ok_) {											\
+		for(size_t _vrsz_i_ = _vrsz_->len; _vrsz_i_ < _vrsz_len_; _vrsz_i_++)			\
+			_vrsz_->data[_vrsz_i_] = _vrsz_val_;						\
+		_vrsz_->len = _vrsz_len_;								\
+	}												\
+	_vrsz_ok_;											\
+})
+
+/* vec_reserve(_vec_, _cap_)
+ * Makes capacity of the vector at least (_cap_) elements, so next pushes up to this size don't allocate.
+ * Returns true on success.
+ */
+#define vec_reserve(_vec_, _cap_) __extension__ ({	\
+	typeof(&(_vec_)) _vrsv_ = &(_vec_);		\
+	h_vec_realloc(_vrsv_, (_cap_), false);		\
+})
+
+/* vec_shrink_to_fit(_vec_)
+ * Reduces capacity of the vector to it's length. Memory of an empty vector is released.
+ * Returns true on success, on failure the vector keeps it's memory.
+ */
+#define vec_shrink_to_fit(_vec_) __extension__ ({	\
+	typeof(&(_vec_)) _vshr_ = &(_vec_);		\
+	h_vec_realloc(_vshr_, _vshr_->len, true);	\
+})
+
+/* vec_clear(_vec_)
+ * Removes all elements. Memory is not released.
+ */
+#define vec_clear(_vec_) ((void)((_vec_).len = 0))
+
+/* vec_free(_vec_)
+ * Releases memory of the vector, vector becomes empty and may be used again.
+ */
+#define vec_free(_vec_) do {			\
+	typeof(&(_vec_)) _vfree_ = &(_vec_);	\
+	free(_vfree_->data);			\
+	_vfree_->data = NULL;			\
+	_vfree_->len = _vfree_->cap = 0;	\
+} while(0)
+
+/****** Implementation ******/
+
+/* Returns capacity for at least (need) elements, growing current capacity at least twice */
+static inline size_t h_vec_next_cap(size_t cap, size_t need) {
+	size_t next = cap < POOR_VEC_MIN_CAP ? POOR_VEC_MIN_CAP : cap;
+	while(next < need)
+		next = next > SIZE_MAX / 2 ? need : next * 2;
+	return next;
+}
+
+/* Reallocates memory block to (cap) elements, returns NULL on failure or overflow */
+static inline void *h_vec_realloc_fn(void *data, size_t cap, size_t el_size) {
+	if(cap > SIZE_MAX / el_size)
+		return NULL;
+	return realloc(data, cap * el_size);
+}
+
+/* Sets capacity of a vector pointed by (_vp_) to (_cap_) elements.
+ * If (_shrink_) is false, capacity is only increased. Zero capacity releases the memory */
+#define h_vec_realloc(_vp_, _cap_, _shrink_) __extension__ ({				\
+	const size_t _vre_cap_ = (_cap_);							\
+	bool _vre_ok_ = (_shrink_) ? _vre_cap_ == (_vp_)->cap : _vre_cap_ <= (_vp_)->cap;	\
+	if(!_vre_ok_ && !_vre_cap_) {								\
+		free((_vp_)->data);								\
+		(_vp_)->data = NULL;								\
+		(_vp_)->cap = 0;								\
+		_vre_ok_ = true;								\
+	} else if(!_vre_ok_) {									\
+		void *const _vre_p_ = h_vec_realloc_fn((_vp_)->data, _vre_cap_, sizeof((_vp_)->data[0]));	\
+		if(_vre_p_) {									\
+			(_vp_)->data = _vre_p_;							\
+			(_vp_)->cap = _vre_cap_;						\
+			_vre_ok_ = true;							\
+		}										\
+	}											\
+	_vre_ok_;										\
+})
+
+/* Grows capacity of a vector pointed by (_vp_) geometrically to hold at least (_need_) elements */
+#define h_vec_grow(_vp_, _need_) h_vec_realloc(_vp_, h_vec_next_cap((_vp_)->cap, (_need_)), false)
+
+/* vec_insert_array() and vec_append_array() implementation */
+#define h_vec_insert_array(_macro_name_, _vec_, _idx_, _at_end_, ...) __extension__ ({				\
+	typeof(&(_vec_)) _via_ = &(_vec_);										\
+	const make_arrview_full(_via_src_, __VA_ARGS__);								\
+	const size_t _via_n_ = UNSAFE_ARRAY_SIZE(*_via_src_);								\
+	const size_t _via_idx_ = (_at_end_) ? _via_->len : (_idx_);							\
+	(void)h_vec_chk_index(_macro_name_, _via_, _via_idx_, _via_->len + 1);						\
+	const bool _via_ok_ = _via_->cap - _via_->len >= _via_n_ || h_vec_grow(_via_, _via_->len + _via_n_);		\
+	if(_via_ok_ && _via_n_) {											\
+		memmove(&_via_->data[_via_idx_ + _via_n_], &_via_->data[_via_idx_],					\
+			(_via_->len - _via_idx_) * sizeof(_via_->data[0]));						\
+		typeof(_via_->data[0]) (*const _via_dst_)[_via_n_] = (void*)&_via_->data[_via_idx_];			\
+		unsafe_copy_array(_via_dst_, _via_src_);								\
+		_via_->len += _via_n_;											\
+	}														\
+	_via_ok_;													\
+})
+
+/* Checks that the vector is not empty, so arrview of it has non-zero size */
+#define h_vec_chk_view(_macro_name_, _vp_) \
+	POOR_ARR_CHK_SEL(h_vec_chk_none, h_vec_chk_none, h_vec_chk_view_dyn)(_macro_name_, _vp_)
+
+/* Checks that (_idx_) is less than (_end_) */
+#define h_vec_chk_index(_macro_name_, _vp_, _idx_, _end_) \
+	POOR_ARR_CHK_SEL(h_vec_chk_none, h_vec_chk_none, h_vec_chk_index_dyn)(_macro_name_, _vp_, _idx_, _end_)
+
+/* Checks that range [_begin_, _end_) is inside of the vector */
+#define h_vec_chk_range(_macro_name_, _vp_, _begin_, _end_) \
+	POOR_ARR_CHK_SEL(h_vec_chk_none, h_vec_chk_none, h_vec_chk_range_dyn)(_macro_name_, _vp_, _begin_, _end_)
+
+#define h_vec_chk_none(...) 0
+#define h_vec_chk_index_dyn(_macro_name_, _vp_, _idx_, _end_) (			\
+	ARR_ASSERT_MSG((_idx_) < (_end_),						\
+		CRED _macro_name_ ": Index is out of vector"				\
+		" (index:", (_idx_), " length:", (_vp_)->len, ")"			\
+		" at " FILE_AND_LINE CRESET), 0)
+
+#define h_vec_chk_view_dyn(_macro_name_, _vp_) (					\
+	ARR_ASSERT_MSG((_vp_)->len > 0,							\
+		CRED _macro_name_ ": Arrview of an empty vector"			\
+		" at " FILE_AND_LINE CRESET), 0)
+
+#define h_vec_chk_range_dyn(_macro_name_, _vp_, _begin_, _end_) (			\
+	ARR_ASSERT_MSG((_begin_) <= (_end_) && (_end_) <= (_vp_)->len,		\
+		CRED _macro_name_ ": Range is out of vector"				\
+		" (begin:", (_begin_), " end:", (_end_), " length:", (_vp_)->len, ")"	\
+		" at " FILE_AND_LINE CRESET), 0)
+
+#endif // POOR_VEC_H
@@ -0,0 +1,7 @@
+#include <poor_numeric.h>
+
+int main(void) {
+	int dst[4], a[3] = {1, 2, 3}, b[3] = {4, 5, 6};
+	array_add(dst, a, b);
+	return 0;
+}
@@ -0,0 +1,6 @@
+#include <poor_atomic.h>
+
+int main(void) {
+	unsigned h[4] = {0};
+	return (int)array_atomic_fetch_add(h, 4, 1);
+}
@@ -0,0 +1,7 @@
+#include <poor_atomic.h>
+
+int main(void) {
+	uint64_t b[4] = {0};
+	array_atomic_set_bit(b, 1000);
+	return (int)b[0];
+}
@@ -0,0 +1,7 @@
+#include <poor_bits.h>
+
+int main(void) {
+	int a[2] = {1, 2}, b[2] = {2, 3}, d[2];
+	array_bits_and(d, a, b);
+	return d[0];
+}
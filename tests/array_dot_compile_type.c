@@ -0,0 +1,7 @@
+#include <poor_numeric.h>
+
+int main(void) {
+	int a[3] = {1, 2, 3};
+	long b[3] = {4, 5, 6};
+	return (int)array_dot(a, b);
+}
@@ -0,0 +1,9 @@
+#define POOR_BITWISE_TYPES(_x_) _x_(struct rgb)
+struct rgb { unsigned char r, g, b; };
+#include <poor_algo.h>
+
+int main(void) {
+	struct rgb a[2] = {0};
+	int b[2] = {0};
+	return array_equal(a, b);
+}
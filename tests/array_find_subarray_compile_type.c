@@ -0,0 +1,7 @@
+#include <poor_search.h>
+
+int main(void) {
+	int a[3] = {1, 2, 3};
+	unsigned b[2] = {2, 3};
+	return array_find_subarray(a, b) != NULL;
+}
@@ -0,0 +1,7 @@
+#include <poor_array.h>
+
+int main(void) {
+	int a[10] = {0};
+	make_arrview_stride(view, 1, 4, 3, a);
+	return view.ptr[0];
+}
@@ -0,0 +1,161 @@
+#include <stdint.h>
+
+struct rgb { uint8_t r, g, b; };
+#define POOR_BITWISE_TYPES(_x_) _x_(struct rgb)
+
+#include <poor_algo.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#undef NDEBUG
+
+#define add(acc, val) ((acc) + (val))
+#define max(acc, val) ((acc) > (val) ? (acc) : (val))
+#define append_digit(acc, val) ((acc) * 10 + (val))
+
+struct pt { int x, y; };
+static struct pt pt_add(struct pt a, struct pt b) { return (struct pt){a.x + b.x, a.y + b.y}; }
+
+static int array_reduce_test(void) {
+	//constant size array
+	const int a[] = {1, 5, 3, 2};
+	assert(array_reduce(a, 0L, add) == 11);
+	assert(array_reduce(a, INT_MIN, max) == 5);
+	//order of elements is preserved
+	assert(array_reduce(&a, 0, append_digit) == 1532);
+
+	//pointer to VLA
+	int (*v)[(size_t){100}] = malloc_array(v);
+	assert(v);
+	foreach_array_ref(v, ref)
+		*ref = (int)array_ref_index(v, ref);
+	assert(array_reduce(v, 0UL, add) == 4950);
+	free(v);
+
+	//array of structs with a function
+	struct pt pts[] = {{1, 2}, {3, 4}, {5, 6}};
+	assert(array_reduce(pts, (struct pt){0}, pt_add).y == 12);
+
+	//array view
+	make_arrview_last(a_last, 2, a);
+	assert(array_reduce(a_last, 0, add) == 5);
+
+	return 0;
+}
+
+static int array_equal_test(void) {
+	//constant size arrays of same and different types
+	const uint32_t prev[] = {1, 2, 3};
+	uint32_t cur[] = {1, 2, 3};
+	assert(array_equal(prev, cur));
+	cur[2] = 4;
+	assert(!array_equal(prev, &cur));
+	const double d[] = {1.0, 2.0, 3.0};
+	assert(array_equal(prev, d));
+	assert(!array_equal(prev, (uint32_t[]){1, 2}));
+
+	//floating point elements are compared by value
+	const double z[] = {0.0, NAN}, nz[] = {-0.0, NAN};
+	make_arrview_first(z_first, 1, z);
+	make_arrview_first(nz_first, 1, nz);
+	assert(array_equal(z_first, nz_first));
+	assert(!array_equal(z, nz));
+
+	//pointers to VLA
+	long (*a)[(size_t){1000}] = malloc_array(a);
+	long (*b)[(size_t){1000}] = malloc_array(b);
+	assert(a && b);
+	foreach_array_ref(a, ref)
+		*ref = (long)array_ref_index(a, ref);
+	copy_array(b, a);
+	assert(array_equal(a, b));
+	(*b)[999] = 0;
+	assert(!array_equal(a, b));
+	make_arrview_first(b_first, 999, b);
+	assert(!array_equal(a, b_first));
+	free(b);
+	free(a);
+
+	//structs listed in POOR_BITWISE_TYPES
+	struct rgb p1[] = {{1, 2, 3}, {4, 5, 6}}, p2[] = {{1, 2, 3}, {4, 5, 6}};
+	assert(array_equal(p1, p2));
+	p2[1].b = 7;
+	assert(!array_equal(p1, p2));
+
+	return 0;
+}
+
+static int array_compare_test(void) {
+	const int a[] = {1, 2, 3}, b[] = {1, 3}, c[] = {1, 2};
+	assert(array_compare(a, b) == -1);
+	assert(array_compare(b, a) == 1);
+	assert(array_compare(a, c) == 1);
+	assert(array_compare(c, a) == -1);
+	assert(array_compare(a, a) == 0);
+
+	//elements are compared as numbers, not as bytes
+	const int neg[] = {-1}, pos[] = {1};
+	assert(array_compare(neg, pos) == -1);
+	const uint32_t big[] = {0x100}, small[] = {0xff};
+	assert(array_compare(big, small) == 1);
+
+	//different element types
+	const float f[] = {1.0f, 2.5f};
+	assert(array_compare(c, f) == -1);
+
+	//mismatch far from the beginning
+	uint16_t (*x)[(size_t){5000}] = calloc(1, sizeof(*x));
+	uint16_t (*y)[(size_t){5000}] = calloc(1, sizeof(*y));
+	assert(x && y);
+	assert(array_compare(x, y) == 0);
+	(*x)[4321] = 0x100;
+	(*y)[4321] = 0xff;
+	assert(array_compare(x, y) == 1);
+	assert(array_compare(y, x) == -1);
+	free(y);
+	free(x);
+
+	//structs listed in POOR_BITWISE_TYPES are ordered by bytes
+	struct rgb p1[] = {{1, 2, 3}, {4, 5, 6}}, p2[] = {{1, 2, 3}, {4, 5, 7}};
+	assert(array_compare(p1, p2) == -1);
+	assert(array_compare(p2, p1) == 1);
+
+	return 0;
+}
+
+typedef int test_fn (void);
+
+#define TEST_FN(fn) {#fn, fn}
+static struct tests_struct {
+	const char *test_name;
+	test_fn *fn;
+} tests[] = {
+	TEST_FN(array_reduce_test),
+	TEST_FN(array_equal_test),
+	TEST_FN(array_compare_test),
+};
+
+static void usage(void) {
+	fprintf(stderr, "usage: this_program [test_name]\n\n"
+		   "available tests:\n");
+
+	for(struct tests_struct *cur = &tests[0]; cur != &tests[sizeof(tests) / sizeof(tests[0])]; cur++ ){
+		fprintf(stderr, "\t%s\n", cur->test_name);
+	}
+}
+
+int main(int argc, char **argv) {
+	if(argc != 2)
+		return usage(), 1;
+
+	for(struct tests_struct *cur = &tests[0]; cur != &tests[sizeof(tests) / sizeof(tests[0])]; cur++ ){
+		if(!strcmp(argv[1], cur->test_name)) {
+			return cur->fn();
+		}
+	}
+
+	return fprintf(stderr, "No test found with name: \"%s\"\n", argv[1]), 1;
+}
@@ -0,0 +1,188 @@
+#include <poor_arena.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#undef NDEBUG
+
+#define THREADS 4
+
+static size_t chunks_count(const poor_arena *arena) {
+	size_t cnt = 0;
+	for(const struct h_arena_chunk *c = arena->chunk; c; c = c->prev)
+		cnt++;
+	return cnt;
+}
+
+static int arena_alloc_test(void) {
+	poor_arena arena = {0};
+	assert(!arena.chunk);
+
+	//consecutive allocations are bumps in a single chunk
+	char (*c)[3] = arena_alloc_array(&arena, c);
+	double (*d)[5] = arena_alloc_array(&arena, d);
+	assert(c && d);
+	assert((uintptr_t)d % _Alignof(double) == 0);
+	assert((char*)d >= *c + 3 && (char*)d < *c + 3 + _Alignof(double));
+	assert(chunks_count(&arena) == 1);
+	fill_array(d, 1.5);
+	copy_array(c, "ab");
+
+	//calloc, VLA and multidimensional arrays
+	const size_t n = 100;
+	int (*z)[n] = arena_calloc_array(&arena, z);
+	assert(z);
+	foreach_array_const_ref(z, ref)
+		assert(*ref == 0);
+	long (*m)[n][3] = arena_calloc_array(&arena, m);
+	assert(m && (*m)[99][2] == 0);
+
+	//explicit alignment
+	float (*f)[16] = arena_alloc_array_aligned(&arena, f, 64);
+	assert(f && (uintptr_t)f % 64 == 0);
+	unsigned char (*page)[10] = arena_alloc_array_aligned(&arena, page, 4096);
+	assert(page && (uintptr_t)page % 4096 == 0);
+
+	//previous data is intact
+	assert(!strcmp(*c, "ab"));
+	foreach_array_const_ref(d, ref)
+		assert(*ref == 1.5);
+
+	//arena grows with new chunks, large allocations get a chunk of their own
+	for(int i = 0; i < 10000; i++) {
+		int (*t)[8] = arena_alloc_array(&arena, t);
+		assert(t);
+		fill_array(t, i);
+	}
+	assert(chunks_count(&arena) > 1);
+	char (*big)[POOR_ARENA_MAX_CHUNK * 2] = arena_alloc_array(&arena, big);
+	assert(big);
+	(*big)[POOR_ARENA_MAX_CHUNK * 2 - 1] = 1;
+
+	//overflow
+	assert(!arena_alloc(&arena, SIZE_MAX - 8, 8));
+
+	arena_free(&arena);
+	assert(!arena.chunk && !arena.ptr);
+
+	//freed arena may be used again
+	assert(arena_alloc_array(&arena, c));
+	arena_free(&arena);
+	return 0;
+}
+
+static int arena_mark_test(void) {
+	poor_arena arena = {0};
+
+	//mark of an empty arena
+	poor_arena_mark empty = arena_mark(&arena);
+	int (*a)[10] = arena_alloc_array(&arena, a);
+	assert(a);
+	arena_rewind(&arena, empty);
+	assert(!arena.chunk);
+
+	int (*keep)[10] = arena_alloc_array(&arena, keep);
+	fill_array(keep, 42);
+	poor_arena_mark mark = arena_mark(&arena);
+
+	//rewind inside the same chunk reuses memory
+	int (*t1)[10] = arena_alloc_array(&arena, t1);
+	arena_rewind(&arena, mark);
+	int (*t2)[10] = arena_alloc_array(&arena, t2);
+	assert(t1 == t2);
+	arena_rewind(&arena, mark);
+
+	//rewind over many chunks frees them
+	for(int i = 0; i < 1000; i++) {
+		long (*t)[100] = arena_alloc_array(&arena, t);
+		assert(t);
+	}
+	assert(chunks_count(&arena) > 1);
+	arena_rewind(&arena, mark);
+	assert(chunks_count(&arena) == 1);
+	foreach_array_const_ref(keep, ref)
+		assert(*ref == 42);
+
+	//reset keeps only the newest chunk, and after a few cycles a cycle fits into it
+	size_t cnt = 0;
+	for(int cycle = 0; cycle < 5; cycle++) {
+		for(int i = 0; i < 1000; i++) {
+			long (*t)[100] = arena_alloc_array(&arena, t);
+			assert(t);
+		}
+		cnt = chunks_count(&arena);
+		arena_reset(&arena);
+		assert(chunks_count(&arena) == 1);
+	}
+	assert(cnt == 1);
+
+	//mark taken before reset doesn't crash rewind, arena is left empty
+	poor_arena_mark stale = arena_mark(&arena);
+	char (*m1)[1 << 20] = arena_alloc_array(&arena, m1);
+	char (*m2)[1 << 20] = arena_alloc_array(&arena, m2);
+	assert(m1 && m2);
+	arena_reset(&arena);
+	arena_rewind(&arena, stale);
+	assert(!arena.chunk && !arena.ptr && !arena.end);
+	assert(arena_alloc_array(&arena, m1));
+
+	arena_free(&arena);
+	return 0;
+}
+
+make_thread_arena(thread_arena);
+
+static int arena_thread_test(void) {
+	size_t ok[THREADS] = {0};
+
+	#pragma omp parallel for num_threads(THREADS) schedule(static, 1)
+	for(int t = 0; t < THREADS; t++) {
+		assert(!thread_arena.chunk);
+		for(int i = 0; i < 10000; i++) {
+			int (*v)[16] = arena_alloc_array(&thread_arena, v);
+			fill_array(v, t);
+			ok[t] += arr(v)[15] == t;
+		}
+		arena_free(&thread_arena);
+	}
+
+	for(int t = 0; t < THREADS; t++)
+		assert(ok[t] == 10000);
+
+	return 0;
+}
+
+typedef int (test_fn)(void);
+
+#define TEST_FN(fn) {#fn, fn}
+
+struct tests_struct {
+	const char *test_name;
+	test_fn *fn;
+} tests[] = {
+	TEST_FN(arena_alloc_test),
+	TEST_FN(arena_mark_test),
+	TEST_FN(arena_thread_test),
+};
+
+static void usage(void) {
+	fprintf(stderr, "usage: this_program [test_name]\n\n"
+		   "available tests:\n");
+
+	for(struct tests_struct *cur = &tests[0]; cur != &tests[sizeof(tests) / sizeof(tests[0])]; cur++ ){
+		fprintf(stderr, "\t%s\n", cur->test_name);
+	}
+}
+
+int main(int argc, char **argv) {
+	if(argc != 2)
+		return usage(), 1;
+
+	for(struct tests_struct *cur = &tests[0]; cur != &tests[sizeof(tests) / sizeof(tests[0])]; cur++ ){
+		if(!strcmp(argv[1], cur->test_name)) {
+			return cur->fn();
+		}
+	}
+
+	return fprintf(stderr, "No test found with name: \"%s\"\n", argv[1]), 1;
+}
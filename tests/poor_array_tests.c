@@ -294,6 +294,89 @@ static int merged_array_test(void) {
 	return 0;
 }
 
+static int malloc_array_aligned_test(void) {
+	float (*f)[100] = malloc_array_aligned(f, 32);
+	assert(f && (uintptr_t)f % 32 == 0);
+	fill_array(f, 1.0f);
+	free(f);
+
+	//size is not a multiple of alignment
+	const size_t n = 3;
+	char (*c)[n] = malloc_array_aligned(c, 4096);
+	assert(c && (uintptr_t)c % 4096 == 0);
+	fill_array(c, 'a');
+	free(c);
+
+	//alignment is never less than alignment of elements
+	long double (*ld)[5] = malloc_array_aligned(ld, 1);
+	assert(ld && (uintptr_t)ld % _Alignof(long double) == 0);
+	free(ld);
+
+	int (*m)[7][3] = malloc_array_cacheline(m);
+	assert(m && (uintptr_t)m % POOR_CACHE_LINE == 0);
+	(*m)[6][2] = 1;
+	free(m);
+
+	//overflow
+	assert(!h_malloc_aligned(SIZE_MAX - 10, 64, 1));
+
+	//alignment is not a power of two
+	float (*bad)[8] = malloc_array_aligned(bad, 24);
+	assert(!bad);
+	assert(!h_malloc_aligned(16, 0, 1));
+	return 0;
+}
+
+static int sbo_array_test(void) {
+	//small array is placed on the stack
+	size_t len = 5;
+	make_sbo_array(small, int, 16, len);
+	assert(small && is_sbo_array_inline(small));
+	assert(ARRAY_SIZE(small) == 5);
+	fill_array(small, 7);
+	foreach_array_const_ref(small, ref)
+		assert(*ref == 7);
+
+	//large array is allocated and released at the end of scope
+	for(size_t i = 0; i < 3; i++) {
+		make_sbo_array(big, long, 16, 1000 + i);
+		assert(big && !is_sbo_array_inline(big));
+		assert(ARRAY_SIZE(big) == 1000 + i);
+		fill_array(big, (long)i);
+		assert(arr(big)[999 + i] == (long)i);
+	}
+
+	//boundary: len equal to inline_cap is inline
+	make_sbo_array(edge, char, 8, 8);
+	assert(is_sbo_array_inline(edge));
+
+	//early release
+	make_sbo_array(early, short, 4, len * 10);
+	assert(early);
+	free_sbo_array(early);
+	assert(!early);
+
+	//allocation failure gives NULL
+	make_sbo_array(huge, long, 4, SIZE_MAX / 2);
+	assert(!huge);
+
+	//merged arrays
+	const int a[] = {1, 2, 3};
+	int (*b)[(size_t){2}] = &(int[]){4, 5};
+	make_merged_sbo_array(m_small, 16, a, b);
+	assert(m_small && is_sbo_array_inline(m_small));
+	assert(ARRAY_SIZE(m_small) == 5);
+	for(int i = 0; i < 5; i++)
+		assert(arr(m_small)[i] == i + 1);
+
+	make_merged_sbo_array(m_big, 4, a, b);
+	assert(m_big && !is_sbo_array_inline(m_big));
+	for(int i = 0; i < 5; i++)
+		assert(arr(m_big)[i] == i + 1);
+
+	return 0;
+}
+
 static int same_type_arrays(void) {
 	int i1[1];
 	const int i1c[1];
@@ -553,6 +636,82 @@ static int array_dim_flat_test(void) {
 	return 0;
 }
 
+typedef arrview_stride_t(const int) const_int_stride;
+
+static int sum_stride(const_int_stride v) {
+	int sum = 0;
+	foreach_stride_const_ref(v, ref)
+		sum += *ref;
+	return sum;
+}
+
+static int arrview_stride_test(void) {
+	int a[] = {0,1,2,3,4,5,6,7,8,9};
+
+	make_arrview_stride(even, 0, 5, 2, a);
+	assert(even.count == 5 && even.ptr == &a[0]);
+	foreach_stride_const_ref(even, ref)
+		assert(*ref == (int)stride_ref_index(even, ref) * 2);
+
+	//last element is the last element of the array
+	make_arrview_stride(tail, 3, 3, 3, a);
+	size_t cnt = 0;
+	foreach_stride_ref(tail, ref) {
+		assert(*ref == 3 + (int)cnt * 3);
+		cnt++;
+	}
+	assert(cnt == 3);
+
+	//break stops iteration
+	cnt = 0;
+	foreach_stride_ref(arrview_stride(0, 10, 1, a), ref) {
+		if(*ref == 4)
+			break;
+		cnt++;
+	}
+	assert(cnt == 4);
+
+	fill_stride(arrview_stride(1, 5, 2, a), -1);
+	foreach_array_const_ref(a, ref)
+		assert(*ref == (array_ref_index(a, ref) % 2 ? -1 : (int)array_ref_index(a, ref)));
+
+	//columns of a 2D view
+	int m[] = {1,2,3, 4,5,6, 7,8,9, 10,11,12};
+	make_arrview_dim(matrix, 3, m);
+	make_arrview_column(col1, 1, matrix);
+	assert(col1.count == 4 && col1.stride == 3);
+	int col_copy[4];
+	copy_stride(arrview_stride_full(col_copy), col1);
+	assert(!memcmp(col_copy, ((int[]){2,5,8,11}), sizeof(col_copy)));
+
+	//copy a column into another column, and an array into a column
+	copy_stride(arrview_column(0, matrix), arrview_column(2, matrix));
+	assert(m[0] == 3 && m[9] == 12);
+	copy_stride(col1, arrview_stride_full((const long[]){-1, -2}));
+	assert(m[1] == -1 && m[4] == -2 && m[7] == 8);
+
+	//columns of a VLA with conversions
+	size_t rows = 3;
+	double (*vla)[rows][2] = malloc_array(vla);
+	assert(vla);
+	fill_array(arrview_flat(vla), 0.5);
+	make_arrview_column(vcol, 1, vla);
+	fill_stride(vcol, 2);
+	foreach_array_const_ref(vla, row)
+		assert((*row)[0] == 0.5 && (*row)[1] == 2.0);
+	free(vla);
+
+	//strided views are passed to functions with a typedef
+	assert(sum_stride((const_int_stride){even.ptr, even.count, even.stride}) == 0 + 2 + 4 + 6 + 8);
+
+	//unsigned arguments, view ends at the last element
+	make_arrview_stride(last, 9u, 1u, 3u, a);
+	assert(last.count == 1 && last.ptr == &a[9]);
+
+	print_stride(col1);
+	return 0;
+}
+
 static int array_insert_test(void) {
 	{
 		int x[] = {0,1,2,3,4,5};
@@ -599,12 +758,15 @@ static struct tests_struct {
 	TEST_FN(same_type_arrays),
 
 	TEST_FN(merged_array_test),
+	TEST_FN(malloc_array_aligned_test),
+	TEST_FN(sbo_array_test),
 	TEST_FN(arrview_simple),
 	TEST_FN(arrview_first_test),
 	TEST_FN(arrview_last_test),
 	TEST_FN(arrview_shrink_test),
 
 	TEST_FN(array_dim_flat_test),
+	TEST_FN(arrview_stride_test),
 
 	TEST_FN(array_insert_test),
 };
@@ -0,0 +1,193 @@
+#include <poor_atomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#undef NDEBUG
+
+#define BITS (1024 * 1024 + 13)
+#define THREADS 4
+
+/* Multiplicative hash, spreads marks of different threads over same elements */
+#define mix(i) ((size_t)(((unsigned long long)(i) * 0x9E3779B97F4A7C15ULL) >> 20) % BITS)
+
+static int array_atomic_bit_test(void) {
+	unsigned char small[3] = {0};
+	array_atomic_set_bit(small, 0);
+	array_atomic_set_bit_explicit(small, 9, memory_order_relaxed);
+	array_atomic_set_bit(small, 23);
+	assert(small[0] == 0x01 && small[1] == 0x02 && small[2] == 0x80);
+	assert(array_atomic_get_bit(small, 9));
+	assert(!array_atomic_get_bit_explicit(small, 10, memory_order_acquire));
+
+	array_atomic_unset_bit(small, 9);
+	assert(small[1] == 0);
+	assert(!array_atomic_test_and_set_bit(small, 9));
+	assert(array_atomic_test_and_set_bit_explicit(small, 9, memory_order_acq_rel));
+	assert(array_atomic_test_and_set_bit_explicit(small, 23, memory_order_relaxed));
+	assert(small[1] == 0x02);
+
+	//concurrent marking: every bit is won by exactly one thread
+	uint64_t (*bits)[(BITS + 63) / 64] = calloc_array(bits);
+	assert(bits);
+	size_t won[THREADS] = {0};
+
+	#pragma omp parallel for num_threads(THREADS) schedule(static, 1)
+	for(int t = 0; t < THREADS; t++)
+		for(size_t i = 0; i < BITS; i++)
+			won[t] += !array_atomic_test_and_set_bit_explicit(bits, mix(i), memory_order_relaxed);
+
+	size_t total = 0;
+	for(int t = 0; t < THREADS; t++)
+		total += won[t];
+
+	size_t expected = 0;
+	foreach_array_const_ref(bits, ref)
+		expected += (size_t)__builtin_popcountll(*ref);
+	assert(total == expected);
+
+	//threads set and clear different bits of same elements
+	memset(bits, 0, sizeof(*bits));
+	#pragma omp parallel for num_threads(THREADS) schedule(static, 1)
+	for(int t = 0; t < THREADS; t++)
+		for(size_t i = (size_t)t; i < BITS; i += THREADS) {
+			array_atomic_set_bit_explicit(bits, i, memory_order_relaxed);
+			if(i % 3 == 0)
+				array_atomic_unset_bit_explicit(bits, i, memory_order_relaxed);
+		}
+
+	for(size_t i = 0; i < BITS; i++)
+		assert(array_get_bit(bits, i) == (i % 3 != 0));
+
+	free(bits);
+	return 0;
+}
+
+static int array_atomic_set_bits_test(void) {
+	uint64_t marks[4] = {0};
+	const size_t idx[] = {3, 5, 7, 64, 65, 3, 255, 5};
+	assert(array_atomic_set_bits(marks, idx) == 6);
+	assert(marks[0] == ((1 << 3) | (1 << 5) | (1 << 7)));
+	assert(marks[1] == 3 && marks[2] == 0 && marks[3] == 1ULL << 63);
+	assert(array_atomic_set_bits_explicit(marks, idx, memory_order_relaxed) == 0);
+
+	//narrow elements and indexes of other type
+	unsigned short narrow[2] = {0};
+	const int narrow_idx[] = {1, 17, 18, 1};
+	assert(array_atomic_set_bits(narrow, narrow_idx) == 3);
+	assert(narrow[0] == 2 && narrow[1] == 6);
+
+	//output contains only newly set indexes, in order, without duplicates
+	memset(marks, 0, sizeof(marks));
+	array_atomic_set_bit(marks, 65);
+	size_t out[ARRAY_SIZE(idx)];
+	size_t cnt = array_atomic_test_and_set_bits(marks, idx, out);
+	assert(cnt == 5);
+	assert(out[0] == 3 && out[1] == 5 && out[2] == 7 && out[3] == 64 && out[4] == 255);
+
+	//concurrent batches over shared elements
+	uint64_t (*bits)[(BITS + 63) / 64] = calloc_array(bits);
+	size_t (*list)[BITS] = malloc_array(list);
+	size_t (*outs)[THREADS][BITS / THREADS + 1] = malloc_array(outs);
+	assert(bits && list && outs);
+	foreach_array_ref(list, ref)
+		*ref = mix(array_ref_index(list, ref));
+
+	size_t got[THREADS] = {0};
+	#pragma omp parallel for num_threads(THREADS) schedule(static, 1)
+	for(int t = 0; t < THREADS; t++) {
+		const size_t begin = (size_t)t * (BITS / THREADS);
+		const size_t end = t == THREADS - 1 ? BITS : begin + BITS / THREADS;
+		const size_t (*part)[end - begin] = (void*)&(*list)[begin];
+		size_t (*out_part)[end - begin] = (void*)&(*outs)[t];
+		got[t] = array_atomic_test_and_set_bits_explicit(bits, part, out_part, memory_order_relaxed);
+	}
+
+	//every set bit is reported by exactly one thread
+	unsigned char (*seen)[BITS] = calloc_array(seen);
+	assert(seen);
+	size_t total = 0;
+	for(int t = 0; t < THREADS; t++)
+		for(size_t i = 0; i < got[t]; i++, total++) {
+			const size_t bit = (*outs)[t][i];
+			assert(array_get_bit(bits, bit));
+			assert(!(*seen)[bit]);
+			(*seen)[bit] = 1;
+		}
+
+	size_t expected = 0;
+	foreach_array_const_ref(bits, ref)
+		expected += (size_t)__builtin_popcountll(*ref);
+	assert(total == expected);
+
+	free(seen);
+	free(outs);
+	free(list);
+	free(bits);
+	return 0;
+}
+
+static int array_atomic_fetch_add_test(void) {
+	int counters[3] = {0, 10, 20};
+	assert(array_atomic_fetch_add(counters, 1, 5) == 10);
+	assert(array_atomic_fetch_add_explicit(counters, 1, -3, memory_order_relaxed) == 15);
+	assert(counters[1] == 12);
+
+	unsigned flags[2] = {0x0f, 0};
+	assert(array_atomic_fetch_or(flags, 0, 0xf0u) == 0x0f);
+	assert(array_atomic_fetch_and_explicit(flags, 0, 0x3cu, memory_order_acq_rel) == 0xff);
+	assert(flags[0] == 0x3c);
+
+	//concurrent histogram
+	uint32_t (*hist)[256] = calloc_array(hist);
+	assert(hist);
+
+	#pragma omp parallel for num_threads(THREADS) schedule(static)
+	for(size_t i = 0; i < BITS; i++)
+		array_atomic_fetch_add_explicit(hist, i % 256, 1, memory_order_relaxed);
+
+	size_t sum = 0;
+	foreach_array_const_ref(hist, ref) {
+		assert(*ref == BITS / 256 + (array_ref_index(hist, ref) < BITS % 256));
+		sum += *ref;
+	}
+	assert(sum == BITS);
+
+	free(hist);
+	return 0;
+}
+
+typedef int (test_fn)(void);
+
+#define TEST_FN(fn) {#fn, fn}
+
+struct tests_struct {
+	const char *test_name;
+	test_fn *fn;
+} tests[] = {
+	TEST_FN(array_atomic_bit_test),
+	TEST_FN(array_atomic_set_bits_test),
+	TEST_FN(array_atomic_fetch_add_test),
+};
+
+static void usage(void) {
+	fprintf(stderr, "usage: this_program [test_name]\n\n"
+		   "available tests:\n");
+
+	for(struct tests_struct *cur = &tests[0]; cur != &tests[sizeof(tests) / sizeof(tests[0])]; cur++ ){
+		fprintf(stderr, "\t%s\n", cur->test_name);
+	}
+}
+
+int main(int argc, char **argv) {
+	if(argc != 2)
+		return usage(), 1;
+
+	for(struct tests_struct *cur = &tests[0]; cur != &tests[sizeof(tests) / sizeof(tests[0])]; cur++ ){
+		if(!strcmp(argv[1], cur->test_name)) {
+			return cur->fn();
+		}
+	}
+
+	return fprintf(stderr, "No test found with name: \"%s\"\n", argv[1]), 1;
+}
@@ -0,0 +1,319 @@
+#include <poor_bits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#undef NDEBUG
+
+/* Counts set bits with array_get_bit() */
+#define naive_popcount(_arrm_) __extension__ ({		\
+	size_t _cnt_ = 0;				\
+	foreach_array_bit(_arrm_, _bit_)		\
+		_cnt_ += array_get_bit(_arrm_, _bit_);	\
+	_cnt_;						\
+})
+
+#define fill_random(_arrm_)				\
+	foreach_array_ref(_arrm_, _ref_)		\
+		*_ref_ = (typeof(*_ref_))(((uint64_t)rand() << 40) ^ ((uint64_t)rand() << 20) ^ (uint64_t)rand())
+
+#define popcount_check(_type_, _n_) do {		\
+	_type_ (*_a_)[(size_t){_n_}] = malloc_array(_a_);	\
+	assert(_a_);					\
+	fill_random(_a_);				\
+	assert(array_popcount(_a_) == naive_popcount(_a_));	\
+	free(_a_);					\
+} while(0)
+
+static int array_popcount_test(void) {
+	const uint64_t set[] = {0xff, 0x1, 0};
+	assert(array_popcount(set) == 9);
+
+	const uint8_t full[1000] = {[0 ... 999] = 0xff};
+	assert(array_popcount(full) == 8000);
+
+	for(size_t n = 1; n < 300; n += 7) {
+		popcount_check(unsigned char, n);
+		popcount_check(unsigned short, n);
+		popcount_check(unsigned, n);
+		popcount_check(unsigned long long, n);
+	}
+	popcount_check(uint64_t, 100000);
+
+	return 0;
+}
+
+#define bits_ops_verify(_d_, _a_, _b_, _op_)					\
+	for(size_t _i_ = 0; _i_ < ARRAY_SIZE(_d_); _i_++)				\
+		assert((*_d_)[_i_] == (typeof((*_d_)[0]))((*_a_)[_i_] _op_ (*_b_)[_i_]))
+
+#define bits_ops_check(_type_, _n_) do {						\
+	_type_ (*_a_)[(size_t){_n_}] = malloc_array(_a_);				\
+	_type_ (*_b_)[(size_t){_n_}] = malloc_array(_b_);				\
+	_type_ (*_d_)[(size_t){_n_}] = malloc_array(_d_);				\
+	assert(_a_ && _b_ && _d_);							\
+	fill_random(_a_);								\
+	fill_random(_b_);								\
+	array_bits_and(_d_, _a_, _b_);							\
+	bits_ops_verify(_d_, _a_, _b_, &);						\
+	array_bits_or(_d_, _a_, _b_);							\
+	bits_ops_verify(_d_, _a_, _b_, |);						\
+	array_bits_xor(_d_, _a_, _b_);							\
+	bits_ops_verify(_d_, _a_, _b_, ^);						\
+	array_bits_andnot(_d_, _a_, _b_);						\
+	bits_ops_verify(_d_, _a_, _b_, & ~);						\
+	/* in place: a &= b */								\
+	copy_array(_d_, _a_);								\
+	array_bits_and(_d_, _d_, _b_);							\
+	bits_ops_verify(_d_, _a_, _b_, &);						\
+	free(_d_);									\
+	free(_b_);									\
+	free(_a_);									\
+} while(0)
+
+static int array_bits_ops_test(void) {
+	const uint8_t a[] = {0x0f, 0xf0, 0xff}, b[] = {0x3c, 0x3c, 0x00};
+	uint8_t d[3];
+	array_bits_and(d, a, b);
+	assert(d[0] == 0x0c && d[1] == 0x30 && d[2] == 0x00);
+	array_bits_or(d, a, b);
+	assert(d[0] == 0x3f && d[1] == 0xfc && d[2] == 0xff);
+	array_bits_xor(d, a, b);
+	assert(d[0] == 0x33 && d[1] == 0xcc && d[2] == 0xff);
+	array_bits_andnot(d, a, b);
+	assert(d[0] == 0x03 && d[1] == 0xc0 && d[2] == 0xff);
+
+	for(size_t n = 1; n < 200; n += 13) {
+		bits_ops_check(unsigned char, n);
+		bits_ops_check(unsigned short, n);
+		bits_ops_check(unsigned long, n);
+	}
+
+	return 0;
+}
+
+static int array_find_first_set_test(void) {
+	uint32_t set[4] = {0};
+	assert(array_find_first_set(set) == 128);
+	array_set_bit(set, 77);
+	assert(array_find_first_set(set) == 77);
+	array_set_bit(set, 31);
+	assert(array_find_first_set(set) == 31);
+	array_set_bit(set, 0);
+	assert(array_find_first_set(set) == 0);
+
+	//every bit of large arrays of different element types
+	uint16_t (*s16)[(size_t){1000}] = calloc(1, sizeof(*s16));
+	uint64_t (*s64)[(size_t){250}] = calloc(1, sizeof(*s64));
+	assert(s16 && s64);
+	for(size_t i = ARRAY_SIZE_BITS(s16) - 1; i < ARRAY_SIZE_BITS(s16); i--) {
+		array_set_bit(s16, i);
+		assert(array_find_first_set(s16) == i);
+		array_set_bit(s64, i);
+		assert(array_find_first_set(s64) == i);
+	}
+	free(s64);
+	free(s16);
+
+	return 0;
+}
+
+static int array_bit_range_test(void) {
+	uint8_t set[3] = {0};
+	array_set_bit_range(set, 4, 20);
+	assert(set[0] == 0xf0 && set[1] == 0xff && set[2] == 0x0f);
+	array_unset_bit_range(set, 6, 9);
+	assert(set[0] == 0x30 && set[1] == 0xfe && set[2] == 0x0f);
+	array_set_bit_range(set, 5, 5);
+	assert(set[0] == 0x30);
+
+	uint64_t full[2] = {0};
+	array_set_bit_range(full, 0, 128);
+	assert(full[0] == UINT64_MAX && full[1] == UINT64_MAX);
+	array_unset_bit_range(full, 64, 128);
+	assert(full[0] == UINT64_MAX && full[1] == 0);
+
+	//all ranges of a small bitset compared with array_set_bit()
+	for(size_t b = 0; b <= 96; b++)
+		for(size_t e = b; e <= 96; e++) {
+			uint16_t x[6] = {0}, y[6] = {0};
+			uint32_t z[3] = {0};
+			array_set_bit_range(x, b, e);
+			array_set_bit_range(z, b, e);
+			for(size_t i = b; i < e; i++)
+				array_set_bit(y, i);
+			assert(!memcmp(x, y, sizeof(x)));
+			assert(array_popcount(z) == e - b);
+			assert(array_find_first_set(z) == (b < e ? b : 96));
+
+			memset(x, 0xff, sizeof(x));
+			memset(y, 0xff, sizeof(y));
+			array_unset_bit_range(x, b, e);
+			for(size_t i = b; i < e; i++)
+				array_unset_bit(y, i);
+			assert(!memcmp(x, y, sizeof(x)));
+		}
+
+	return 0;
+}
+
+#define set_bit_iter_check(_type_, _n_, _density_) do {			\
+	_type_ (*_a_)[(size_t){_n_}] = calloc(1, sizeof(*_a_));			\
+	assert(_a_);								\
+	foreach_array_bit(_a_, _i_)						\
+		if(rand() % 100 < (_density_))					\
+			array_set_bit(_a_, _i_);				\
+	size_t _next_ = 0, _cnt_ = 0;						\
+	foreach_array_set_bit(_a_, _idx_) {					\
+		for(; _next_ < _idx_; _next_++)					\
+			assert(!array_get_bit(_a_, _next_));			\
+		assert(array_get_bit(_a_, _idx_));				\
+		_next_ = _idx_ + 1;						\
+		_cnt_++;							\
+	}									\
+	for(; _next_ < ARRAY_SIZE_BITS(_a_); _next_++)				\
+		assert(!array_get_bit(_a_, _next_));				\
+	assert(_cnt_ == array_popcount(_a_));					\
+	size_t _prev_ = ARRAY_SIZE_BITS(_a_);					\
+	foreach_array_set_bit_bw(_a_, _idx_) {					\
+		assert(_idx_ < _prev_ && array_get_bit(_a_, _idx_));		\
+		_prev_ = _idx_;							\
+		_cnt_--;							\
+	}									\
+	assert(!_cnt_);								\
+	free(_a_);								\
+} while(0)
+
+static int foreach_array_set_bit_test(void) {
+	uint64_t set[4] = {0};
+	foreach_array_set_bit(set, idx)
+		assert(0);
+	foreach_array_set_bit_bw(set, idx)
+		assert(0);
+
+	array_set_bit(set, 3);
+	array_set_bit(set, 130);
+	array_set_bit(set, 255);
+	const size_t fw[] = {3, 130, 255};
+	size_t i = 0;
+	foreach_array_set_bit(set, idx)
+		assert(idx == fw[i++]);
+	assert(i == 3);
+	foreach_array_set_bit_bw(set, idx)
+		assert(idx == fw[--i]);
+	assert(i == 0);
+
+	//break and continue
+	const uint8_t c[5] = {0x81, 0, 0x10, 0, 0x80};
+	foreach_array_set_bit(c, idx) {
+		if(idx == 7)
+			continue;
+		if(idx > 30)
+			break;
+		assert(idx == 0 || idx == 20);
+		i++;
+	}
+	assert(i == 2);
+	foreach_array_set_bit_bw(c, idx) {
+		assert(idx == 39);
+		break;
+	}
+
+	for(int density = 0; density <= 100; density += 25) {
+		set_bit_iter_check(unsigned char, 37, density);
+		set_bit_iter_check(unsigned short, 100, density);
+		set_bit_iter_check(unsigned, 33, density);
+		set_bit_iter_check(unsigned long long, 50, density);
+	}
+	set_bit_iter_check(uint64_t, 10000, 1);
+
+	return 0;
+}
+
+#define rank_select_check(_type_, _n_, _permille_) do {				\
+	_type_ (*_a_)[(size_t){_n_}] = calloc(1, sizeof(*_a_));			\
+	assert(_a_);								\
+	foreach_array_bit(_a_, _i_)						\
+		if(rand() % 1000 < (_permille_))				\
+			array_set_bit(_a_, _i_);				\
+	bitvec_rank_select *_rs_ = malloc_bitvec_rank_select(_a_);		\
+	assert(_rs_);								\
+	size_t _rank_ = 0;							\
+	for(size_t _i_ = 0; _i_ < ARRAY_SIZE_BITS(_a_); _i_++) {		\
+		assert(bitvec_rank1(_rs_, _i_) == _rank_);			\
+		if(array_get_bit(_a_, _i_))					\
+			assert(bitvec_select1(_rs_, _rank_++) == _i_);		\
+	}									\
+	assert(bitvec_rank1(_rs_, ARRAY_SIZE_BITS(_a_)) == _rank_);		\
+	assert(bitvec_rank1(_rs_, SIZE_MAX) == _rank_);				\
+	assert(_rs_->ones == _rank_);						\
+	assert(bitvec_select1(_rs_, _rank_) == ARRAY_SIZE_BITS(_a_));		\
+	free(_rs_);								\
+	free(_a_);								\
+} while(0)
+
+static int bitvec_rank_select_test(void) {
+	const uint64_t set[] = {0x5, 0, 0x8000000000000000};
+	bitvec_rank_select *rs = malloc_bitvec_rank_select(set);
+	assert(rs);
+	assert(rs->ones == 3 && rs->nbits == 192);
+	assert(bitvec_rank1(rs, 0) == 0);
+	assert(bitvec_rank1(rs, 1) == 1);
+	assert(bitvec_rank1(rs, 3) == 2);
+	assert(bitvec_rank1(rs, 191) == 2);
+	assert(bitvec_rank1(rs, 192) == 3);
+	assert(bitvec_select1(rs, 0) == 0);
+	assert(bitvec_select1(rs, 1) == 2);
+	assert(bitvec_select1(rs, 2) == 191);
+	assert(bitvec_select1(rs, 3) == 192);
+	free(rs);
+
+	const int permille[] = {0, 2, 50, 500, 999, 1000};
+	for(size_t i = 0; i < ARRAY_SIZE(permille); i++) {
+		rank_select_check(unsigned char, 1, permille[i]);
+		rank_select_check(unsigned char, 777, permille[i]);
+		rank_select_check(unsigned short, 5000, permille[i]);
+		rank_select_check(unsigned, 3001, permille[i]);
+		rank_select_check(uint64_t, 20000, permille[i]);
+	}
+
+	return 0;
+}
+
+typedef int test_fn (void);
+
+#define TEST_FN(fn) {#fn, fn}
+static struct tests_struct {
+	const char *test_name;
+	test_fn *fn;
+} tests[] = {
+	TEST_FN(array_popcount_test),
+	TEST_FN(array_bits_ops_test),
+	TEST_FN(array_find_first_set_test),
+	TEST_FN(array_bit_range_test),
+	TEST_FN(foreach_array_set_bit_test),
+	TEST_FN(bitvec_rank_select_test),
+};
+
+static void usage(void) {
+	fprintf(stderr, "usage: this_program [test_name]\n\n"
+		   "available tests:\n");
+
+	for(struct tests_struct *cur = &tests[0]; cur != &tests[sizeof(tests) / sizeof(tests[0])]; cur++ ){
+		fprintf(stderr, "\t%s\n", cur->test_name);
+	}
+}
+
+int main(int argc, char **argv) {
+	if(argc != 2)
+		return usage(), 1;
+
+	for(struct tests_struct *cur = &tests[0]; cur != &tests[sizeof(tests) / sizeof(tests[0])]; cur++ ){
+		if(!strcmp(argv[1], cur->test_name)) {
+			return cur->fn();
+		}
+	}
+
+	return fprintf(stderr, "No test found with name: \"%s\"\n", argv[1]), 1;
+}
@@ -0,0 +1,262 @@
+#include <poor_file.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <assert.h>
+
+#undef NDEBUG
+
+static void temp_path(char (*path)[32]) {
+	copy_array(path, "/tmp/poor_file_testXXXXXX");
+	const int fd = mkstemp(*path);
+	assert(fd >= 0);
+	close(fd);
+}
+
+static int array_file_test(void) {
+	char path[32];
+	temp_path(&path);
+
+	const size_t n = 3000;
+	double (*src)[n] = malloc_array(src);
+	assert(src);
+	foreach_array_ref(src, ref)
+		*ref = (double)array_ref_index(src, ref) / 2;
+	assert(write_array_file(path, src));
+
+	//read into array of a known size
+	double (*dst)[n] = read_array_file(path, dst);
+	assert(dst);
+	assert(!memcmp(dst, src, sizeof(*src)));
+	free(dst);
+
+	//size is taken from the file
+	{
+		load_array_file(loaded, double, path);
+		assert(loaded && ARRAY_SIZE(loaded) == n);
+		assert((*loaded)[n - 1] == (double)(n - 1) / 2);
+		free(loaded);
+	}
+
+	//rows of a 2D view
+	assert(write_array_file(path, arrview_dim(3, src)));
+	{
+		load_array_file(points, double[3], path);
+		assert(points && ARRAY_SIZE(points) == n / 3);
+		assert(ARRAY_SIZE((*points)[0]) == 3);
+		assert((*points)[10][2] == (double)32 / 2);
+		free(points);
+
+		//rows of a different shape
+		load_array_file(pairs, double[2], path);
+		assert(!pairs);
+	}
+
+	//mapping points to data after the header
+	{
+		mmap_array_file(mapped, const double[3], path);
+		assert(mapped && ARRAY_SIZE(mapped) == n / 3);
+		assert((uintptr_t)mapped % 64 == 0);
+		assert(!memcmp(mapped, src, sizeof(*src)));
+		assert(!madvise_array(mapped, POOR_ADVISE_RANDOM));
+		assert(array_file_checksum(mapped) == array_file_checksum(src));
+		unmap_array_file(mapped);
+	}
+
+	//fixed size arrays and a single element
+	const char text[] = "array file";
+	assert(write_array_file(path, text));
+	char (*text_rd)[sizeof(text)] = read_array_file(path, text_rd);
+	assert(text_rd && !strcmp(*text_rd, text));
+	free(text_rd);
+
+	struct pt { int x, y; } one[1] = {{1, 2}};
+	assert(write_array_file(path, one));
+	struct pt (*one_rd)[1] = read_array_file(path, one_rd);
+	assert(one_rd && (*one_rd)[0].y == 2);
+	free(one_rd);
+
+	unlink(path);
+	free(src);
+	return 0;
+}
+
+static int array_file_errors_test(void) {
+	char path[32];
+	temp_path(&path);
+
+	int data[100];
+	foreach_array_ref(data, ref)
+		*ref = (int)array_ref_index(data, ref);
+	assert(write_array_file(path, data));
+
+	//wrong element size or count
+	unsigned (*u)[100] = read_array_file(path, u);
+	assert(u);
+	free(u);
+	long long (*ll)[50] = read_array_file(path, ll);
+	assert(!ll);
+	int (*more)[101] = read_array_file(path, more);
+	assert(!more);
+	{
+		load_array_file(shorts, short, path);
+		assert(!shorts);
+		mmap_array_file(mshorts, const short, path);
+		assert(!mshorts);
+		unmap_array_file(mshorts);
+	}
+
+	//corrupted data fails checksum
+	FILE *f = fopen(path, "r+b");
+	assert(f);
+	assert(!fseek(f, sizeof(struct poor_array_file_header) + 10, SEEK_SET));
+	assert(fputc(0x55, f) == 0x55);
+	assert(!fclose(f));
+	int (*bad)[100] = read_array_file(path, bad);
+	assert(!bad);
+
+	//truncated file
+	assert(write_array_file(path, data));
+	assert(!truncate(path, sizeof(struct poor_array_file_header) + sizeof(data) - 1));
+	int (*trunc)[100] = read_array_file(path, trunc);
+	assert(!trunc);
+	{
+		mmap_array_file(mtrunc, const int, path);
+		assert(!mtrunc);
+	}
+
+	//not an array file
+	assert(!truncate(path, 10));
+	{
+		load_array_file(garbage, int, path);
+		assert(!garbage);
+	}
+
+	//missing file
+	unlink(path);
+	int (*missing)[100] = read_array_file(path, missing);
+	assert(!missing);
+	assert(!write_array_file("/nonexistent_dir/file.bin", data));
+
+	//checksum depends on every byte and size
+	unsigned char bytes[67] = {0};
+	const uint64_t sum = array_file_checksum(bytes);
+	assert(sum != array_file_checksum(arrview_first(66, bytes)));
+	for(size_t i = 0; i < sizeof(bytes); i++) {
+		bytes[i] = 1;
+		assert(array_file_checksum(bytes) != sum);
+		bytes[i] = 0;
+	}
+	return 0;
+}
+
+static long long sum_until(const char *path, int stop) {
+	long long sum = 0;
+	foreach_file_chunk(path, int, 100, chunk) {
+		foreach_array_const_ref(chunk, ref) {
+			if(*ref == stop)
+				return sum;
+			sum += *ref;
+		}
+	}
+	return -1;
+}
+
+static int file_chunk_test(void) {
+	char path[32];
+	temp_path(&path);
+
+	const size_t n = 10007;
+	int (*data)[n] = malloc_array(data);
+	assert(data);
+	foreach_array_ref(data, ref)
+		*ref = (int)array_ref_index(data, ref);
+
+	FILE *f = fopen(path, "wb");
+	assert(f);
+	assert(fwrite(data, sizeof(*data), 1, f) == 1);
+	assert(fputc(0, f) == 0); //trailing byte which doesn't fill an element
+	assert(!fclose(f));
+
+	//all chunks are full except the last one
+	size_t chunks = 0, total = 0;
+	foreach_file_chunk(path, int, 1000, chunk) {
+		assert(ARRAY_SIZE(chunk) == (chunks < 10 ? 1000 : 7));
+		assert(!memcmp(chunk, &(*data)[total], sizeof(*chunk)));
+		total += ARRAY_SIZE(chunk);
+		chunks++;
+	}
+	assert(chunks == 11 && total == n);
+
+	//chunk larger than the file, array elements
+	chunks = 0;
+	foreach_file_chunk(path, int[7], 1 << 20, rows) {
+		assert(ARRAY_SIZE(rows) == n / 7);
+		assert((*rows)[1][0] == 7 && (*rows)[n / 7 - 1][6] == (int)(n / 7 * 7 - 1));
+		chunks++;
+	}
+	assert(chunks == 1);
+
+	//break, continue and nested loops
+	chunks = 0;
+	foreach_file_chunk(path, int, 1000, outer) {
+		if(chunks++ == 2)
+			break;
+		if((*outer)[0] == 0)
+			continue;
+		size_t inner_chunks = 0;
+		foreach_file_chunk(path, int, 3000, inner)
+			inner_chunks++;
+		assert(inner_chunks == 4);
+	}
+	assert(chunks == 3);
+
+	//return from the body releases the file
+	assert(sum_until(path, 200) == 199 * 200 / 2);
+	assert(sum_until(path, -5) == -1);
+
+	//missing file and zero chunk size
+	unlink(path);
+	foreach_file_chunk(path, int, 100, missing)
+		assert(!missing);
+	foreach_file_chunk("/dev/null", int, 0, empty)
+		assert(!empty);
+
+	free(data);
+	return 0;
+}
+
+typedef int (test_fn)(void);
+
+#define TEST_FN(fn) {#fn, fn}
+
+struct tests_struct {
+	const char *test_name;
+	test_fn *fn;
+} tests[] = {
+	TEST_FN(array_file_test),
+	TEST_FN(array_file_errors_test),
+	TEST_FN(file_chunk_test),
+};
+
+static void usage(void) {
+	fprintf(stderr, "usage: this_program [test_name]\n\n"
+		   "available tests:\n");
+
+	for(struct tests_struct *cur = &tests[0]; cur != &tests[sizeof(tests) / sizeof(tests[0])]; cur++ ){
+		fprintf(stderr, "\t%s\n", cur->test_name);
+	}
+}
+
+int main(int argc, char **argv) {
+	if(argc != 2)
+		return usage(), 1;
+
+	for(struct tests_struct *cur = &tests[0]; cur != &tests[sizeof(tests) / sizeof(tests[0])]; cur++ ){
+		if(!strcmp(argv[1], cur->test_name)) {
+			return cur->fn();
+		}
+	}
+
+	return fprintf(stderr, "No test found with name: \"%s\"\n", argv[1]), 1;
+}
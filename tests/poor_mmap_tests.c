@@ -0,0 +1,157 @@
+#include <poor_mmap.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <assert.h>
+
+#undef NDEBUG
+
+static int mmap_huge_test(void) {
+	//memory is zeroed, writable and aligned to a huge page
+	uint64_t (*table)[1 << 20] = malloc_array_huge(table);
+	assert(table);
+	assert((uintptr_t)table % POOR_HUGE_PAGE_SIZE == 0);
+	foreach_array_const_ref(table, ref)
+		assert(*ref == 0);
+	foreach_array_ref(table, ref)
+		*ref = array_ref_index(table, ref);
+	assert((*table)[(1 << 20) - 1] == (1 << 20) - 1);
+	free_array_huge(table);
+
+	//size is not a multiple of a huge page, VLA
+	const size_t n = 3 * 1000 * 1000 + 7;
+	char (*c)[n] = malloc_array_huge(c);
+	assert(c);
+	fill_array(c, 'x');
+	assert((*c)[n - 1] == 'x');
+	free_array_huge(c);
+
+	//small arrays
+	int (*small)[3] = malloc_array_huge(small);
+	assert(small);
+	copy_array(small, ((int[]){1, 2, 3}));
+	assert((*small)[2] == 3);
+	free_array_huge(small);
+
+	small = NULL;
+	free_array_huge(small);
+
+	//overflow
+	assert(!h_mmap_huge(SIZE_MAX - 1));
+	assert(!h_mmap_huge(0));
+	return 0;
+}
+
+static void write_file(const char *path, const void *data, size_t size, size_t tail) {
+	FILE *f = fopen(path, "wb");
+	assert(f);
+	assert(fwrite(data, 1, size, f) == size);
+	for(size_t i = 0; i < tail; i++)
+		assert(fputc(0, f) == 0);
+	assert(!fclose(f));
+}
+
+static int mmap_file_test(void) {
+	char path[] = "/tmp/poor_mmap_testXXXXXX";
+	const int fd = mkstemp(path);
+	assert(fd >= 0);
+	close(fd);
+
+	//trailing bytes which don't fill an element are not mapped
+	int (*data)[1000] = malloc_array(data);
+	assert(data);
+	foreach_array_ref(data, ref)
+		*ref = (int)array_ref_index(data, ref);
+	write_file(path, data, sizeof(*data), 2);
+
+	{
+		mmap_file_array(ro, const int, path, POOR_MMAP_READ);
+		assert(ro);
+		assert(ARRAY_SIZE(ro) == 1000);
+		assert(!madvise_array(ro, POOR_ADVISE_SEQUENTIAL));
+		assert(!memcmp(ro, data, sizeof(*ro)));
+		foreach_array_const_ref(ro, ref)
+			assert(*ref == (int)array_ref_index(ro, ref));
+		unmap_file_array(ro);
+	}
+
+	//private mapping doesn't change the file
+	{
+		mmap_file_array(cow, int, path, POOR_MMAP_COPY);
+		assert(cow && ARRAY_SIZE(cow) == 1000);
+		assert(!madvise_array(cow, POOR_ADVISE_RANDOM));
+		fill_array(cow, -1);
+		unmap_file_array(cow);
+
+		mmap_file_array(check, const int, path, POOR_MMAP_READ);
+		assert(check && (*check)[999] == 999);
+		unmap_file_array(check);
+	}
+
+	//shared mapping writes changes to the file
+	{
+		mmap_file_array(rw, int, path, POOR_MMAP_WRITE);
+		assert(rw);
+		assert(!madvise_array(rw, POOR_ADVISE_WILLNEED));
+		fill_array(rw, 7);
+		unmap_file_array(rw);
+
+		mmap_file_array(check, const long long, path, POOR_MMAP_READ);
+		assert(check && ARRAY_SIZE(check) == (sizeof(*data) + 2) / sizeof(long long));
+		foreach_array_const_ref(check, ref)
+			assert(*ref == (7LL << 32 | 7));
+		unmap_file_array(check);
+	}
+
+	//file is smaller than an element
+	{
+		mmap_file_array(big, const char[8192], path, POOR_MMAP_READ);
+		assert(!big);
+		unmap_file_array(big);
+		assert(!madvise_array(big, POOR_ADVISE_NORMAL));
+	}
+
+	//missing file
+	assert(!unlink(path));
+	{
+		mmap_file_array(missing, const int, path, POOR_MMAP_READ);
+		assert(!missing);
+	}
+
+	free(data);
+	return 0;
+}
+
+typedef int (test_fn)(void);
+
+#define TEST_FN(fn) {#fn, fn}
+
+struct tests_struct {
+	const char *test_name;
+	test_fn *fn;
+} tests[] = {
+	TEST_FN(mmap_huge_test),
+	TEST_FN(mmap_file_test),
+};
+
+static void usage(void) {
+	fprintf(stderr, "usage: this_program [test_name]\n\n"
+		   "available tests:\n");
+
+	for(struct tests_struct *cur = &tests[0]; cur != &tests[sizeof(tests) / sizeof(tests[0])]; cur++ ){
+		fprintf(stderr, "\t%s\n", cur->test_name);
+	}
+}
+
+int main(int argc, char **argv) {
+	if(argc != 2)
+		return usage(), 1;
+
+	for(struct tests_struct *cur = &tests[0]; cur != &tests[sizeof(tests) / sizeof(tests[0])]; cur++ ){
+		if(!strcmp(argv[1], cur->test_name)) {
+			return cur->fn();
+		}
+	}
+
+	return fprintf(stderr, "No test found with name: \"%s\"\n", argv[1]), 1;
+}
@@ -0,0 +1,187 @@
+#include <poor_numeric.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#undef NDEBUG
+
+static int array_stats_test(void) {
+	const float samples[] = {1.5f, 2.5f, 4.0f, 8.0f};
+	array_stats_f st = array_stats(samples);
+	assert(st.count == 4);
+	assert(st.sum == 16.0);
+	assert(st.min == 1.5 && st.max == 8.0);
+	assert(st.mean == 4.0);
+	assert(st.variance == 6.125);
+
+	//integers, pointer to VLA, length is not multiple of lanes
+	int (*v)[(size_t){101}] = malloc_array(v);
+	assert(v);
+	foreach_array_ref(v, ref)
+		*ref = (int)array_ref_index(v, ref) - 50;
+
+	array_stats_s si = array_stats(v);
+	assert(si.count == 101);
+	assert(si.sum == 0);
+	assert(si.min == -50 && si.max == 50);
+	assert(si.mean == 0.0);
+	assert(fabs(si.variance - 850.0) < 1e-9);
+	free(v);
+
+	//large mean with small spread keeps precision
+	double (*d)[1000] = malloc_array(d);
+	assert(d);
+	foreach_array_ref(d, ref)
+		*ref = 1e9 + (array_ref_index(d, ref) % 2 ? 1.0 : -1.0);
+
+	array_stats_f sd = array_stats(d);
+	assert(sd.mean == 1e9);
+	assert(fabs(sd.variance - 1.0) < 1e-6);
+	free(d);
+
+	//arrview
+	const unsigned short us[] = {7, 3, 9, 1};
+	make_arrview_first(us_first, 3, us);
+	array_stats_u su = array_stats(us_first);
+	assert(su.count == 3 && su.sum == 19 && su.min == 3 && su.max == 9);
+
+	return 0;
+}
+
+static int array_sum_test(void) {
+	//8-bit elements are widened
+	uint8_t bytes[] = {200, 100, 50};
+	assert(array_sum(bytes) == 350);
+
+	//32-bit elements are widened too
+	int32_t (*big)[(size_t){1000}] = malloc_array(big);
+	assert(big);
+	fill_array(big, INT32_MAX);
+	assert(array_sum(big) == 1000LL * INT32_MAX);
+	fill_array(big, INT32_MIN);
+	assert(array_sum(big) == 1000LL * INT32_MIN);
+	free(big);
+
+	//Kahan summation of small values added to a large one
+	float (*f)[10001] = malloc_array(f);
+	assert(f);
+	fill_array(f, 1e-8f);
+	auto_arr(f)[0] = 1.0f;
+	assert(fabs(array_sum(f) - (1.0 + 1e-4)) < 1e-9);
+	free(f);
+
+	return 0;
+}
+
+static int array_minmax_test(void) {
+	const int v[] = {4, -2, 9, 0, 3, 3, 8, -1, 5, 2, 1};
+	array_stats_s mm = array_minmax(v);
+	assert(mm.count == ARRAY_SIZE(v));
+	assert(mm.min == -2 && mm.max == 9);
+
+	unsigned long long single[] = {42};
+	array_stats_u mu = array_minmax(single);
+	assert(mu.min == 42 && mu.max == 42);
+
+	const double dd[] = {-0.5, 1e10, -1e10};
+	array_stats_f md = array_minmax(&dd);
+	assert(md.min == -1e10 && md.max == 1e10);
+
+	return 0;
+}
+
+static int array_elementwise_test(void) {
+	const float a[] = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+	float b[] = {10, 20, 30, 40, 50, 60, 70, 80, 90};
+	float c[ARRAY_SIZE(a)];
+
+	array_add(c, a, b);
+	foreach_array_const_ref(c, ref)
+		assert(*ref == 11.0f * (array_ref_index(c, ref) + 1));
+
+	array_mul(c, a, b);
+	foreach_array_const_ref(c, ref)
+		assert(*ref == 10.0f * (array_ref_index(c, ref) + 1) * (array_ref_index(c, ref) + 1));
+
+	//destination is one of the sources
+	array_add(b, b, a);
+	assert(*array_first_ref(b) == 11.0f && *array_last_ref(b) == 99.0f);
+
+	array_scale(b, 2);
+	assert(*array_first_ref(b) == 22.0f && *array_last_ref(b) == 198.0f);
+
+	//integers, pointers to VLAs
+	int (*y)[(size_t){37}] = malloc_array(y);
+	int (*x)[(size_t){37}] = malloc_array(x);
+	assert(x && y);
+	fill_array(y, 1);
+	foreach_array_ref(x, ref)
+		*ref = (int)array_ref_index(x, ref);
+
+	array_axpy(y, 3, x);
+	foreach_array_const_ref(y, ref)
+		assert(*ref == 3 * (int)array_ref_index(y, ref) + 1);
+
+	free(x);
+	free(y);
+	return 0;
+}
+
+static int array_dot_test(void) {
+	const int a[] = {1, 2, 3}, b[] = {4, 5, 6};
+	assert(array_dot(a, b) == 32);
+
+	//products are widened, exact sum fits into 64 bits
+	const uint32_t u[] = {UINT32_MAX, UINT32_MAX, UINT32_MAX};
+	const uint32_t v[] = {1U << 30, 1U << 30, 1U << 30};
+	assert(array_dot(u, v) == 3 * ((1ULL << 62) - (1ULL << 30)));
+	assert(array_dot(arrview(0, 1, u), arrview(0, 1, u)) == 0xFFFFFFFE00000001ULL);
+
+	//signed products and sums wrap around without overflow
+	const long long big[] = {INT64_MAX, INT64_MAX, -3};
+	assert(array_dot(big, big) == (long long)(2 * (uint64_t)INT64_MAX * (uint64_t)INT64_MAX + 9));
+	const int8_t neg[] = {-128, -128, 127};
+	assert(array_dot(neg, neg) == 128 * 128 * 2 + 127 * 127);
+
+	double d[] = {0.5, 1.5, -2.0, 4.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0};
+	assert(array_dot(d, d) == 0.25 + 2.25 + 4.0 + 16.0 + 7.0);
+
+	return 0;
+}
+
+typedef int test_fn (void);
+
+#define TEST_FN(fn) {#fn, fn}
+static struct tests_struct {
+	const char *test_name;
+	test_fn *fn;
+} tests[] = {
+	TEST_FN(array_stats_test),
+	TEST_FN(array_sum_test),
+	TEST_FN(array_minmax_test),
+	TEST_FN(array_elementwise_test),
+	TEST_FN(array_dot_test),
+};
+
+static void usage(void) {
+	fprintf(stderr, "usage: this_program [test_name]\n\n"
+		   "available tests:\n");
+
+	for(struct tests_struct *cur = &tests[0]; cur != &tests[sizeof(tests) / sizeof(tests[0])]; cur++ ){
+		fprintf(stderr, "\t%s\n", cur->test_name);
+	}
+}
+
+int main(int argc, char **argv) {
+	if(argc != 2)
+		return usage(), 1;
+
+	for(struct tests_struct *cur = &tests[0]; cur != &tests[sizeof(tests) / sizeof(tests[0])]; cur++ ){
+		if(!strcmp(argv[1], cur->test_name)) {
+			return cur->fn();
+		}
+	}
+
+	return fprintf(stderr, "No test found with name: \"%s\"\n", argv[1]), 1;
+}
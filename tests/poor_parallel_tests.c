@@ -0,0 +1,174 @@
+#include <poor_parallel.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#undef NDEBUG
+
+#define BIG_SIZE (1024 * 1024 + 7)
+
+#define add(acc, val) ((acc) + (val))
+#define min(acc, val) ((acc) < (val) ? (acc) : (val))
+#define append_digit(acc, val) ((acc) * 10 + (val))
+#define concat_digits(a, b) ((a) * h_pow10(b) + (b))
+
+static unsigned long long h_pow10(unsigned long long v) {
+	unsigned long long p = 10;
+	while(v /= 10)
+		p *= 10;
+	return p;
+}
+
+static int parallel_fill_test(void) {
+	long (*data)[BIG_SIZE] = malloc_array(data);
+	assert(data);
+
+	parallel_fill_array(data, -5);
+	foreach_array_const_ref(data, ref)
+		assert(*ref == -5);
+
+	//pointer to VLA
+	long (*vla)[(size_t){BIG_SIZE / 3}] = (void*)data;
+	parallel_fill_array(vla, 7);
+	foreach_array_const_ref(vla, ref)
+		assert(*ref == 7);
+	assert(auto_arr(data)[BIG_SIZE / 3] == -5);
+
+	//small array is processed by a single arrview
+	short small[5];
+	parallel_fill_array(small, 3);
+	foreach_array_const_ref(small, ref)
+		assert(*ref == 3);
+
+	free(data);
+	return 0;
+}
+
+static int parallel_memset_test(void) {
+	unsigned char (*data)[BIG_SIZE] = malloc_array(data);
+	assert(data);
+
+	parallel_memset_array(data, 0xae);
+	foreach_array_const_ref(data, ref)
+		assert(*ref == 0xae);
+
+	free(data);
+	return 0;
+}
+
+static int parallel_copy_test(void) {
+	int (*src)[BIG_SIZE] = malloc_array(src);
+	long long (*dst)[BIG_SIZE + 10] = malloc_array(dst);
+	assert(src && dst);
+
+	foreach_array_ref(src, ref)
+		*ref = (int)array_ref_index(src, ref);
+
+	//different types, destination is larger than source
+	fill_array(dst, -1);
+	parallel_copy_array(dst, src);
+	foreach_array_const_ref(src, ref)
+		assert(auto_arr(dst)[array_ref_index(src, ref)] == *ref);
+	assert(*array_last_ref(dst) == -1);
+
+	//same types, destination is smaller than source
+	int (*dst2)[(size_t){BIG_SIZE - 100}] = malloc_array(dst2);
+	assert(dst2);
+	parallel_copy_array(dst2, src);
+	foreach_array_const_ref(dst2, ref)
+		assert(*ref == (int)array_ref_index(dst2, ref));
+
+	free(dst2);
+	free(dst);
+	free(src);
+	return 0;
+}
+
+static int parallel_arrview_test(void) {
+	uint16_t (*data)[BIG_SIZE] = calloc_array(data);
+	bool (*starts)[BIG_SIZE] = calloc_array(starts);
+	assert(data && starts);
+
+	foreach_parallel_arrview(view, data) {
+		auto_arr(starts)[array_ref_index(data, array_first_ref(view))] = true;
+		foreach_array_ref(view, ref)
+			(*ref)++;
+	}
+
+	//every element is visited exactly once
+	foreach_array_const_ref(data, ref)
+		assert(*ref == 1);
+
+	//every arrview except the first one starts at page boundary
+	size_t views = 0;
+	foreach_array_const_ref(starts, ref) {
+		if(!*ref)
+			continue;
+
+		views++;
+		if(!is_first_array_ref(starts, ref)) {
+			const uintptr_t addr = (uintptr_t)&auto_arr(data)[array_ref_index(starts, ref)];
+			assert(addr % POOR_PAGE_SIZE < sizeof(uint16_t));
+		}
+	}
+	assert(views >= 1 && views <= poor_parallel_threads());
+
+	free(starts);
+	free(data);
+	return 0;
+}
+
+static int parallel_reduce_test(void) {
+	uint32_t (*data)[BIG_SIZE] = malloc_array(data);
+	assert(data);
+
+	foreach_array_ref(data, ref)
+		*ref = (uint32_t)array_ref_index(data, ref);
+
+	const uint64_t sum = (uint64_t)BIG_SIZE * (BIG_SIZE - 1) / 2;
+	assert(parallel_array_reduce(data, (uint64_t)0, add, add) == sum);
+	assert(parallel_array_reduce(data, UINT32_MAX, min, min) == 0);
+
+	//small array, order of partial results is preserved
+	const unsigned char digits[] = {1, 2, 3, 4};
+	assert(parallel_array_reduce(digits, 0ULL, append_digit, concat_digits) == 1234);
+
+	free(data);
+	return 0;
+}
+
+typedef int test_fn (void);
+
+#define TEST_FN(fn) {#fn, fn}
+static struct tests_struct {
+	const char *test_name;
+	test_fn *fn;
+} tests[] = {
+	TEST_FN(parallel_fill_test),
+	TEST_FN(parallel_memset_test),
+	TEST_FN(parallel_copy_test),
+	TEST_FN(parallel_arrview_test),
+	TEST_FN(parallel_reduce_test),
+};
+
+static void usage(void) {
+	fprintf(stderr, "usage: this_program [test_name]\n\n"
+		   "available tests:\n");
+
+	for(struct tests_struct *cur = &tests[0]; cur != &tests[sizeof(tests) / sizeof(tests[0])]; cur++ ){
+		fprintf(stderr, "\t%s\n", cur->test_name);
+	}
+}
+
+int main(int argc, char **argv) {
+	if(argc != 2)
+		return usage(), 1;
+
+	for(struct tests_struct *cur = &tests[0]; cur != &tests[sizeof(tests) / sizeof(tests[0])]; cur++ ){
+		if(!strcmp(argv[1], cur->test_name)) {
+			return cur->fn();
+		}
+	}
+
+	return fprintf(stderr, "No test found with name: \"%s\"\n", argv[1]), 1;
+}
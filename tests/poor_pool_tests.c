@@ -0,0 +1,195 @@
+#include <poor_pool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#undef NDEBUG
+
+#define THREADS 4
+#define PER_THREAD 20000
+
+static size_t slabs_count(poor_pool *pool) {
+	size_t cnt = 0;
+	for(struct h_pool_slab *s = atomic_load(&pool->slabs); s; s = s->next)
+		cnt++;
+	return cnt;
+}
+
+static int pool_alloc_test(void) {
+	poor_pool pool;
+	assert(!pool_init(&pool, 16, 3));
+	assert(!pool_init(&pool, 0, 8));
+	assert(!pool_init(&pool, SIZE_MAX / 2, 8));
+
+	//small objects are rounded up to hold free list links
+	assert(pool_init(&pool, 1, 1));
+	assert(pool.obj_size >= sizeof(void*) * 2);
+	pool_destroy(&pool);
+
+	typedef double block[9];
+	block *b;
+	assert(pool_init_array(&pool, b));
+	assert(pool.obj_size == sizeof(block));
+	assert(slabs_count(&pool) == 0);
+
+	//objects are distinct, aligned, and writable
+	block *(*all)[1000] = malloc_array(all);
+	assert(all);
+	foreach_array_ref(all, ref) {
+		assert(pool_alloc_array(&pool, *ref));
+		assert((uintptr_t)*ref % _Alignof(block) == 0);
+		fill_array(*ref, (double)array_ref_index(all, ref));
+	}
+	foreach_array_const_ref(all, ref)
+		foreach_array_const_ref(*ref, val)
+			assert(*val == (double)array_ref_index(all, ref));
+
+	//freed objects are reused
+	void *last = (*all)[999];
+	pool_free(&pool, last);
+	assert(pool_alloc(&pool) == last);
+	const size_t slabs = slabs_count(&pool);
+	foreach_array_const_ref(all, ref)
+		pool_free(&pool, *ref);
+	foreach_array_ref(all, ref)
+		assert(pool_alloc_array(&pool, *ref));
+	assert(slabs_count(&pool) == slabs);
+	pool_free(&pool, NULL);
+
+	pool_destroy(&pool);
+	free(all);
+
+	//calloc and over-aligned objects
+	assert(pool_init(&pool, 100, 64));
+	assert(pool.obj_size == 128);
+	for(int i = 0; i < 300; i++) {
+		unsigned char (*p)[100] = pool_calloc_array(&pool, p);
+		assert(p && (uintptr_t)p % 64 == 0);
+		foreach_array_const_ref(p, ref)
+			assert(*ref == 0);
+		fill_array(p, 0xff);
+		if(i % 2)
+			pool_free(&pool, p);
+	}
+	pool_destroy(&pool);
+
+	return 0;
+}
+
+static int pool_threads_test(void) {
+	poor_pool pool;
+	assert(pool_init(&pool, 64, 8));
+
+	void *(*objs)[THREADS][PER_THREAD] = malloc_array(objs);
+	assert(objs);
+
+	#pragma omp parallel for num_threads(THREADS) schedule(static, 1)
+	for(int t = 0; t < THREADS; t++)
+		for(int i = 0; i < PER_THREAD; i++) {
+			unsigned (*p)[16] = pool_alloc_array(&pool, p);
+			assert(p);
+			fill_array(p, (unsigned)(t * PER_THREAD + i));
+			(*objs)[t][i] = p;
+		}
+	const size_t slabs = slabs_count(&pool);
+
+	//objects are freed by other threads, and return to allocating threads through the pool
+	#pragma omp parallel for num_threads(THREADS) schedule(static, 1)
+	for(int t = 0; t < THREADS; t++) {
+		const int owner = (t + 1) % THREADS;
+		for(int i = 0; i < PER_THREAD; i++) {
+			unsigned (*p)[16] = (*objs)[owner][i];
+			assert((*p)[15] == (unsigned)(owner * PER_THREAD + i));
+			pool_free(&pool, p);
+		}
+		pool_thread_flush(&pool);
+	}
+
+	#pragma omp parallel for num_threads(THREADS) schedule(static, 1)
+	for(int t = 0; t < THREADS; t++) {
+		for(int i = 0; i < PER_THREAD; i++) {
+			(*objs)[t][i] = pool_alloc(&pool);
+			assert((*objs)[t][i]);
+			memset((*objs)[t][i], t, 64);
+		}
+		for(int i = 0; i < PER_THREAD; i++) {
+			const unsigned char *p = (*objs)[t][i];
+			assert(p[0] == t && p[63] == t);
+			pool_free(&pool, (*objs)[t][i]);
+		}
+		pool_thread_flush(&pool);
+	}
+	assert(slabs_count(&pool) <= slabs + THREADS);
+
+	pool_destroy(&pool);
+	free(objs);
+	return 0;
+}
+
+static int pool_many_pools_test(void) {
+	//more pools than thread cache entries, caches are returned to pools on collisions
+	poor_pool pools[POOR_POOL_CACHES * 3];
+	foreach_array_ref(pools, pool)
+		assert(pool_init(pool, 32 + array_ref_index(pools, pool), 8));
+
+	void *(*objs)[ARRAY_SIZE(pools)][500] = malloc_array(objs);
+	assert(objs);
+	for(int round = 0; round < 3; round++) {
+		for(size_t i = 0; i < 500; i++)
+			foreach_array_ref(pools, pool) {
+				const size_t p = array_ref_index(pools, pool);
+				(*objs)[p][i] = pool_alloc(pool);
+				assert((*objs)[p][i]);
+				memset((*objs)[p][i], (int)p, pool->obj_size);
+			}
+		for(size_t i = 0; i < 500; i++)
+			foreach_array_ref(pools, pool) {
+				const size_t p = array_ref_index(pools, pool);
+				const unsigned char *obj = (*objs)[p][i];
+				assert(obj[0] == p && obj[pool->obj_size - 1] == p);
+				pool_free(pool, (*objs)[p][i]);
+			}
+	}
+
+	foreach_array_ref(pools, pool) {
+		assert(slabs_count(pool) <= 2);
+		pool_destroy(pool);
+	}
+	free(objs);
+	return 0;
+}
+
+typedef int (test_fn)(void);
+
+#define TEST_FN(fn) {#fn, fn}
+
+struct tests_struct {
+	const char *test_name;
+	test_fn *fn;
+} tests[] = {
+	TEST_FN(pool_alloc_test),
+	TEST_FN(pool_threads_test),
+	TEST_FN(pool_many_pools_test),
+};
+
+static void usage(void) {
+	fprintf(stderr, "usage: this_program [test_name]\n\n"
+		   "available tests:\n");
+
+	for(struct tests_struct *cur = &tests[0]; cur != &tests[sizeof(tests) / sizeof(tests[0])]; cur++ ){
+		fprintf(stderr, "\t%s\n", cur->test_name);
+	}
+}
+
+int main(int argc, char **argv) {
+	if(argc != 2)
+		return usage(), 1;
+
+	for(struct tests_struct *cur = &tests[0]; cur != &tests[sizeof(tests) / sizeof(tests[0])]; cur++ ){
+		if(!strcmp(argv[1], cur->test_name)) {
+			return cur->fn();
+		}
+	}
+
+	return fprintf(stderr, "No test found with name: \"%s\"\n", argv[1]), 1;
+}
@@ -0,0 +1,267 @@
+#include <poor_roaring.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#undef NDEBUG
+
+/* Values are taken from a few chunks, so containers of all types are created and converted */
+static const uint32_t chunks[] = {0, 1, 7, 65535};
+#define REF_BITS (ARRAY_SIZE(chunks) * 65536)
+
+static uint32_t ref_value(size_t bit) {
+	return chunks[bit / 65536] << 16 | (uint32_t)(bit % 65536);
+}
+
+/* Random value: dense, sparse or in a long run, depending on a chunk */
+static size_t random_bit(void) {
+	const size_t chunk = (size_t)rand() % ARRAY_SIZE(chunks);
+	switch(chunk) {
+	case 0: return (size_t)rand() % 65536;
+	case 1: return 65536 + (size_t)rand() % 3000;
+	case 2: return 2 * 65536 + 1000 + (size_t)rand() % 20000;
+	default: return 3 * 65536 + (size_t)rand() % 65536 / 7 * 7;
+	}
+}
+
+/* Checks bitmap against reference bitset */
+static void roaring_check(const roaring_bitmap *rb, const uint64_t (*ref)[REF_BITS / 64]) {
+	assert(roaring_cardinality(rb) == array_popcount(ref));
+	for(size_t i = 0; i < REF_BITS; i += 13)
+		assert(roaring_contains(rb, ref_value(i)) == array_get_bit(ref, i));
+
+	size_t cnt = 0;
+	foreach_array_set_bit(ref, bit)
+		assert(roaring_contains(rb, ref_value(bit)));
+
+	uint32_t prev = 0;
+	foreach_roaring(rb, val) {
+		assert(!cnt || val > prev);
+		assert(roaring_contains(rb, val));
+		prev = val;
+		cnt++;
+	}
+	assert(cnt == roaring_cardinality(rb));
+
+	for(uint32_t i = 0; i < rb->count; i++) {
+		const roaring_container *c = &rb->c[i];
+		assert(!i || c->key > rb->c[i - 1].key);
+		assert(c->card);
+		if(c->type == ROARING_ARRAY)
+			assert(c->card == c->n && c->card <= ROARING_ARRAY_MAX);
+		if(c->type == ROARING_BITSET)
+			assert(c->card > ROARING_ARRAY_MAX);
+	}
+}
+
+/* Adds a long run, which becomes a run container after roaring_run_optimize() */
+static void add_run(roaring_bitmap *rb, uint64_t (*ref)[REF_BITS / 64]) {
+	const size_t first = 2 * 65536 + 30000 + (size_t)rand() % 1000;
+	for(size_t bit = first; bit < first + 3000; bit++) {
+		assert(roaring_add(rb, ref_value(bit)));
+		array_set_bit(ref, bit);
+	}
+}
+
+static void random_bitmap(roaring_bitmap *rb, uint64_t (*ref)[REF_BITS / 64], int n) {
+	memset(ref, 0, sizeof(*ref));
+	add_run(rb, ref);
+	for(int k = 0; k < n; k++) {
+		const size_t bit = random_bit();
+		assert(roaring_add(rb, ref_value(bit)));
+		array_set_bit(ref, bit);
+	}
+}
+
+static int roaring_add_remove_test(void) {
+	roaring_bitmap rb = {0};
+	assert(!roaring_contains(&rb, 0));
+	assert(roaring_cardinality(&rb) == 0);
+	foreach_roaring(&rb, val)
+		assert(0);
+
+	const uint32_t vals[] = {7, 1 << 20, 7, UINT32_MAX, 0};
+	assert(roaring_add_array(&rb, vals));
+	assert(roaring_cardinality(&rb) == 4);
+	const uint32_t sorted[] = {0, 7, 1 << 20, UINT32_MAX};
+	size_t i = 0;
+	foreach_roaring(&rb, val)
+		assert(val == sorted[i++]);
+	assert(roaring_remove(&rb, 7) && roaring_remove(&rb, 8));
+	assert(!roaring_contains(&rb, 7) && roaring_contains(&rb, 0));
+	roaring_free(&rb);
+	assert(!rb.count && !rb.c);
+
+	uint64_t (*ref)[REF_BITS / 64] = calloc(1, sizeof(*ref));
+	assert(ref);
+	add_run(&rb, ref);
+	assert(roaring_run_optimize(&rb));
+	assert(rb.c[0].type == ROARING_RUN);
+	roaring_check(&rb, ref);
+	for(int round = 0; round < 4; round++) {
+		for(int k = 0; k < 40000; k++) {
+			const size_t bit = random_bit();
+			if(round % 2 == 0 || rand() % 4) {
+				assert(roaring_add(&rb, ref_value(bit)));
+				array_set_bit(ref, bit);
+			} else {
+				assert(roaring_remove(&rb, ref_value(bit)));
+				array_unset_bit(ref, bit);
+			}
+		}
+		roaring_check(&rb, ref);
+
+		/* run containers are converted back when they change */
+		assert(roaring_run_optimize(&rb));
+		roaring_check(&rb, ref);
+	}
+
+	/* remove everything */
+	foreach_array_set_bit(ref, bit)
+		assert(roaring_remove(&rb, ref_value(bit)));
+	assert(rb.count == 0);
+
+	free(ref);
+	roaring_free(&rb);
+	return 0;
+}
+
+static int roaring_and_or_test(void) {
+	uint64_t (*ra)[REF_BITS / 64] = malloc(sizeof(*ra));
+	uint64_t (*rb_)[REF_BITS / 64] = malloc(sizeof(*rb_));
+	uint64_t (*rr)[REF_BITS / 64] = malloc(sizeof(*rr));
+	assert(ra && rb_ && rr);
+
+	const int sizes[] = {10, 500, 5000, 60000};
+	for(size_t i = 0; i < ARRAY_SIZE(sizes); i++)
+		for(size_t j = 0; j < ARRAY_SIZE(sizes); j++) {
+			roaring_bitmap a = {0}, b = {0}, r = {0};
+			random_bitmap(&a, ra, sizes[i]);
+			random_bitmap(&b, rb_, sizes[j]);
+			if(j % 2)
+				assert(roaring_run_optimize(&b));
+
+			assert(roaring_and(&r, &a, &b));
+			array_bits_and(rr, ra, rb_);
+			roaring_check(&r, rr);
+
+			assert(roaring_or(&r, &a, &b));
+			array_bits_or(rr, ra, rb_);
+			roaring_check(&r, rr);
+
+			/* destination is one of operands */
+			assert(roaring_and(&a, &a, &b));
+			array_bits_and(ra, ra, rb_);
+			roaring_check(&a, ra);
+
+			roaring_free(&a);
+			roaring_free(&b);
+			roaring_free(&r);
+		}
+
+	/* galloping intersection of a small array with a large one */
+	roaring_bitmap a = {0}, b = {0}, r = {0};
+	for(uint32_t v = 0; v < 4000; v++)
+		assert(roaring_add(&b, v * 3));
+	assert(roaring_add(&a, 3) && roaring_add(&a, 3000) && roaring_add(&a, 3001) && roaring_add(&a, 11997));
+	assert(roaring_and(&r, &a, &b));
+	assert(roaring_cardinality(&r) == 3);
+	assert(roaring_contains(&r, 3) && roaring_contains(&r, 3000) && roaring_contains(&r, 11997));
+
+	roaring_free(&a);
+	roaring_free(&b);
+	roaring_free(&r);
+	free(rr);
+	free(rb_);
+	free(ra);
+	return 0;
+}
+
+static int roaring_serialize_test(void) {
+	/* byte layouts of the portable format */
+	roaring_bitmap rb = {0};
+	for(uint32_t v = 1; v <= 3; v++)
+		assert(roaring_add(&rb, v));
+	unsigned char buf[32];
+	const unsigned char no_runs[] = {0x3a, 0x30, 0, 0, 1, 0, 0, 0, 0, 0, 2, 0, 16, 0, 0, 0, 1, 0, 2, 0, 3, 0};
+	assert(roaring_serialized_size(&rb) == sizeof(no_runs));
+	assert(roaring_serialize(&rb, buf) == sizeof(no_runs));
+	assert(!memcmp(buf, no_runs, sizeof(no_runs)));
+
+	for(uint32_t v = 4; v <= 100; v++)
+		assert(roaring_add(&rb, v));
+	assert(roaring_run_optimize(&rb));
+	assert(rb.c[0].type == ROARING_RUN);
+	const unsigned char runs[] = {0x3b, 0x30, 0, 0, 1, 0, 0, 99, 0, 1, 0, 1, 0, 99, 0};
+	assert(roaring_serialized_size(&rb) == sizeof(runs));
+	assert(roaring_serialize(&rb, buf) == sizeof(runs));
+	assert(!memcmp(buf, runs, sizeof(runs)));
+	roaring_free(&rb);
+
+	/* round trip of random bitmaps */
+	uint64_t (*ref)[REF_BITS / 64] = malloc(sizeof(*ref));
+	assert(ref);
+	for(int k = 0; k < 4; k++) {
+		random_bitmap(&rb, ref, 30000);
+		if(k % 2)
+			assert(roaring_run_optimize(&rb));
+
+		const size_t size = roaring_serialized_size(&rb);
+		unsigned char *data = malloc(size);
+		assert(data);
+		assert(roaring_serialize(&rb, data) == size);
+
+		roaring_bitmap copy = {0};
+		assert(roaring_deserialize(&copy, data, size));
+		roaring_check(&copy, ref);
+
+		/* truncated and corrupted data is rejected, and bitmap is not changed */
+		assert(!roaring_deserialize(&copy, data, size - 1));
+		assert(!roaring_deserialize(&copy, data, 3));
+		data[0] ^= 0xff;
+		assert(!roaring_deserialize(&copy, data, size));
+		roaring_check(&copy, ref);
+
+		free(data);
+		roaring_free(&copy);
+		roaring_free(&rb);
+	}
+
+	free(ref);
+	return 0;
+}
+
+typedef int test_fn (void);
+
+#define TEST_FN(fn) {#fn, fn}
+static struct tests_struct {
+	const char *test_name;
+	test_fn *fn;
+} tests[] = {
+	TEST_FN(roaring_add_remove_test),
+	TEST_FN(roaring_and_or_test),
+	TEST_FN(roaring_serialize_test),
+};
+
+static void usage(void) {
+	fprintf(stderr, "usage: this_program [test_name]\n\n"
+		   "available tests:\n");
+
+	for(struct tests_struct *cur = &tests[0]; cur != &tests[sizeof(tests) / sizeof(tests[0])]; cur++ ){
+		fprintf(stderr, "\t%s\n", cur->test_name);
+	}
+}
+
+int main(int argc, char **argv) {
+	if(argc != 2)
+		return usage(), 1;
+
+	for(struct tests_struct *cur = &tests[0]; cur != &tests[sizeof(tests) / sizeof(tests[0])]; cur++ ){
+		if(!strcmp(argv[1], cur->test_name)) {
+			return cur->fn();
+		}
+	}
+
+	return fprintf(stderr, "No test found with name: \"%s\"\n", argv[1]), 1;
+}
@@ -0,0 +1,260 @@
+#include <poor_search.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#undef NDEBUG
+
+struct rec { uint32_t id; float val; };
+#define rec_id_less(r, key) ((r).id < (key))
+#define id_rec_less(key, r) ((key) < (r).id)
+
+static int array_bound_test(void) {
+	//constant size array
+	const int a[] = {1, 3, 3, 5};
+	assert(array_ref_index(a, array_lower_bound(a, 3)) == 1);
+	assert(array_ref_index(a, array_upper_bound(a, 3)) == 3);
+	assert(array_lower_bound(a, 0) == array_first_ref(a));
+	assert(array_lower_bound(a, 6) == array_end_ref(a));
+	assert(array_upper_bound(&a, 5) == array_end_ref(a));
+
+	//pointers to VLA of all small sizes with duplicates, compared with linear search
+	for(size_t n = 1; n < 70; n++) {
+		unsigned (*v)[n] = malloc_array(v);
+		assert(v);
+		foreach_array_ref(v, ref)
+			*ref = (unsigned)array_ref_index(v, ref) / 3 * 2;
+
+		for(unsigned key = 0; key < n + 2; key++) {
+			size_t lb = 0, ub = 0;
+			while(lb < n && (*v)[lb] < key)
+				lb++;
+			while(ub < n && (*v)[ub] <= key)
+				ub++;
+			assert(array_ref_index(v, array_lower_bound(v, key)) == (ptrdiff_t)lb);
+			assert(array_ref_index(v, array_upper_bound(v, key)) == (ptrdiff_t)ub);
+		}
+		free(v);
+	}
+
+	//array of structs with custom comparison
+	struct rec recs[] = {{1, 0.5f}, {4, 1.5f}, {4, 2.0f}, {9, 2.5f}};
+	assert(array_lower_bound_by(recs, 4, rec_id_less)->val == 1.5f);
+	assert(array_upper_bound_by(recs, 4, id_rec_less)->val == 2.5f);
+	assert(array_lower_bound_by(recs, 10, rec_id_less) == array_end_ref(recs));
+
+	//array view
+	make_arrview_last(tail, 2, a);
+	assert(array_lower_bound(tail, 4) == &a[3]);
+
+	return 0;
+}
+
+static int eytzinger_test(void) {
+	const int sorted[] = {1, 3, 3, 5, 8, 13, 21};
+	int eyt[7];
+	make_eytzinger_array(eyt, sorted);
+	assert(!memcmp(eyt, (int[]){5, 3, 13, 1, 3, 8, 21}, sizeof(eyt)));
+	assert(*eytzinger_search(eyt, 4) == 5);
+	assert(*eytzinger_search(eyt, 14) == 21);
+	assert(eytzinger_search(eyt, 22) == array_end_ref(eyt));
+	assert(array_ref_index(eyt, eytzinger_search(eyt, 0)) == 3);
+
+	//all sizes, search result is the same element as lower bound of the sorted array
+	for(size_t n = 1; n < 300; n++) {
+		long (*src)[n] = malloc_array(src);
+		long (*dst)[n] = malloc_array(dst);
+		assert(src && dst);
+		foreach_array_ref(src, ref)
+			*ref = (long)array_ref_index(src, ref) * 2;
+		make_eytzinger_array(dst, src);
+
+		for(long key = -1; key <= (long)n * 2; key++) {
+			const long *lb = array_lower_bound(src, key);
+			const long *ref = eytzinger_search(dst, key);
+			if(lb == array_end_ref(src))
+				assert(ref == array_end_ref(dst));
+			else
+				assert(ref != array_end_ref(dst) && *ref == *lb);
+		}
+		free(dst);
+		free(src);
+	}
+
+	//array of structs
+	struct rec recs[] = {{1, 0.5f}, {4, 1.5f}, {9, 2.5f}};
+	struct rec (*eyt_recs)[3] = malloc_array(eyt_recs);
+	assert(eyt_recs);
+	make_eytzinger_array(eyt_recs, recs);
+	assert(eytzinger_search_by(eyt_recs, 2, rec_id_less)->id == 4);
+	free(eyt_recs);
+
+	return 0;
+}
+
+/* Places _value_ at every position of arrays of sizes from 1 to 200, checks that it's found there */
+#define check_find(_type_, _value_) do {						\
+	for(size_t _n_ = 1; _n_ <= 200; _n_++) {					\
+		_type_ (*_arr_)[_n_] = calloc(_n_, sizeof(_type_));			\
+		assert(_arr_);								\
+		assert(array_find(_arr_, _value_) == array_end_ref(_arr_));		\
+		assert(!array_contains(_arr_, _value_));				\
+		assert(array_count(_arr_, 0) == _n_);					\
+		foreach_array_ref(_arr_, _ref_) {					\
+			*_ref_ = (_value_);						\
+			assert(array_find(_arr_, _value_) == _ref_);			\
+			assert(array_contains(_arr_, _value_));				\
+			assert(array_count(_arr_, _value_) == 1);			\
+			*_ref_ = 0;							\
+		}									\
+		foreach_array_ref(_arr_, _ref_)						\
+			if(array_ref_index(_arr_, _ref_) % 3 == 1)			\
+				*_ref_ = (_value_);					\
+		assert(array_count(_arr_, _value_) == (_n_ + 1) / 3);			\
+		assert(array_count(_arr_, 0) == _n_ - (_n_ + 1) / 3);			\
+		free(_arr_);								\
+	}										\
+} while(0)
+
+static int array_find_test(void) {
+	const uint32_t ids[] = {7, 3, 9, 3};
+	assert(array_ref_index(ids, array_find(ids, 3)) == 1);
+	assert(array_find(ids, 4) == array_end_ref(ids));
+	assert(array_count(ids, 3) == 2);
+	assert(array_contains(&ids, 9));
+
+	check_find(char, 'x');
+	check_find(int8_t, -1);
+	check_find(uint8_t, 255);
+	check_find(int16_t, -300);
+	check_find(uint32_t, 0xdeadbeef);
+	check_find(int64_t, -5000000000);
+	check_find(unsigned long long, 1ULL << 63);
+	check_find(float, -0.5f);
+	check_find(double, 1e300);
+	check_find(long double, 2.5L);
+
+	//more elements than fit in 8 bit vector counters
+	uint8_t (*bytes)[(size_t){100000}] = malloc_array(bytes);
+	assert(bytes);
+	memset_array(bytes, 7);
+	assert(array_count(bytes, 7) == 100000);
+	free(bytes);
+
+	//value is converted to element type
+	const unsigned char c[] = {1, 255};
+	assert(array_find(c, -1) == &c[1]);
+
+	//array view
+	make_arrview_last(tail, 2, ids);
+	assert(array_find(tail, 3) == &ids[3]);
+
+	return 0;
+}
+
+static int array_find_if_test(void) {
+	struct rec recs[] = {{1, 0.5f}, {4, -1.5f}, {9, -2.5f}};
+#define negative_val(r) ((r).val < 0)
+#define zero_id(r) ((r).id == 0)
+	assert(array_find_if(recs, negative_val) == &recs[1]);
+	assert(array_find_if(recs, zero_id) == array_end_ref(recs));
+#undef negative_val
+#undef zero_id
+	return 0;
+}
+
+static int array_find_subarray_test(void) {
+	//strings without terminating null
+	make_arrview_str(text, "find a needle in a haystack");
+	make_arrview_str(word, "needle");
+	char (*match)[ARRAY_SIZE(word)] = array_find_subarray(text, word);
+	assert(match && array_ref_index(text, array_first_ref(match)) == 7);
+	assert(!memcmp(match, "needle", ARRAY_SIZE(word)));
+
+	make_arrview_str(missing, "needles");
+	assert(!array_find_subarray(text, missing));
+	assert(!array_find_subarray(word, text));
+
+	//match is at element boundary only
+	const uint16_t samples[] = {1, 2, 3, 2, 3, 4};
+	const uint16_t pattern[] = {2, 3, 4};
+	const uint16_t (*m)[3] = array_find_subarray(samples, pattern);
+	assert(m == (void *)&samples[3]);
+
+	//bytes of the pattern are present in haystack, but across elements
+	uint16_t halves[2], across[1];
+	memcpy(halves, (unsigned char[]){0, 1, 2, 0}, sizeof(halves));
+	memcpy(across, (unsigned char[]){1, 2}, sizeof(across));
+	assert(!array_find_subarray(halves, across));
+
+	//periodic and adversarial needles on large haystack
+	const size_t n = 100000;
+	char (*hay)[n] = malloc_array(hay);
+	assert(hay);
+	memset_array(hay, 'a');
+	char needle[1001];
+	memset_array(needle, 'a');
+	needle[500] = 'b';
+	assert(!array_find_subarray(hay, needle));
+	(*hay)[n - 600] = 'b';
+	char (*found)[1001] = array_find_subarray(hay, needle);
+	assert(found && array_ref_index(hay, array_first_ref(found)) == (ptrdiff_t)(n - 1100));
+	free(hay);
+
+	//random haystacks on small alphabet, compared with naive search
+	srand(1);
+	for(unsigned rep = 0; rep < 20000; rep++) {
+		uint32_t h[1 + rand() % 200], nd[1 + rand() % 8];
+		foreach_array_ref(h, ref)
+			*ref = (uint32_t)rand() % 2 * 0x01010101u;
+		foreach_array_ref(nd, ref)
+			*ref = (uint32_t)rand() % 2 * 0x01010101u;
+
+		ptrdiff_t expected = -1;
+		for(size_t i = 0; i + ARRAY_SIZE(nd) <= ARRAY_SIZE(h) && expected < 0; i++)
+			if(!memcmp(&h[i], nd, sizeof(nd)))
+				expected = (ptrdiff_t)i;
+
+		uint32_t (*res)[ARRAY_SIZE(nd)] = array_find_subarray(h, nd);
+		assert(res ? array_ref_index(h, array_first_ref(res)) == expected : expected == -1);
+	}
+
+	return 0;
+}
+
+typedef int test_fn (void);
+
+#define TEST_FN(fn) {#fn, fn}
+static struct tests_struct {
+	const char *test_name;
+	test_fn *fn;
+} tests[] = {
+	TEST_FN(array_bound_test),
+	TEST_FN(eytzinger_test),
+	TEST_FN(array_find_test),
+	TEST_FN(array_find_if_test),
+	TEST_FN(array_find_subarray_test),
+};
+
+static void usage(void) {
+	fprintf(stderr, "usage: this_program [test_name]\n\n"
+		   "available tests:\n");
+
+	for(struct tests_struct *cur = &tests[0]; cur != &tests[sizeof(tests) / sizeof(tests[0])]; cur++ ){
+		fprintf(stderr, "\t%s\n", cur->test_name);
+	}
+}
+
+int main(int argc, char **argv) {
+	if(argc != 2)
+		return usage(), 1;
+
+	for(struct tests_struct *cur = &tests[0]; cur != &tests[sizeof(tests) / sizeof(tests[0])]; cur++ ){
+		if(!strcmp(argv[1], cur->test_name)) {
+			return cur->fn();
+		}
+	}
+
+	return fprintf(stderr, "No test found with name: \"%s\"\n", argv[1]), 1;
+}
@@ -0,0 +1,298 @@
+#include <poor_sort.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#undef NDEBUG
+
+#define greater(a, b) ((a) > (b))
+/* Evaluates arguments more than once */
+#define abs_less(a, b) (((a) < 0 ? -(a) : (a)) < ((b) < 0 ? -(b) : (b)))
+
+struct item { int key; int seq; };
+#define item_less(a, b) ((a).key < (b).key)
+
+static int int_cmp(const void *a, const void *b) {
+	const int x = *(const int *)a, y = *(const int *)b;
+	return (x > y) - (x < y);
+}
+
+/* Fills array with one of input patterns, which are known to be troublesome for quicksort */
+static void fill_pattern(size_t n, int (*arr)[n], unsigned pattern) {
+	srand(n * 31 + pattern);
+	foreach_array_ref(arr, ref) {
+		const int i = (int)array_ref_index(arr, ref);
+		switch(pattern) {
+		case 0: *ref = rand(); break; //random
+		case 1: *ref = i; break; //sorted
+		case 2: *ref = (int)n - i; break; //reverse
+		case 3: *ref = 7; break; //all equal
+		case 4: *ref = rand() % 4; break; //few unique
+		case 5: *ref = i < (int)n / 2 ? i : (int)n - i; break; //organ pipe
+		case 6: *ref = i % 2 ? i : -i; break; //alternating
+		default: *ref = (size_t)i + 1 == n ? 0 : i; break; //sorted, but last is the smallest
+		}
+	}
+}
+
+static int sort_array_test(void) {
+	//constant size array
+	int a[] = {5, 2, 9, 1, 5, 6};
+	sort_array(a);
+	assert(!memcmp(a, (int[]){1, 2, 5, 5, 6, 9}, sizeof(a)));
+
+	//single element array
+	double one[] = {1.5};
+	sort_array(&one);
+	assert(one[0] == 1.5);
+
+	//pointer to VLA of different sizes and patterns, compared with qsort()
+	const size_t sizes[] = {2, 3, 23, 24, 25, 100, 129, 1000, 4099, 30000};
+	foreach_array_ref(sizes, size) {
+		for(unsigned pattern = 0; pattern < 8; pattern++) {
+			int (*v)[*size] = malloc_array(v);
+			int (*expected)[*size] = malloc_array(expected);
+			assert(v && expected);
+
+			fill_pattern(*size, v, pattern);
+			copy_array(expected, v);
+			qsort(expected, *size, sizeof((*expected)[0]), int_cmp);
+
+			sort_array(v);
+			assert(!memcmp(v, expected, sizeof(*v)));
+
+			free(expected);
+			free(v);
+		}
+	}
+
+	//array view
+	uint8_t b[] = {9, 8, 7, 6, 5, 4, 3, 2, 1};
+	make_arrview(mid, 2, 4, b);
+	sort_array(mid);
+	assert(!memcmp(b, (uint8_t[]){9, 8, 4, 5, 6, 7, 3, 2, 1}, sizeof(b)));
+
+	return 0;
+}
+
+static int sort_array_by_test(void) {
+	//descending order
+	long v[] = {1, 3, 2, 3};
+	sort_array_by(v, greater);
+	assert(!memcmp(v, (long[]){3, 3, 2, 1}, sizeof(v)));
+
+	//macro which evaluates arguments twice
+	int (*w)[(size_t){1000}] = malloc_array(w);
+	assert(w);
+	foreach_array_ref(w, ref)
+		*ref = (int)array_ref_index(w, ref) * (array_ref_index(w, ref) % 2 ? 1 : -1);
+	sort_array_by(w, abs_less);
+	foreach_array_ref(w, ref)
+		assert(abs(*ref) == (int)array_ref_index(w, ref));
+	free(w);
+
+	//array of structs with many equal keys
+	struct item (*items)[(size_t){5000}] = malloc_array(items);
+	assert(items);
+	foreach_array_ref(items, ref)
+		*ref = (struct item){ .key = (int)(array_ref_index(items, ref) * 7919 % 13), .seq = (int)array_ref_index(items, ref) };
+	sort_array_by(items, item_less);
+
+	int seq_sum = 0;
+	foreach_array_ref(items, ref) {
+		if(ref != array_first_ref(items))
+			assert(ref[-1].key <= ref->key);
+		seq_sum += ref->seq;
+	}
+	assert(seq_sum == 5000 * 4999 / 2);
+	free(items);
+
+	return 0;
+}
+
+/* Sorts constant size arrays of _n_ elements, compares result with qsort() */
+#define check_network(_n_) do {						\
+	for(unsigned _rep_ = 0; _rep_ < 200; _rep_++) {			\
+		int _arr_[_n_], _exp_[_n_];				\
+		foreach_array_ref(_arr_, _ref_)				\
+			*_ref_ = rand() % (_rep_ % 2 ? 4 : 1000) - 500;	\
+		copy_array(_exp_, _arr_);				\
+		qsort(_exp_, _n_, sizeof(int), int_cmp);		\
+		sort_array(_arr_);					\
+		assert(!memcmp(_arr_, _exp_, sizeof(_arr_)));		\
+	}								\
+} while(0)
+
+static int sort_network_test(void) {
+	srand(1);
+	check_network(1); check_network(2); check_network(3); check_network(4);
+	check_network(5); check_network(6); check_network(7); check_network(8);
+	check_network(9); check_network(10); check_network(11); check_network(12);
+	check_network(13); check_network(14); check_network(15); check_network(16);
+	check_network(17); check_network(18); check_network(19); check_network(20);
+	check_network(21); check_network(22); check_network(23); check_network(24);
+	check_network(25); check_network(26); check_network(27); check_network(28);
+	check_network(29); check_network(30); check_network(31); check_network(32);
+
+	//every input of zeroes and ones is sorted by the network
+	for(unsigned mask = 0; mask < 1u << 16; mask++) {
+		unsigned char bits[16];
+		foreach_array_ref(bits, ref)
+			*ref = mask >> array_ref_index(bits, ref) & 1;
+		sort_array(bits);
+		foreach_array_ref(bits, ref)
+			assert(*ref == (array_ref_index(bits, ref) >= 16 - (size_t)__builtin_popcount(mask)));
+	}
+
+	//array of structs with custom comparison
+	struct item items[5] = {{3, 0}, {1, 1}, {4, 2}, {1, 3}, {2, 4}};
+	sort_array_by(items, item_less);
+	const int keys[] = {1, 1, 2, 3, 4};
+	foreach_array_ref(items, ref)
+		assert(ref->key == keys[array_ref_index(items, ref)]);
+
+	//pointer to constant size array
+	double (*d)[3] = &(double[3]){3.5, -1.0, 2.25};
+	sort_array_by(d, greater);
+	assert(!memcmp(d, (double[]){3.5, 2.25, -1.0}, sizeof(*d)));
+
+	return 0;
+}
+
+static int parallel_sort_test(void) {
+	//small arrays are sorted on the calling thread
+	short s[] = {3, -1, 2};
+	parallel_sort_array(s);
+	assert(!memcmp(s, (short[]){-1, 2, 3}, sizeof(s)));
+
+	const size_t n = 1024 * 1024 + 7;
+	for(unsigned pattern = 0; pattern < 8; pattern++) {
+		int (*v)[n] = malloc_array(v);
+		int (*expected)[n] = malloc_array(expected);
+		assert(v && expected);
+
+		fill_pattern(n, v, pattern);
+		copy_array(expected, v);
+		qsort(expected, n, sizeof((*expected)[0]), int_cmp);
+
+		if(pattern % 2) {
+			parallel_sort_array(v);
+		} else {
+			sort_array_by(expected, greater);
+			parallel_sort_array_by(v, greater);
+		}
+		assert(!memcmp(v, expected, sizeof(*v)));
+
+		free(expected);
+		free(v);
+	}
+
+	return 0;
+}
+
+#define check_sorted(_arrm_) \
+	foreach_array_ref(_arrm_, _ref_) \
+		if(_ref_ != array_first_ref(_arrm_)) \
+			assert(!(_ref_[0] < _ref_[-1]))
+
+static int radix_sort_test(void) {
+	//small constant size array is sorted by comparisons
+	int8_t a[] = {5, -2, 9, -128, 127, 0};
+	radix_sort_array(a);
+	assert(!memcmp(a, (int8_t[]){-128, -2, 0, 5, 9, 127}, sizeof(a)));
+
+	//signed integers with all bytes used, compared with qsort()
+	const size_t n = 100003;
+	int (*v)[n] = malloc_array(v);
+	int (*expected)[n] = malloc_array(expected);
+	assert(v && expected);
+	for(unsigned pattern = 0; pattern < 8; pattern++) {
+		fill_pattern(n, v, pattern);
+		foreach_array_ref(v, ref)
+			*ref = (int)((unsigned)*ref * 2654435761u);
+		copy_array(expected, v);
+		qsort(expected, n, sizeof((*expected)[0]), int_cmp);
+
+		radix_sort_array(v);
+		assert(!memcmp(v, expected, sizeof(*v)));
+	}
+	free(expected);
+	free(v);
+
+	//64 bit timestamps within a small range: most of byte passes are skipped
+	uint64_t (*ts)[(size_t){5000}] = malloc_array(ts);
+	assert(ts);
+	foreach_array_ref(ts, ref)
+		*ref = 1700000000000ULL + (array_ref_index(ts, ref) * 7919) % 5000;
+	radix_sort_array(ts);
+	foreach_array_ref(ts, ref)
+		assert(*ref == 1700000000000ULL + array_ref_index(ts, ref));
+	free(ts);
+
+	//16 bit integers
+	short (*s)[(size_t){1000}] = malloc_array(s);
+	assert(s);
+	foreach_array_ref(s, ref)
+		*ref = (short)((array_ref_index(s, ref) * 40503u) ^ 0x8000);
+	radix_sort_array(s);
+	check_sorted(s);
+	free(s);
+
+	//floating point numbers of both signs
+	double (*d)[(size_t){2000}] = malloc_array(d);
+	float (*f)[(size_t){2000}] = malloc_array(f);
+	assert(d && f);
+	foreach_array_ref(d, ref) {
+		const size_t i = array_ref_index(d, ref);
+		*ref = ((double)(i * 7919 % 2000) - 1000.0) / 8.0;
+		(*f)[i] = (float)-*ref;
+	}
+	radix_sort_array(d);
+	radix_sort_array(f);
+	foreach_array_ref(d, ref) {
+		const size_t i = array_ref_index(d, ref);
+		assert(*ref == ((double)i - 1000.0) / 8.0);
+		assert((*f)[i] == (float)(((double)i - 999.0) / 8.0));
+	}
+	free(f);
+	free(d);
+
+	return 0;
+}
+
+typedef int test_fn (void);
+
+#define TEST_FN(fn) {#fn, fn}
+static struct tests_struct {
+	const char *test_name;
+	test_fn *fn;
+} tests[] = {
+	TEST_FN(sort_array_test),
+	TEST_FN(sort_array_by_test),
+	TEST_FN(sort_network_test),
+	TEST_FN(parallel_sort_test),
+	TEST_FN(radix_sort_test),
+};
+
+static void usage(void) {
+	fprintf(stderr, "usage: this_program [test_name]\n\n"
+		   "available tests:\n");
+
+	for(struct tests_struct *cur = &tests[0]; cur != &tests[sizeof(tests) / sizeof(tests[0])]; cur++ ){
+		fprintf(stderr, "\t%s\n", cur->test_name);
+	}
+}
+
+int main(int argc, char **argv) {
+	if(argc != 2)
+		return usage(), 1;
+
+	for(struct tests_struct *cur = &tests[0]; cur != &tests[sizeof(tests) / sizeof(tests[0])]; cur++ ){
+		if(!strcmp(argv[1], cur->test_name)) {
+			return cur->fn();
+		}
+	}
+
+	return fprintf(stderr, "No test found with name: \"%s\"\n", argv[1]), 1;
+}
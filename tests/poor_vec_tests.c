@@ -0,0 +1,192 @@
+#include <poor_vec.h>
+#include <poor_algo.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#undef NDEBUG
+
+#define add(acc, val) ((acc) + (val))
+
+struct point {
+	int x, y;
+};
+
+typedef vec_t(struct point) point_vec;
+
+static bool add_point(point_vec *pv, int x, int y) {
+	return vec_push(*pv, (struct point){x, y});
+}
+
+static int vec_push_pop_test(void) {
+	make_vec(v, int);
+	assert(!v.data && !v.len && !v.cap);
+
+	for(int i = 0; i < 1000; i++)
+		assert(vec_push(v, i * 3));
+	assert(v.len == 1000 && v.cap >= 1000 && v.cap < 2000);
+	for(int i = 0; i < 1000; i++)
+		assert(v.data[i] == i * 3);
+
+	//value referring to an element of the same vector, while vector grows
+	vec_shrink_to_fit(v);
+	assert(v.cap == 1000);
+	assert(vec_push(v, v.data[10]));
+	assert(v.data[1000] == 30);
+
+	assert(vec_pop(v) == 30);
+	assert(vec_pop(v) == 2997);
+	assert(v.len == 999);
+
+	vec_clear(v);
+	assert(v.len == 0 && v.cap >= 1000);
+	vec_free(v);
+	assert(!v.data && !v.len && !v.cap);
+
+	//struct elements, vector accessed by a pointer
+	point_vec pv = {0};
+	assert(add_point(&pv, 1, 2));
+	assert(add_point(&pv, 3, 4));
+	assert(pv.len == 2 && pv.data[1].x == 3 && pv.data[1].y == 4);
+	const struct point last = vec_pop(pv);
+	assert(last.x == 3 && pv.len == 1);
+	vec_free(pv);
+
+	return 0;
+}
+
+static int vec_insert_erase_test(void) {
+	make_vec(v, long);
+	assert(vec_append_array(v, (long[]){0, 1, 2, 3, 4}));
+
+	//unlike array_insert(), no element is lost
+	assert(vec_insert(v, 2, 9));
+	assert(array_equal(vec_arrview(v), (long[]){0, 1, 9, 2, 3, 4}));
+	assert(vec_insert(v, 0, -1));
+	assert(vec_insert(v, v.len, 10));
+	assert(array_equal(vec_arrview(v), (long[]){-1, 0, 1, 9, 2, 3, 4, 10}));
+
+	//insert array with another element type
+	const short src[] = {7, 8};
+	assert(vec_insert_array(v, 3, src));
+	assert(array_equal(vec_arrview(v), (long[]){-1, 0, 1, 7, 8, 9, 2, 3, 4, 10}));
+
+	vec_erase(v, 0);
+	vec_erase(v, v.len - 1);
+	assert(array_equal(vec_arrview(v), (long[]){0, 1, 7, 8, 9, 2, 3, 4}));
+	vec_erase_range(v, 2, 5);
+	assert(array_equal(vec_arrview(v), (long[]){0, 1, 2, 3, 4}));
+	vec_erase_range(v, 1, 1);
+	assert(v.len == 5);
+
+	//inserting a lot of elements at once grows by more than twice
+	make_vec(big, long);
+	long (*many)[5000] = malloc_array(many);
+	assert(many);
+	foreach_array_ref(many, ref)
+		*ref = array_ref_index(many, ref);
+	assert(vec_append_array(big, many));
+	assert(vec_insert_array(big, 1, many));
+	assert(big.len == 10000 && big.data[1] == 0 && big.data[5000] == 4999 && big.data[5001] == 1);
+
+	free(many);
+	vec_free(big);
+	vec_free(v);
+	return 0;
+}
+
+static int vec_reserve_test(void) {
+	make_vec(v, unsigned char);
+	assert(vec_reserve(v, 100));
+	assert(v.cap == 100 && v.len == 0);
+	unsigned char *const data = v.data;
+	for(int i = 0; i < 100; i++)
+		assert(vec_push(v, (unsigned char)i));
+	assert(v.data == data);
+
+	//reserve never shrinks
+	assert(vec_reserve(v, 10));
+	assert(v.cap == 100);
+
+	assert(vec_resize(v, 150, 0xaa));
+	assert(v.len == 150 && v.data[99] == 99 && v.data[100] == 0xaa && v.data[149] == 0xaa);
+	assert(vec_resize(v, 20, 0));
+	assert(v.len == 20 && v.data[19] == 19);
+
+	assert(vec_shrink_to_fit(v));
+	assert(v.cap == 20);
+
+	vec_clear(v);
+	assert(vec_shrink_to_fit(v));
+	assert(!v.data && !v.cap);
+
+	//allocation failure leaves vector unchanged
+	make_vec(w, long);
+	assert(vec_push(w, 1));
+	const size_t cap = w.cap;
+	assert(!vec_reserve(w, SIZE_MAX / 4));
+	assert(w.cap == cap && w.len == 1 && w.data[0] == 1);
+
+	vec_free(w);
+	vec_free(v);
+	return 0;
+}
+
+static int vec_arrview_test(void) {
+	make_vec(v, int);
+	assert(vec_append_array(v, (int[]){5, 6, 7}));
+
+	assert(ARRAY_SIZE(vec_arrview(v)) == 3);
+	make_vec_arrview(view, v);
+	foreach_array_ref(view, ref)
+		*ref *= 2;
+	assert(array_equal(view, (int[]){10, 12, 14}));
+	assert(array_reduce(vec_arrview(v), 0, add) == 36);
+
+	//vector expression is evaluated once
+	typeof(v) vs[2] = {{0}, v};
+	size_t i = 0;
+	assert(ARRAY_SIZE(vec_arrview(vs[++i])) == 3 && i == 1);
+	make_vec_arrview(view2, vs[i++]);
+	assert(ARRAY_SIZE(view2) == 3 && i == 2);
+	assert((*view2)[2] == 14);
+
+	vec_free(v);
+	return 0;
+}
+
+typedef int (test_fn)(void);
+
+#define TEST_FN(fn) {#fn, fn}
+
+struct tests_struct {
+	const char *test_name;
+	test_fn *fn;
+} tests[] = {
+	TEST_FN(vec_push_pop_test),
+	TEST_FN(vec_insert_erase_test),
+	TEST_FN(vec_reserve_test),
+	TEST_FN(vec_arrview_test),
+};
+
+static void usage(void) {
+	fprintf(stderr, "usage: this_program [test_name]\n\n"
+		   "available tests:\n");
+
+	for(struct tests_struct *cur = &tests[0]; cur != &tests[sizeof(tests) / sizeof(tests[0])]; cur++ ){
+		fprintf(stderr, "\t%s\n", cur->test_name);
+	}
+}
+
+int main(int argc, char **argv) {
+	if(argc != 2)
+		return usage(), 1;
+
+	for(struct tests_struct *cur = &tests[0]; cur != &tests[sizeof(tests) / sizeof(tests[0])]; cur++ ){
+		if(!strcmp(argv[1], cur->test_name)) {
+			return cur->fn();
+		}
+	}
+
+	return fprintf(stderr, "No test found with name: \"%s\"\n", argv[1]), 1;
+}